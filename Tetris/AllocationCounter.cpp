@@ -0,0 +1,94 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+#ifndef TETRIS_NO_ALLOCATION_COUNTING
+
+// (plain integers, so they need no construction on a thread's first allocation)
+static thread_local std::uint64_t threadAllocations{ 0 };
+static thread_local std::uint64_t threadBytes{ 0 };
+
+// count an allocation of size bytes and make it (nullptr if it failed)
+static void* allocate(std::size_t size) {
+	threadAllocations++;
+	threadBytes += size;
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size) {
+	void* memory{ allocate(size) };
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return allocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+	std::free(memory);
+}
+
+// return true if allocations are being counted (see TETRIS_NO_ALLOCATION_COUNTING)
+bool AllocationCounter::isCounting() {
+	return true;
+}
+
+// return the number of allocations the calling thread has made so far
+std::uint64_t AllocationCounter::getThreadCount() {
+	return threadAllocations;
+}
+
+// return the number of bytes the calling thread has allocated so far
+std::uint64_t AllocationCounter::getThreadBytes() {
+	return threadBytes;
+}
+
+#else
+
+// return true if allocations are being counted (see TETRIS_NO_ALLOCATION_COUNTING)
+bool AllocationCounter::isCounting() {
+	return false;
+}
+
+// return the number of allocations the calling thread has made so far
+std::uint64_t AllocationCounter::getThreadCount() {
+	return 0;
+}
+
+// return the number of bytes the calling thread has allocated so far
+std::uint64_t AllocationCounter::getThreadBytes() {
+	return 0;
+}
+
+#endif
@@ -0,0 +1,34 @@
+// The AllocationCounter counts the heap allocations (calls of the global
+// operator new) made by each thread, so code can be checked for allocating:
+// read getThreadCount() before and after it. The profiler uses it to show the
+// allocations of every phase (per tick, per frame), tetris-bench per benchmark
+// call (and so per simulated game), and TestSuite to check that steady-state
+// gameplay doesn't allocate at all.
+//
+// AllocationCounter.cpp replaces the global operator new & delete (which C++
+// allows a program to do) with versions that bump a thread_local count and
+// call malloc & free, so it counts every allocation in the program, whoever
+// makes it (SFML, the standard library ...). The count costs one increment per
+// allocation, with no sharing between threads. Defining
+// TETRIS_NO_ALLOCATION_COUNTING leaves the standard operators in place: then
+// isCounting() is false and the counts stay 0.
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+class AllocationCounter
+{
+public:
+	// return true if allocations are being counted (see TETRIS_NO_ALLOCATION_COUNTING)
+	static bool isCounting();
+
+	// return the number of allocations the calling thread has made so far
+	static std::uint64_t getThreadCount();
+
+	// return the number of bytes the calling thread has allocated so far
+	static std::uint64_t getThreadBytes();
+};
+
+#endif /* ALLOCATIONCOUNTER_H */
@@ -0,0 +1,135 @@
+#include "BatchEvaluator.h"
+#include <assert.h>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#include "BatchEvaluatorKernel.h"
+
+// lay out the boards that result from locking the engine's currentShape at
+// each of the placements (as previewPlacement() would, completed rows removed).
+//   count must be <= MAX_BOARDS.
+void BatchEvaluator::loadPlacements(const TetrisEngine& engine, const Placement placements[], int count) {
+	assert(count >= 0 && count <= MAX_BOARDS);
+	boardCount = count;
+
+	// the engine's board as row masks, shared by every candidate
+	std::uint16_t boardRows[Gameboard::MAX_Y];
+	getRowMasks(engine.getBoard(), boardRows);
+
+	TetShape shape{ engine.getCurrentShape().getShape() };
+	for (int i{ 0 }; i < count; i++) {
+		// add the shape's blocks to a copy of the board
+		std::uint16_t candidate[Gameboard::MAX_Y];
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+			candidate[y] = boardRows[y];
+		}
+		const Point* offsets{ TetrisEngine::getShapeOffsets(shape, placements[i].rotation) };
+		for (int j{ 0 }; j < 4; j++) {
+			int y{ placements[i].y + offsets[j].getY() };
+			if (y >= 0) {
+				candidate[y] |= 1 << (placements[i].x + offsets[j].getX());
+			}
+		}
+
+		// copy it into lane i bottom up, skipping completed rows (so the rows
+		// above them move down) and filling the top with empty rows
+		int to{ Gameboard::MAX_Y - 1 };
+		for (int from{ Gameboard::MAX_Y - 1 }; from >= 0; from--) {
+			if (candidate[from] != FULL_ROW) {
+				rows[to--][i] = candidate[from];
+			}
+		}
+		rowsCleared[i] = to + 1;
+		for (; to >= 0; to--) {
+			rows[to][i] = 0;
+		}
+	}
+}
+
+// write board as row masks into rows (MAX_Y entries, bit x set = a block at x)
+void BatchEvaluator::getRowMasks(const Gameboard& board, std::uint16_t rows[]) {
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+		rows[y] = 0;
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+			if (board.getContent(x, y) != Gameboard::EMPTY_BLOCK) {
+				rows[y] |= 1 << x;
+			}
+		}
+	}
+}
+
+// measure the features of every loaded board
+//   features must have room for getBoardCount() entries.
+void BatchEvaluator::getFeatures(BoardFeatures features[]) const {
+	int aggregateHeight[MAX_BOARDS];
+	int holes[MAX_BOARDS];
+	int bumpiness[MAX_BOARDS];
+	int maxHeight[MAX_BOARDS];
+	measure(aggregateHeight, holes, bumpiness, maxHeight);
+	for (int i{ 0 }; i < boardCount; i++) {
+		features[i].aggregateHeight = aggregateHeight[i];
+		features[i].holes = holes[i];
+		features[i].bumpiness = bumpiness[i];
+		features[i].maxHeight = maxHeight[i];
+	}
+}
+
+// score every loaded board with weights (see Evaluator::evaluate())
+//   scores must have room for getBoardCount() entries.
+void BatchEvaluator::evaluate(const EvaluatorWeights& weights, double scores[]) const {
+	int aggregateHeight[MAX_BOARDS];
+	int holes[MAX_BOARDS];
+	int bumpiness[MAX_BOARDS];
+	int maxHeight[MAX_BOARDS];
+	measure(aggregateHeight, holes, bumpiness, maxHeight);
+	for (int i{ 0 }; i < boardCount; i++) {
+		// same order of operations as Evaluator::evaluate(), so the scores are identical
+		scores[i] = weights.aggregateHeight * aggregateHeight[i]
+			+ weights.rowsCleared * rowsCleared[i]
+			+ weights.holes * holes[i]
+			+ weights.bumpiness * bumpiness[i];
+	}
+}
+
+// measure the features of every loaded board, one array per feature
+// (with measureAvx2() if the CPU has AVX2, else measureDefault())
+void BatchEvaluator::measure(int aggregateHeight[], int holes[], int bumpiness[], int maxHeight[]) const {
+	static const bool AVX2{ isAvx2Supported() };
+	if (AVX2) {
+		measureAvx2(aggregateHeight, holes, bumpiness, maxHeight);
+	}
+	else {
+		measureDefault(aggregateHeight, holes, bumpiness, maxHeight);
+	}
+}
+
+// measure(), built for the default instruction set
+void BatchEvaluator::measureDefault(int aggregateHeight[], int holes[], int bumpiness[], int maxHeight[]) const {
+	measureBoards(rows, boardCount, aggregateHeight, holes, bumpiness, maxHeight);
+}
+
+// return true if the CPU (and OS) can run AVX2 code
+bool BatchEvaluator::isAvx2Supported() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	// AVX (and the OS saving the ymm registers, XGETBV's bits 1 & 2), then AVX2
+	__cpuid(info, 1);
+	const int OSXSAVE = 1 << 27;
+	const int AVX = 1 << 28;
+	if ((info[2] & (OSXSAVE | AVX)) != (OSXSAVE | AVX) || (_xgetbv(0) & 6) != 6) {
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	const int AVX2 = 1 << 5;
+	return (info[1] & AVX2) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_cpu_supports("avx2") != 0;
+#else
+	return false;
+#endif
+}
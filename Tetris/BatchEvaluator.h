@@ -0,0 +1,84 @@
+// The BatchEvaluator class measures the features of many candidate gameboards
+// at once, typically every placement of the current shape.
+//
+// Instead of one Gameboard (a grid of ints) per candidate, the candidates are
+// laid out as a "structure of arrays": every row of every candidate is a single
+// bit mask (bit x set = a block at column x), and the masks for the same row of
+// all candidates sit next to each other in memory:
+//
+//     rows[y][0], rows[y][1], ... rows[y][boardCount-1]
+//
+// The feature loops then walk the rows once and work on all the candidates
+// ("lanes") in the innermost loop. Those loops are plain, branch free integer
+// arithmetic over contiguous arrays, which the compiler turns into SIMD code:
+// 8 lanes of 16 bit masks per instruction with SSE2, 16 with AVX2. The loops
+// (BatchEvaluatorKernel.h) are built twice: for the default instruction set
+// here, and for AVX2 in BatchEvaluatorAvx2.cpp, the only file built with it.
+// measure() picks the AVX2 build when the CPU has it, so the programs still
+// run on CPUs that don't.
+//
+// The features and scores match Evaluator::getFeatures() and Evaluator::evaluate()
+// exactly, so a bot picks the same placement either way.
+
+#ifndef BATCHEVALUATOR_H
+#define BATCHEVALUATOR_H
+
+#include <cstdint>
+#include "Evaluator.h"
+#include "Placement.h"
+#include "TetrisEngine.h"
+
+class BatchEvaluator
+{
+public:
+	// STATIC CONSTANTS
+	static const int MAX_BOARDS = TetrisEngine::MAX_PLACEMENTS;		// candidates per batch
+	static const std::uint16_t FULL_ROW = (1 << Gameboard::MAX_X) - 1;	// row mask of a completed row
+
+	// lay out the boards that result from locking the engine's currentShape at
+	// each of the placements (as previewPlacement() would, completed rows removed).
+	//   count must be <= MAX_BOARDS.
+	void loadPlacements(const TetrisEngine& engine, const Placement placements[], int count);
+
+	int getBoardCount() const { return boardCount; }
+
+	// write board as row masks into rows (MAX_Y entries, bit x set = a block at x)
+	static void getRowMasks(const Gameboard& board, std::uint16_t rows[]);
+
+	// the number of rows the placement that produced board i cleared
+	int getRowsCleared(int i) const { return rowsCleared[i]; }
+
+	// measure the features of every loaded board
+	//   features must have room for getBoardCount() entries.
+	void getFeatures(BoardFeatures features[]) const;
+
+	// score every loaded board with weights (see Evaluator::evaluate())
+	//   scores must have room for getBoardCount() entries.
+	void evaluate(const EvaluatorWeights& weights, double scores[]) const;
+
+	// return true if the CPU (and OS) can run AVX2 code
+	static bool isAvx2Supported();
+
+private:
+	// measure the features of every loaded board, one array per feature
+	// (with measureAvx2() if the CPU has AVX2, else measureDefault())
+	void measure(int aggregateHeight[], int holes[], int bumpiness[], int maxHeight[]) const;
+
+	// measure(), built for the default instruction set
+	void measureDefault(int aggregateHeight[], int holes[], int bumpiness[], int maxHeight[]) const;
+
+	// measure(), built for AVX2 (BatchEvaluatorAvx2.cpp)
+	//   only call it if isAvx2Supported().
+	void measureAvx2(int aggregateHeight[], int holes[], int bumpiness[], int maxHeight[]) const;
+
+	// MEMBER VARIABLES
+	std::uint16_t rows[Gameboard::MAX_Y][MAX_BOARDS];	// row masks, [y][board] ([0] is the top row)
+	int rowsCleared[MAX_BOARDS];						// rows cleared by each board's placement
+	int boardCount = 0;
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* BATCHEVALUATOR_H */
@@ -0,0 +1,27 @@
+// BatchEvaluator::measureAvx2(): the feature loops built for AVX2 (see
+// BatchEvaluatorKernel.h). This is the only file built for AVX2: with MSVC
+// the projects set /arch:AVX2 on it alone, with gcc & clang the pragmas below
+// do the same. Nothing here runs unless BatchEvaluator::isAvx2Supported().
+
+#include "BatchEvaluator.h"
+
+#if defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "BatchEvaluatorKernel.h"
+
+// measure(), built for AVX2 (BatchEvaluatorAvx2.cpp)
+//   only call it if isAvx2Supported().
+void BatchEvaluator::measureAvx2(int aggregateHeight[], int holes[], int bumpiness[], int maxHeight[]) const {
+	measureBoards(rows, boardCount, aggregateHeight, holes, bumpiness, maxHeight);
+}
+
+#if defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#pragma clang attribute pop
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,62 @@
+// The BatchEvaluator's feature loops (see BatchEvaluator.h), as a function
+// of its row masks, so they can be built for more than one instruction set:
+// BatchEvaluator.cpp includes this for the default one, BatchEvaluatorAvx2.cpp
+// for AVX2. measureBoards() is static, so each file gets its own copy (the
+// linker can't swap one for the other); it must not call inline functions
+// from other headers, which would be built for AVX2 too and could end up
+// shared with code that runs on any CPU.
+
+#ifndef BATCHEVALUATORKERNEL_H
+#define BATCHEVALUATORKERNEL_H
+
+#include <cstdint>
+#include "BatchEvaluator.h"
+
+// measure the features of the first boardCount boards in rows, one array per feature
+static void measureBoards(const std::uint16_t rows[][BatchEvaluator::MAX_BOARDS], int boardCount,
+	int aggregateHeight[], int holes[], int bumpiness[], int maxHeight[]) {
+	const int MAX_BOARDS{ BatchEvaluator::MAX_BOARDS };
+	// walking down the rows, a column is "covered" from its highest block on.
+	//  - a column's height is the number of rows it is covered in
+	//  - a hole is an empty grid loc in a covered column
+	std::uint16_t covered[MAX_BOARDS] = {};
+	int heights[Gameboard::MAX_X][MAX_BOARDS] = {};
+	int blocks[MAX_BOARDS] = {};
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+		const std::uint16_t* row{ rows[y] };
+		for (int i{ 0 }; i < boardCount; i++) {
+			covered[i] |= row[i];
+		}
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+			for (int i{ 0 }; i < boardCount; i++) {
+				heights[x][i] += (covered[i] >> x) & 1;
+				blocks[i] += (row[i] >> x) & 1;
+			}
+		}
+	}
+
+	for (int i{ 0 }; i < boardCount; i++) {
+		aggregateHeight[i] = 0;
+		bumpiness[i] = 0;
+		maxHeight[i] = 0;
+	}
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+		for (int i{ 0 }; i < boardCount; i++) {
+			int height{ heights[x][i] };
+			aggregateHeight[i] += height;
+			maxHeight[i] = height > maxHeight[i] ? height : maxHeight[i];
+		}
+	}
+	for (int x{ 1 }; x < Gameboard::MAX_X; x++) {
+		for (int i{ 0 }; i < boardCount; i++) {
+			int difference{ heights[x][i] - heights[x - 1][i] };
+			bumpiness[i] += difference < 0 ? -difference : difference;
+		}
+	}
+	// every block is inside its column's height, every other covered loc is a hole
+	for (int i{ 0 }; i < boardCount; i++) {
+		holes[i] = aggregateHeight[i] - blocks[i];
+	}
+}
+
+#endif /* BATCHEVALUATORKERNEL_H */
@@ -0,0 +1,73 @@
+#include "BatchSimulator.h"
+#include <atomic>
+#include <thread>
+#include "BatchEvaluator.h"
+#include "TetrisEngine.h"
+
+// constructor, threadCount 0 means one thread per core
+BatchSimulator::BatchSimulator(int threadCount, int maxPieces) : maxPieces{ maxPieces } {
+	if (threadCount <= 0) {
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	this->threadCount = threadCount > 0 ? threadCount : 1;
+}
+
+// play every job, writing the outcome of jobs[i] into results[i].
+// returns when all of the games are over.
+void BatchSimulator::run(const std::vector<GameJob>& jobs, std::vector<GameResult>& results) const {
+	results.assign(jobs.size(), GameResult());
+	std::atomic<int> nextJob{ 0 };
+	// the threads take jobs one at a time, so a few long games
+	// can't leave the other cores idle at the end of a batch
+	auto worker = [&]() {
+		for (int i{ nextJob++ }; i < static_cast<int>(jobs.size()); i = nextJob++) {
+			results[i] = playGame(jobs[i], maxPieces, dataset);
+		}
+	};
+	std::vector<std::thread> helpers;
+	for (int i{ 1 }; i < threadCount && i < static_cast<int>(jobs.size()); i++) {
+		helpers.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& helper : helpers) {
+		helper.join();
+	}
+}
+
+// play a single game until it's over or maxPieces have been placed
+//   if dataset isn't nullptr, the game's samples are written to it.
+GameResult BatchSimulator::playGame(const GameJob& job, int maxPieces, DatasetWriter* dataset) {
+	TetrisEngine engine(job.seed);
+	Evaluator evaluator(job.weights);
+	Placement placement;
+	std::vector<DatasetSample> samples;
+	std::vector<int> scoresBefore;
+	while (!engine.isGameOver() && engine.getPiecesPlaced() < maxPieces) {
+		evaluator.choosePlacement(engine, placement);
+		if (dataset) {
+			DatasetSample sample;
+			BatchEvaluator::getRowMasks(engine.getBoard(), sample.rows);
+			sample.currentShape = static_cast<std::uint8_t>(engine.getCurrentShape().getShape());
+			sample.nextShape = static_cast<std::uint8_t>(engine.getNextShape().getShape());
+			sample.placement = placement;
+			samples.push_back(sample);
+			scoresBefore.push_back(engine.getScore());
+		}
+		engine.applyPlacement(placement);
+	}
+
+	// the outcome is only known now the game is over
+	if (dataset) {
+		for (int i{ 0 }; i < static_cast<int>(samples.size()); i++) {
+			samples[i].rowsClearedAfter = engine.getScore() - scoresBefore[i];
+			samples[i].toppedOut = engine.isGameOver();
+		}
+		dataset->write(samples.data(), static_cast<int>(samples.size()));
+	}
+
+	GameResult result;
+	result.rowsCleared = engine.getScore();
+	result.piecesPlaced = engine.getPiecesPlaced();
+	result.toppedOut = engine.isGameOver();
+	return result;
+}
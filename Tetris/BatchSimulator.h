@@ -0,0 +1,61 @@
+// The BatchSimulator class plays large numbers of headless games, spread
+// across all of the machine's cores.
+//
+// Every game is described by a GameJob: the seed for its shape sequence and the
+// Evaluator weights of the greedy bot playing it. Because each game owns its
+// TetrisEngine (and the engine owns its random generator), a job always plays
+// out the same way no matter which thread runs it or in which order.
+//
+// Given a DatasetWriter, the simulator also records every decision of every
+// game (with its outcome) for training models on.
+
+#ifndef BATCHSIMULATOR_H
+#define BATCHSIMULATOR_H
+
+#include <vector>
+#include "DatasetWriter.h"
+#include "Evaluator.h"
+
+// one game for the simulator to play
+struct GameJob
+{
+	EvaluatorWeights weights;		// the greedy bot's evaluator weights
+	unsigned long long seed = 1;	// the engine's seed (the shape sequence)
+};
+
+// how a game went
+struct GameResult
+{
+	int rowsCleared = 0;
+	int piecesPlaced = 0;
+	bool toppedOut = false;		// false if the game was stopped at maxPieces
+};
+
+class BatchSimulator
+{
+public:
+	// constructor, threadCount 0 means one thread per core
+	explicit BatchSimulator(int threadCount = 0, int maxPieces = 500);
+
+	int getThreadCount() const { return threadCount; }
+	int getMaxPieces() const { return maxPieces; }
+	void setMaxPieces(int maxPieces) { this->maxPieces = maxPieces; }
+
+	// record the games played by run() in dataset (nullptr to stop recording)
+	void setDataset(DatasetWriter* dataset) { this->dataset = dataset; }
+
+	// play every job, writing the outcome of jobs[i] into results[i].
+	// returns when all of the games are over.
+	void run(const std::vector<GameJob>& jobs, std::vector<GameResult>& results) const;
+
+	// play a single game until it's over or maxPieces have been placed
+	//   if dataset isn't nullptr, the game's samples are written to it.
+	static GameResult playGame(const GameJob& job, int maxPieces, DatasetWriter* dataset = nullptr);
+
+private:
+	int threadCount;	// worker threads used by run()
+	int maxPieces;		// games are stopped after this many pieces
+	DatasetWriter* dataset = nullptr;	// where run() records games (if anywhere)
+};
+
+#endif /* BATCHSIMULATOR_H */
@@ -0,0 +1,55 @@
+// The BlockLocs class is the list of a tetromino's block locs. A tetromino
+// never has more than CAPACITY blocks, so they are kept in place in a fixed
+// array instead of a std::vector: copying a tetromino (which the engine does
+// to try every move) then never allocates.
+// It has the parts of std::vector's interface that the tetromino code uses.
+
+#ifndef BLOCKLOCS_H
+#define BLOCKLOCS_H
+
+#include <assert.h>
+#include <initializer_list>
+#include "Point.h"
+
+class BlockLocs
+{
+public:
+	static const int CAPACITY = 4;
+
+	BlockLocs() {}
+	BlockLocs(std::initializer_list<Point> locs) {
+		for (const Point& loc : locs) {
+			push_back(loc);
+		}
+	}
+
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+	void clear() { count = 0; }
+
+	void push_back(const Point& loc) {
+		assert(count < CAPACITY);
+		locs[count++] = loc;
+	}
+
+	Point& operator[](int i) {
+		assert(i >= 0 && i < count);
+		return locs[i];
+	}
+	const Point& operator[](int i) const {
+		assert(i >= 0 && i < count);
+		return locs[i];
+	}
+
+	Point* begin() { return locs; }
+	Point* end() { return locs + count; }
+	const Point* begin() const { return locs; }
+	const Point* end() const { return locs + count; }
+	const Point* data() const { return locs; }
+
+private:
+	Point locs[CAPACITY];
+	int count = 0;
+};
+
+#endif /* BLOCKLOCS_H */
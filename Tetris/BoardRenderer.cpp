@@ -0,0 +1,97 @@
+#include "BoardRenderer.h"
+#include <assert.h>
+
+// the vertices of one grid loc, and of one row
+static const int VERTICES_PER_BLOCK = 4;
+static const int VERTICES_PER_ROW = VERTICES_PER_BLOCK * Gameboard::MAX_X;
+
+// constructor, blocks are blockWidth x blockHeight pixels and their colors
+// are laid out side by side in pTexture (as in images/tiles.png)
+BoardRenderer::BoardRenderer(const sf::Texture* pTexture, int blockWidth, int blockHeight)
+	: pTexture{ pTexture }, blockWidth{ blockWidth }, blockHeight{ blockHeight } {
+	assert(pTexture);
+	vertices.resize(VERTICES_PER_ROW * Gameboard::MAX_Y);
+	useVertexBuffer = sf::VertexBuffer::isAvailable() && vertexBuffer.create(vertices.size());
+}
+
+// bring the vertices up to date with board
+//   return the number of rows that were uploaded (0 if nothing changed)
+int BoardRenderer::update(const Gameboard& board) {
+	if (isUploaded && board.getGeneration() == uploadedGeneration) {
+		return 0;
+	}
+
+	// find the rows that differ from the last upload, and upload each run
+	// of changed rows with a single update
+	int rowsUploaded{ 0 };
+	int firstChangedRow{ -1 };
+	for (int y{ 0 }; y <= Gameboard::MAX_Y; y++) {
+		bool changed{ false };
+		if (y < Gameboard::MAX_Y) {
+			for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+				if (!isUploaded || uploaded[y][x] != board.getContent(x, y)) {
+					changed = true;
+					break;
+				}
+			}
+		}
+		if (changed) {
+			buildRow(board, y);
+			if (firstChangedRow < 0) {
+				firstChangedRow = y;
+			}
+		}
+		else if (firstChangedRow >= 0) {
+			uploadRows(firstChangedRow, y - 1);
+			rowsUploaded += y - firstChangedRow;
+			firstChangedRow = -1;
+		}
+	}
+	uploadedGeneration = board.getGeneration();
+	isUploaded = true;
+	return rowsUploaded;
+}
+
+// draw the board (sf::Drawable)
+void BoardRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+	states.transform *= getTransform();
+	states.texture = pTexture;
+	if (useVertexBuffer) {
+		target.draw(vertexBuffer, states);
+	}
+	else {
+		target.draw(vertices.data(), vertices.size(), sf::Quads, states);
+	}
+}
+
+// rebuild the vertices of row y from board
+void BoardRenderer::buildRow(const Gameboard& board, int y) {
+	float top{ static_cast<float>(y * blockHeight) };
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+		int content{ board.getContent(x, y) };
+		uploaded[y][x] = content;
+		sf::Vertex* quad{ &vertices[y * VERTICES_PER_ROW + x * VERTICES_PER_BLOCK] };
+		float left{ static_cast<float>(x * blockWidth) };
+		if (content == Gameboard::EMPTY_BLOCK) {
+			// a quad with no area: nothing is drawn
+			for (int i{ 0 }; i < VERTICES_PER_BLOCK; i++) {
+				quad[i] = sf::Vertex(sf::Vector2f(left, top));
+			}
+			continue;
+		}
+		float textureLeft{ static_cast<float>(content * blockWidth) };
+		quad[0] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(textureLeft, 0));
+		quad[1] = sf::Vertex(sf::Vector2f(left + blockWidth, top), sf::Vector2f(textureLeft + blockWidth, 0));
+		quad[2] = sf::Vertex(sf::Vector2f(left + blockWidth, top + blockHeight), sf::Vector2f(textureLeft + blockWidth, static_cast<float>(blockHeight)));
+		quad[3] = sf::Vertex(sf::Vector2f(left, top + blockHeight), sf::Vector2f(textureLeft, static_cast<float>(blockHeight)));
+	}
+}
+
+// upload the vertices of rows firstRow to lastRow (inclusive)
+void BoardRenderer::uploadRows(int firstRow, int lastRow) {
+	if (!useVertexBuffer) {
+		return;		// drawn straight from vertices
+	}
+	unsigned int offset{ static_cast<unsigned int>(firstRow * VERTICES_PER_ROW) };
+	vertexBuffer.update(&vertices[offset], (lastRow - firstRow + 1) * VERTICES_PER_ROW, offset);
+}
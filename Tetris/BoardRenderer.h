@@ -0,0 +1,66 @@
+// The BoardRenderer class draws the locked blocks of a gameboard with a single
+// draw call, keeping the block quads in video memory (an sf::VertexBuffer).
+//
+// Every grid loc owns 4 vertices (empty locs get a quad with no area, so they
+// draw nothing). update() compares the gameboard with what was uploaded last
+// time and only re-uploads the vertex ranges of the rows that changed (the rows
+// a lock touched, or the rows that moved down when rows were cleared). The
+// gameboard's generation number lets update() skip even that comparison on
+// frames where nothing was locked, so most frames upload nothing at all.
+//
+// That keeps the cost per board small enough to draw hundreds of them. Because
+// the vertices are relative to the board's top left, a BoardRenderer can be
+// moved (or scaled) with setPosition()/setScale() without any re-upload.
+//
+// If the graphics driver doesn't support vertex buffers, the same vertices are
+// drawn from memory instead.
+
+#ifndef BOARDRENDERER_H
+#define BOARDRENDERER_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "Gameboard.h"
+
+class BoardRenderer : public sf::Drawable, public sf::Transformable
+{
+public:
+	// constructor, blocks are blockWidth x blockHeight pixels and their colors
+	// are laid out side by side in pTexture (as in images/tiles.png)
+	BoardRenderer(const sf::Texture* pTexture, int blockWidth, int blockHeight);
+
+	// bring the vertices up to date with board
+	//   return the number of rows that were uploaded (0 if nothing changed)
+	int update(const Gameboard& board);
+
+	// forget what has been uploaded, so the next update() uploads every row
+	void invalidate() { isUploaded = false; }
+
+	// return true if the vertices live in video memory (an sf::VertexBuffer)
+	bool isUsingVertexBuffer() const { return useVertexBuffer; }
+
+private:
+	// draw the board (sf::Drawable)
+	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+	// rebuild the vertices of row y from board
+	void buildRow(const Gameboard& board, int y);
+
+	// upload the vertices of rows firstRow to lastRow (inclusive)
+	void uploadRows(int firstRow, int lastRow);
+
+	// MEMBER VARIABLES
+	const sf::Texture* pTexture;
+	int blockWidth;
+	int blockHeight;
+
+	std::vector<sf::Vertex> vertices;		// 4 per grid loc, row by row ([0] is the top row)
+	sf::VertexBuffer vertexBuffer{ sf::Quads, sf::VertexBuffer::Dynamic };
+	bool useVertexBuffer = false;
+
+	int uploaded[Gameboard::MAX_Y][Gameboard::MAX_X];	// the grid contents the vertices show
+	unsigned long long uploadedGeneration = 0;			// and the board generation they came from
+	bool isUploaded = false;
+};
+
+#endif /* BOARDRENDERER_H */
@@ -0,0 +1,108 @@
+#include "BotThread.h"
+#include "Metrics.h"
+#include "Tracer.h"
+
+// constructor, start the thread (it sleeps until there is a request)
+BotThread::BotThread(const MctsSettings& settings) : bot{ settings } {
+	thread = std::thread(&BotThread::run, this);
+}
+
+// destructor, stop the thread (waits for a search in progress to finish)
+BotThread::~BotThread() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeUp.notify_one();
+	thread.join();
+}
+
+// hand the bot a position to find a placement for, tagged with requestId.
+// A new request replaces any request the bot hasn't started on yet.
+void BotThread::requestPlacement(const TetrisEngine& engine, unsigned int requestId) {
+	{
+		// only held for the copy, the bot thread never searches while holding it
+		std::lock_guard<std::mutex> lock(mutex);
+		request = engine;
+		this->requestId = requestId;
+		hasRequest = true;
+	}
+	wakeUp.notify_one();
+}
+
+// if the bot has answered request requestId, write the answer into
+// placement and return true (otherwise return false)
+bool BotThread::pollPlacement(unsigned int requestId, Placement& placement) const {
+	unsigned long long answer{ mailbox.load(std::memory_order_acquire) };
+	if (static_cast<unsigned int>(answer >> 32) != requestId || ((answer >> 24) & 0xFF) == 0) {
+		return false;
+	}
+	placement.rotation = static_cast<int>((answer >> 16) & 0xFF);
+	placement.x = static_cast<int>((answer >> 8) & 0xFF) - 128;
+	placement.y = static_cast<int>(answer & 0xFF) - 128;
+	return true;
+}
+
+// the thread's main loop: wait for a request, answer it, think ahead
+void BotThread::run() {
+	Tracer::setThreadName("bot");
+	TetrisEngine position;
+	unsigned int id{ 0 };
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeUp.wait(lock, [this]() { return hasRequest || stopping; });
+			if (stopping) {
+				return;
+			}
+			position = request;
+			id = requestId;
+			hasRequest = false;
+		}
+
+		// answer the request (straight away if we saw it coming)
+		Placement placement;
+		if (hasPrediction && position.isSamePosition(predicted)) {
+			placement = predictedPlacement;
+		}
+		else if (!search(position, placement)) {
+			hasPrediction = false;
+			continue;
+		}
+		publish(id, placement);
+
+		// think ahead: assume our answer gets played and search the position
+		// the next shape spawns into, unless the game has already moved on
+		predicted = position;
+		hasPrediction = false;
+		if (predicted.applyPlacement(placement) >= 0 && !predicted.isGameOver()) {
+			bool newRequest;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				newRequest = hasRequest || stopping;
+			}
+			if (!newRequest) {
+				hasPrediction = search(predicted, predictedPlacement);
+			}
+		}
+	}
+}
+
+// search position and write the best placement into placement
+//   return false if there is none (the game is over).
+bool BotThread::search(const TetrisEngine& position, Placement& placement) {
+	TRACE_SCOPE("bot search");
+	bool found{ bot.choosePlacement(position, placement) };
+	Metrics::add(Metric::BOT_NODES, bot.getLastNodeCount());
+	return found;
+}
+
+// publish the answer to request requestId in the mailbox
+void BotThread::publish(unsigned int requestId, const Placement& placement) {
+	unsigned long long answer{ static_cast<unsigned long long>(requestId) << 32 };
+	answer |= 1ULL << 24;
+	answer |= static_cast<unsigned long long>(placement.rotation & 0xFF) << 16;
+	answer |= static_cast<unsigned long long>((placement.x + 128) & 0xFF) << 8;
+	answer |= static_cast<unsigned long long>((placement.y + 128) & 0xFF);
+	mailbox.store(answer, std::memory_order_release);
+}
@@ -0,0 +1,80 @@
+// The BotThread class runs an MctsBot on a background thread, so that a game
+// loop can ask for placements without ever waiting for a search to finish.
+//
+//  - requestPlacement() hands the bot a snapshot of the game and returns at once.
+//  - pollPlacement() checks the mailbox for the bot's answer (it never blocks).
+//
+// Answers are published through a single atomic "mailbox" word that packs the
+// request id together with the placement, so a reader can never see half of
+// an answer or an answer meant for an older request.
+//
+// While the game is busy with the current shape, the bot thinks ahead: it plays
+// its own answer on a copy of the game and starts searching the position that
+// the next shape will spawn into. If the game then really arrives at that
+// position, the answer to the next request is ready (almost) immediately.
+
+#ifndef BOTTHREAD_H
+#define BOTTHREAD_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "MctsBot.h"
+#include "TetrisEngine.h"
+
+class BotThread
+{
+public:
+	// constructor, start the thread (it sleeps until there is a request)
+	explicit BotThread(const MctsSettings& settings = MctsSettings());
+
+	// destructor, stop the thread (waits for a search in progress to finish)
+	~BotThread();
+
+	BotThread(const BotThread&) = delete;
+	BotThread& operator=(const BotThread&) = delete;
+
+	// hand the bot a position to find a placement for, tagged with requestId.
+	// A new request replaces any request the bot hasn't started on yet.
+	void requestPlacement(const TetrisEngine& engine, unsigned int requestId);
+
+	// if the bot has answered request requestId, write the answer into
+	// placement and return true (otherwise return false)
+	bool pollPlacement(unsigned int requestId, Placement& placement) const;
+
+private:
+	// the thread's main loop: wait for a request, answer it, think ahead
+	void run();
+
+	// search position and write the best placement into placement
+	//   return false if there is none (the game is over).
+	bool search(const TetrisEngine& position, Placement& placement);
+
+	// publish the answer to request requestId in the mailbox
+	void publish(unsigned int requestId, const Placement& placement);
+
+	// MEMBER VARIABLES
+
+	// written by the game, read by the bot thread (guarded by mutex)
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	TetrisEngine request;			// the latest position the game asked about
+	unsigned int requestId = 0;
+	bool hasRequest = false;		// true until the bot thread picks the request up
+	bool stopping = false;
+
+	// written by the bot thread, read by the game:
+	// [request id:32][valid:8][rotation:8][x + 128:8][y + 128:8]
+	std::atomic<unsigned long long> mailbox{ 0 };
+
+	// only touched by the bot thread
+	MctsBot bot;
+	TetrisEngine predicted;			// the position the bot expects to be asked about next
+	Placement predictedPlacement;	// and its answer
+	bool hasPrediction = false;
+
+	std::thread thread;				// started last, once everything above is ready
+};
+
+#endif /* BOTTHREAD_H */
@@ -0,0 +1,209 @@
+#include "DatasetWriter.h"
+#include <cstring>
+
+// the first 4 bytes of every dataset file
+static const char MAGIC[4] = { 'T', 'T', 'D', 'S' };
+static const int CHUNK_HEADER_BYTES = 12;
+
+// append value to buffer as little endian bytes
+static void putLittleEndian(char*& buffer, std::uint32_t value, int bytes) {
+	for (int i{ 0 }; i < bytes; i++) {
+		*buffer++ = static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+}
+
+// read a little endian value of bytes bytes from buffer
+static std::uint32_t getLittleEndian(const char*& buffer, int bytes) {
+	std::uint32_t value{ 0 };
+	for (int i{ 0 }; i < bytes; i++) {
+		value |= static_cast<std::uint32_t>(static_cast<unsigned char>(*buffer++)) << (8 * i);
+	}
+	return value;
+}
+
+// destructor, close() the file
+DatasetWriter::~DatasetWriter() {
+	close();
+}
+
+// create (or truncate) path, write the header and start the writer thread
+//   return false if the file can't be created.
+bool DatasetWriter::open(const std::string& path) {
+	close();
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	char header[12];
+	char* end{ header };
+	std::memcpy(end, MAGIC, sizeof(MAGIC));
+	end += sizeof(MAGIC);
+	putLittleEndian(end, VERSION, 4);
+	putLittleEndian(end, SAMPLE_BYTES, 4);
+	file.write(header, sizeof(header));
+
+	failed = !file;
+	closing = false;
+	sampleCount = 0;
+	filling.reserve(2 * SAMPLES_PER_CHUNK);
+	writing.reserve(2 * SAMPLES_PER_CHUNK);
+	thread = std::thread(&DatasetWriter::run, this);
+	return !failed;
+}
+
+// queue the samples of a game for writing (may be called from any thread)
+void DatasetWriter::write(const DatasetSample samples[], int count) {
+	std::unique_lock<std::mutex> lock(mutex);
+	filling.insert(filling.end(), samples, samples + count);
+	sampleCount += count;
+	while (filling.size() >= SAMPLES_PER_CHUNK) {
+		if (writing.empty()) {
+			// hand the full buffer to the writer and carry on with the empty one
+			filling.swap(writing);
+			chunkReady.notify_one();
+		}
+		else {
+			// the writer is still busy with the last buffer: the disk is behind
+			chunkWritten.wait(lock);
+		}
+	}
+}
+
+// write whatever is queued, stop the writer thread and close the file
+//   return false if any write failed.
+bool DatasetWriter::close() {
+	if (!thread.joinable()) {
+		return !failed;
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		chunkWritten.wait(lock, [this]() { return writing.empty(); });
+		filling.swap(writing);
+		closing = true;
+	}
+	chunkReady.notify_one();
+	thread.join();
+	file.close();
+	return !failed;
+}
+
+// the number of samples handed to write() so far
+long long DatasetWriter::getSampleCount() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return sampleCount;
+}
+
+// read every sample of a dataset file into samples. Chunks with a codec
+// this can't decode are skipped and counted in skippedChunks if it is
+// given, else they make the read fail.
+//   return false if the file is missing, malformed, cut short, or has
+//   chunks it can't decode (and no skippedChunks).
+bool DatasetWriter::readFile(const std::string& path, std::vector<DatasetSample>& samples, int* skippedChunks) {
+	samples.clear();
+	if (skippedChunks != nullptr) {
+		*skippedChunks = 0;
+	}
+	std::ifstream file(path, std::ios::binary);
+	char header[12];
+	if (!file.read(header, sizeof(header)) || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+		return false;
+	}
+	const char* read{ header + sizeof(MAGIC) };
+	if (getLittleEndian(read, 4) != VERSION || getLittleEndian(read, 4) != SAMPLE_BYTES) {
+		return false;
+	}
+
+	std::vector<char> payload;
+	char chunkHeader[CHUNK_HEADER_BYTES];
+	while (true) {
+		file.read(chunkHeader, sizeof(chunkHeader));
+		if (file.gcount() == 0 && file.eof()) {
+			return true;	// the end of the last chunk is the end of the file
+		}
+		if (file.gcount() != sizeof(chunkHeader)) {
+			return false;	// cut off in the middle of a chunk header
+		}
+		read = chunkHeader;
+		std::uint32_t payloadBytes{ getLittleEndian(read, 4) };
+		std::uint32_t count{ getLittleEndian(read, 4) };
+		std::uint8_t codec{ static_cast<std::uint8_t>(getLittleEndian(read, 1)) };
+		payload.resize(payloadBytes);
+		if (!file.read(payload.data(), payloadBytes)) {
+			return false;
+		}
+		if (codec != CODEC_RAW) {
+			// a codec we can't decode
+			if (skippedChunks == nullptr) {
+				return false;
+			}
+			(*skippedChunks)++;
+			continue;
+		}
+		if (payloadBytes != count * SAMPLE_BYTES) {
+			return false;
+		}
+		read = payload.data();
+		for (std::uint32_t i{ 0 }; i < count; i++) {
+			DatasetSample sample;
+			for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+				sample.rows[y] = static_cast<std::uint16_t>(getLittleEndian(read, 2));
+			}
+			sample.currentShape = static_cast<std::uint8_t>(getLittleEndian(read, 1));
+			sample.nextShape = static_cast<std::uint8_t>(getLittleEndian(read, 1));
+			sample.placement.rotation = static_cast<std::int8_t>(getLittleEndian(read, 1));
+			sample.placement.x = static_cast<std::int8_t>(getLittleEndian(read, 1));
+			sample.placement.y = static_cast<std::int8_t>(getLittleEndian(read, 1));
+			sample.toppedOut = getLittleEndian(read, 1) != 0;
+			sample.rowsClearedAfter = getLittleEndian(read, 4);
+			samples.push_back(sample);
+		}
+	}
+}
+
+// the writer thread's main loop: wait for a full buffer, write it
+void DatasetWriter::run() {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			chunkReady.wait(lock, [this]() { return !writing.empty() || closing; });
+			if (writing.empty()) {
+				return;		// closing, and everything has been written
+			}
+		}
+		// write without holding the mutex: the game threads only touch
+		// writing (to swap it) once it's empty again
+		writeChunk(writing);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			writing.clear();
+		}
+		chunkWritten.notify_all();
+	}
+}
+
+// encode samples as a raw chunk and write it to the file
+void DatasetWriter::writeChunk(const std::vector<DatasetSample>& samples) {
+	std::uint32_t count{ static_cast<std::uint32_t>(samples.size()) };
+	chunk.resize(CHUNK_HEADER_BYTES + count * SAMPLE_BYTES);
+	char* end{ chunk.data() };
+	putLittleEndian(end, count * SAMPLE_BYTES, 4);
+	putLittleEndian(end, count, 4);
+	putLittleEndian(end, CODEC_RAW, 1);
+	putLittleEndian(end, 0, 3);
+	for (const DatasetSample& sample : samples) {
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+			putLittleEndian(end, sample.rows[y], 2);
+		}
+		putLittleEndian(end, sample.currentShape, 1);
+		putLittleEndian(end, sample.nextShape, 1);
+		putLittleEndian(end, static_cast<std::uint32_t>(sample.placement.rotation), 1);
+		putLittleEndian(end, static_cast<std::uint32_t>(sample.placement.x), 1);
+		putLittleEndian(end, static_cast<std::uint32_t>(sample.placement.y), 1);
+		putLittleEndian(end, sample.toppedOut ? 1 : 0, 1);
+		putLittleEndian(end, sample.rowsClearedAfter, 4);
+	}
+	file.write(chunk.data(), chunk.size());
+	if (!file) {
+		failed = true;
+	}
+}
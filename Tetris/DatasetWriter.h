@@ -0,0 +1,111 @@
+// The DatasetWriter class streams self-play positions to a file, for training
+// models on. Each sample is one decision of a bot:
+//   - the board (as row masks, bit x set = a block at column x),
+//   - the piece queue (current & next shape),
+//   - the placement the bot chose,
+//   - the outcome: the rows cleared from that move to the end of the game,
+//     and whether the game ended by topping out.
+//
+// Simulation threads hand over whole games with write() and carry on; a writer
+// thread encodes and writes them. The writer is double buffered: samples are
+// collected in one buffer while the other one is being written, and the two are
+// swapped when the writer is done. Simulation threads only ever wait if the disk
+// can't keep up with them (so memory use stays bounded).
+//
+// File format (all integers little endian):
+//   header: "TTDS", u32 version (1), u32 sample size in bytes (48)
+//   chunks until the end of the file:
+//     u32 payload bytes, u32 sample count, u8 codec, 3 reserved bytes, payload
+//   codec 0 is the raw samples, each one:
+//     u16 rows[19] (top row first), u8 current shape, u8 next shape,
+//     i8 rotation, i8 x, i8 y, u8 topped out, u32 rows cleared after this move
+// Compressed codecs can be added later without breaking old files: a reader
+// that doesn't know a chunk's codec can skip the chunk, but must say so (see
+// readFile()) rather than pass off what's left as the whole dataset.
+
+#ifndef DATASETWRITER_H
+#define DATASETWRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Gameboard.h"
+#include "Placement.h"
+
+// one position of a self-play game and what happened next
+struct DatasetSample
+{
+	std::uint16_t rows[Gameboard::MAX_Y] = {};	// the board before the move ([0] is the top row)
+	std::uint8_t currentShape = 0;				// TetShape of the shape being placed
+	std::uint8_t nextShape = 0;					// TetShape of the shape on deck
+	Placement placement;						// where the bot put it
+	bool toppedOut = false;						// the game ended by topping out
+	std::uint32_t rowsClearedAfter = 0;			// rows cleared from this move on
+};
+
+class DatasetWriter
+{
+public:
+	// STATIC CONSTANTS
+	static const std::uint32_t VERSION = 1;
+	static const int SAMPLE_BYTES = 48;				// encoded size of a DatasetSample
+	static const int SAMPLES_PER_CHUNK = 16384;		// a chunk is written once it has this many
+	static const std::uint8_t CODEC_RAW = 0;
+
+	DatasetWriter() {}
+	// destructor, close() the file
+	~DatasetWriter();
+
+	DatasetWriter(const DatasetWriter&) = delete;
+	DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+	// create (or truncate) path, write the header and start the writer thread
+	//   return false if the file can't be created.
+	bool open(const std::string& path);
+
+	// queue the samples of a game for writing (may be called from any thread)
+	void write(const DatasetSample samples[], int count);
+
+	// write whatever is queued, stop the writer thread and close the file
+	//   return false if any write failed.
+	bool close();
+
+	// the number of samples handed to write() so far
+	long long getSampleCount() const;
+
+	// read every sample of a dataset file into samples. Chunks with a codec
+	// this can't decode are skipped and counted in skippedChunks if it is
+	// given, else they make the read fail.
+	//   return false if the file is missing, malformed, cut short, or has
+	//   chunks it can't decode (and no skippedChunks).
+	static bool readFile(const std::string& path, std::vector<DatasetSample>& samples, int* skippedChunks = nullptr);
+
+private:
+	// the writer thread's main loop: wait for a full buffer, write it
+	void run();
+
+	// encode samples as a raw chunk and write it to the file
+	void writeChunk(const std::vector<DatasetSample>& samples);
+
+	// MEMBER VARIABLES
+	mutable std::mutex mutex;
+	std::condition_variable chunkReady;		// signalled when there is something to write
+	std::condition_variable chunkWritten;	// signalled when the writer is free again
+	std::vector<DatasetSample> filling;		// collecting samples (guarded by mutex)
+	std::vector<DatasetSample> writing;		// being written, empty when the writer is free
+	bool closing = false;
+	long long sampleCount = 0;
+
+	// only touched by the writer thread while it runs
+	std::ofstream file;
+	std::vector<char> chunk;				// encoding buffer
+	bool failed = false;
+
+	std::thread thread;
+};
+
+#endif /* DATASETWRITER_H */
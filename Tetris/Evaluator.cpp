@@ -0,0 +1,64 @@
+#include "Evaluator.h"
+#include <cstdlib>
+#include "BatchEvaluator.h"
+
+// return the weighted score of board, where rowsCleared is the
+// number of rows the move that produced the board cleared
+double Evaluator::evaluate(const Gameboard& board, int rowsCleared) const {
+	BoardFeatures features{ getFeatures(board) };
+	return weights.aggregateHeight * features.aggregateHeight
+		+ weights.rowsCleared * rowsCleared
+		+ weights.holes * features.holes
+		+ weights.bumpiness * features.bumpiness;
+}
+
+// measure the features of board
+BoardFeatures Evaluator::getFeatures(const Gameboard& board) {
+	BoardFeatures features;
+	int previousHeight{ 0 };
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+		// the column height is measured from the bottom up to its highest block
+		int height{ 0 };
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+			if (board.getContent(x, y) != Gameboard::EMPTY_BLOCK) {
+				if (height == 0) {
+					height = Gameboard::MAX_Y - y;
+				}
+			}
+			else if (height != 0) {
+				features.holes++;
+			}
+		}
+		features.aggregateHeight += height;
+		if (height > features.maxHeight) {
+			features.maxHeight = height;
+		}
+		if (x > 0) {
+			features.bumpiness += std::abs(height - previousHeight);
+		}
+		previousHeight = height;
+	}
+	return features;
+}
+
+// pick the placement of the engine's currentShape that leads to the
+// best evaluated board.
+//   return false (leaving best untouched) if there are no placements.
+bool Evaluator::choosePlacement(const TetrisEngine& engine, Placement& best) const {
+	Placement placements[TetrisEngine::MAX_PLACEMENTS];
+	int count{ engine.getPlacements(placements) };
+
+	// score all the candidate boards in one go (see BatchEvaluator)
+	BatchEvaluator batch;
+	double scores[BatchEvaluator::MAX_BOARDS];
+	batch.loadPlacements(engine, placements, count);
+	batch.evaluate(weights, scores);
+	double bestScore{ 0.0 };
+	for (int i{ 0 }; i < count; i++) {
+		if (i == 0 || scores[i] > bestScore) {
+			bestScore = scores[i];
+			best = placements[i];
+		}
+	}
+	return count > 0;
+}
@@ -0,0 +1,64 @@
+// The Evaluator class scores a gameboard for bots: the higher the score, the
+// better the board is to keep playing on. It is a weighted sum of a few
+// classic board features:
+//   - aggregate height: the sum of the heights of every column
+//   - rows cleared:     the rows cleared by the placement that produced the board
+//   - holes:            empty grid locs that have a block somewhere above them
+//   - bumpiness:        the sum of height differences between neighbouring columns
+//
+// The weights are tunable; the defaults are known to play a decent game.
+// The Evaluator can also act as a simple greedy (one piece lookahead) player.
+
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "Gameboard.h"
+#include "Placement.h"
+#include "TetrisEngine.h"
+
+// the weight given to each board feature
+struct EvaluatorWeights
+{
+	double aggregateHeight = -0.510066;
+	double rowsCleared = 0.760666;
+	double holes = -0.35663;
+	double bumpiness = -0.184483;
+};
+
+// the raw (unweighted) features of a gameboard
+struct BoardFeatures
+{
+	int aggregateHeight = 0;
+	int holes = 0;
+	int bumpiness = 0;
+	int maxHeight = 0;
+};
+
+class Evaluator
+{
+public:
+	// constructor, use the default weights
+	Evaluator() {}
+	// constructor, use the given weights
+	explicit Evaluator(const EvaluatorWeights& weights) : weights{ weights } {}
+
+	const EvaluatorWeights& getWeights() const { return weights; }
+	void setWeights(const EvaluatorWeights& weights) { this->weights = weights; }
+
+	// return the weighted score of board, where rowsCleared is the
+	// number of rows the move that produced the board cleared
+	double evaluate(const Gameboard& board, int rowsCleared) const;
+
+	// measure the features of board
+	static BoardFeatures getFeatures(const Gameboard& board);
+
+	// pick the placement of the engine's currentShape that leads to the
+	// best evaluated board.
+	//   return false (leaving best untouched) if there are no placements.
+	bool choosePlacement(const TetrisEngine& engine, Placement& best) const;
+
+private:
+	EvaluatorWeights weights;
+};
+
+#endif /* EVALUATOR_H */
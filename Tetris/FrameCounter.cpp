@@ -0,0 +1,81 @@
+#include "FrameCounter.h"
+#include <cmath>
+#include <cstdio>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// constructor, report every reportSeconds
+FrameCounter::FrameCounter(double reportSeconds) : reportSeconds{ reportSeconds } {
+	cpuSecondsAtStart = getProcessCpuSeconds();
+}
+
+// record a frame that took frameSeconds in total, drawSeconds of which
+// were spent drawing.
+//   return true if the reporting period is over (a new report is ready).
+bool FrameCounter::addFrame(double frameSeconds, double drawSeconds) {
+	frames++;
+	seconds += frameSeconds;
+	squaredSeconds += frameSeconds * frameSeconds;
+	this->drawSeconds += drawSeconds;
+	if (frameSeconds > worstSeconds) {
+		worstSeconds = frameSeconds;
+	}
+	if (seconds < reportSeconds) {
+		return false;
+	}
+
+	framesPerSecond = frames / seconds;
+	averageFrameMs = 1000.0 * seconds / frames;
+	worstFrameMs = 1000.0 * worstSeconds;
+	averageDrawMs = 1000.0 * this->drawSeconds / frames;
+	double mean{ seconds / frames };
+	double variance{ squaredSeconds / frames - mean * mean };
+	jitterMs = variance > 0.0 ? 1000.0 * std::sqrt(variance) : 0.0;
+	double cpuSeconds{ getProcessCpuSeconds() };
+	cpuPercent = 100.0 * (cpuSeconds - cpuSecondsAtStart) / seconds;
+
+	cpuSecondsAtStart = cpuSeconds;
+	squaredSeconds = 0.0;
+	frames = 0;
+	seconds = 0.0;
+	this->drawSeconds = 0.0;
+	worstSeconds = 0.0;
+	return true;
+}
+
+// the last report as text, e.g.
+//   "60 fps  16.67 ms/frame (jitter 0.05, worst 17.02)  draw 0.41 ms  cpu 3%"
+std::string FrameCounter::getReport() const {
+	char text[128];
+	std::snprintf(text, sizeof(text), "%.0f fps  %.2f ms/frame (jitter %.2f, worst %.2f)  draw %.2f ms  cpu %.0f%%",
+		framesPerSecond, averageFrameMs, jitterMs, worstFrameMs, averageDrawMs, cpuPercent);
+	return text;
+}
+
+// return the CPU time (user + system) this process has used so far
+double FrameCounter::getProcessCpuSeconds() {
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+		return 0.0;
+	}
+	// FILETIMEs count 100ns intervals
+	ULARGE_INTEGER kernelTime, userTime;
+	kernelTime.LowPart = kernel.dwLowDateTime;
+	kernelTime.HighPart = kernel.dwHighDateTime;
+	userTime.LowPart = user.dwLowDateTime;
+	userTime.HighPart = user.dwHighDateTime;
+	return (kernelTime.QuadPart + userTime.QuadPart) * 1e-7;
+#else
+	timespec time;
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) {
+		return 0.0;
+	}
+	return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
@@ -0,0 +1,62 @@
+// The FrameCounter class keeps track of how long frames take, so the cost of
+// rendering can be seen while the game runs. It knows nothing about SFML:
+// main.cpp times each frame and hands the times in.
+//
+// Times are collected over a reporting period (a second by default); at the
+// end of each period a report is ready, and counting starts over. A report has
+//   - fps, the average & worst frame time and the time spent drawing,
+//   - jitter: how much frame times vary (their standard deviation),
+//   - cpu: the process's CPU time as a percentage of the period (100% = a core).
+
+#ifndef FRAMECOUNTER_H
+#define FRAMECOUNTER_H
+
+#include <string>
+
+class FrameCounter
+{
+public:
+	// constructor, report every reportSeconds
+	explicit FrameCounter(double reportSeconds = 1.0);
+
+	// record a frame that took frameSeconds in total, drawSeconds of which
+	// were spent drawing.
+	//   return true if the reporting period is over (a new report is ready).
+	bool addFrame(double frameSeconds, double drawSeconds);
+
+	// the last report's figures
+	double getFramesPerSecond() const { return framesPerSecond; }
+	double getAverageFrameMs() const { return averageFrameMs; }
+	double getWorstFrameMs() const { return worstFrameMs; }
+	double getAverageDrawMs() const { return averageDrawMs; }
+	double getJitterMs() const { return jitterMs; }
+	double getCpuPercent() const { return cpuPercent; }
+
+	// the last report as text, e.g.
+	//   "60 fps  16.67 ms/frame (jitter 0.05, worst 17.02)  draw 0.41 ms  cpu 3%"
+	std::string getReport() const;
+
+	// return the CPU time (user + system) this process has used so far
+	static double getProcessCpuSeconds();
+
+private:
+	double reportSeconds;
+
+	// the current period
+	int frames = 0;
+	double seconds = 0.0;
+	double drawSeconds = 0.0;
+	double worstSeconds = 0.0;
+	double squaredSeconds = 0.0;		// sum of the squared frame times (for the jitter)
+	double cpuSecondsAtStart = 0.0;
+
+	// the last report
+	double framesPerSecond = 0.0;
+	double averageFrameMs = 0.0;
+	double worstFrameMs = 0.0;
+	double averageDrawMs = 0.0;
+	double jitterMs = 0.0;
+	double cpuPercent = 0.0;
+};
+
+#endif /* FRAMECOUNTER_H */
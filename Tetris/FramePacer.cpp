@@ -0,0 +1,132 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <thread>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+// waitUntil() doesn't bother sleeping for less than this (it spins instead)
+static const double MIN_SLEEP_SECONDS = 0.0002;
+// the most of a wait waitUntil() may spin for
+static const double MAX_SPIN_FRACTION = 0.25;
+
+// constructor, start in mode, at targetFps for TARGET_FPS
+FramePacer::FramePacer(PacingMode mode, double targetFps) : mode{ mode } {
+	setTargetFps(targetFps);
+#ifdef _WIN32
+	// (the OS keeps the finest resolution any process has asked for, until it is given back)
+	timeBeginPeriod(1);
+#endif
+}
+
+// destructor, restore the OS timer's resolution (Windows)
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::setMode(PacingMode mode) {
+	this->mode = mode;
+	hasNextFrame = false;
+}
+
+void FramePacer::setTargetFps(double targetFps) {
+	this->targetFps = targetFps > 1.0 ? targetFps : 1.0;
+	hasNextFrame = false;
+}
+
+// in TARGET_FPS mode wait until the next frame is due,
+// in any other mode return at once
+void FramePacer::waitForNextFrame() {
+	if (mode != PacingMode::TARGET_FPS) {
+		return;
+	}
+	Clock::duration period{ std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps)) };
+	Clock::time_point now{ Clock::now() };
+	// start over if we're more than a frame late, rather than rushing
+	// through frames to catch up
+	if (!hasNextFrame || now - nextFrame > period) {
+		nextFrame = now;
+		hasNextFrame = true;
+	}
+	waitUntil(nextFrame, MAX_SPIN_FRACTION / targetFps);
+	nextFrame += period;
+}
+
+// wait for seconds (sleep, then spin)
+void FramePacer::wait(double seconds) {
+	waitUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)),
+		MAX_SPIN_FRACTION * seconds);
+}
+
+// return the mode's name ("uncapped", "vsync", "fps" or "idle")
+const char* FramePacer::getModeName(PacingMode mode) {
+	switch (mode) {
+		case PacingMode::UNCAPPED:
+			return "uncapped";
+		case PacingMode::VSYNC:
+			return "vsync";
+		case PacingMode::TARGET_FPS:
+			return "fps";
+		case PacingMode::IDLE:
+			return "idle";
+	}
+	return "";
+}
+
+// set mode from its name
+//   return false if name isn't a mode's name.
+bool FramePacer::parseMode(const std::string& name, PacingMode& mode) {
+	for (PacingMode candidate : { PacingMode::UNCAPPED, PacingMode::VSYNC, PacingMode::TARGET_FPS, PacingMode::IDLE }) {
+		if (name == getModeName(candidate)) {
+			mode = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+// return the mode after mode (for cycling through them)
+PacingMode FramePacer::getNextMode(PacingMode mode) {
+	switch (mode) {
+		case PacingMode::UNCAPPED:
+			return PacingMode::VSYNC;
+		case PacingMode::VSYNC:
+			return PacingMode::TARGET_FPS;
+		case PacingMode::TARGET_FPS:
+			return PacingMode::IDLE;
+		case PacingMode::IDLE:
+			return PacingMode::UNCAPPED;
+	}
+	return PacingMode::VSYNC;
+}
+
+// wait until deadline (sleep, then spin for at most maxSpinSeconds)
+void FramePacer::waitUntil(Clock::time_point deadline, double maxSpinSeconds) {
+	while (true) {
+		Clock::time_point now{ Clock::now() };
+		double remaining{ std::chrono::duration<double>(deadline - now).count() };
+		if (remaining <= 0.0) {
+			return;
+		}
+		if (remaining > MIN_SLEEP_SECONDS + sleepOvershoot || remaining > maxSpinSeconds) {
+			// sleep until the sleep's expected overshoot before the deadline (or,
+			// if that's too soon, briefly: spinning the rest would cost too much)
+			double asked{ std::max(remaining - sleepOvershoot, MIN_SLEEP_SECONDS) };
+			std::this_thread::sleep_for(std::chrono::duration<double>(asked));
+			// learn how long sleeps really take: move quickly towards a longer
+			// overshoot, drift back down slowly (so one late wakeup doesn't
+			// make us spin for ages)
+			double overshoot{ std::chrono::duration<double>(Clock::now() - now).count() - asked };
+			sleepOvershoot += (overshoot - sleepOvershoot) * (overshoot > sleepOvershoot ? 0.5 : 0.01);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,90 @@
+// The FramePacer class decides how fast the main loop runs. A game of tetris
+// changes a few times a second, so rendering flat out just burns a core.
+// The modes are:
+//   - UNCAPPED:   no pacing at all (for measuring the renderer)
+//   - VSYNC:      the window waits for the display's refresh (see main.cpp)
+//   - TARGET_FPS: frames start every 1/targetFps seconds, timed by the pacer
+//   - IDLE:       a frame only happens when there is input or the game has
+//                 changed (a tick, a bot move); in between the main loop
+//                 waits for a change (see main.cpp & TetrisGame::waitForChange())
+//
+// Waiting is "sleep, then spin": the pacer sleeps until shortly before the
+// deadline, and spins (yielding) for the last stretch, which a sleep could
+// overshoot. How far a sleep overshoots depends on the OS timer (about 15ms on
+// a default Windows timer, well under 1ms elsewhere), so the pacer measures
+// its own sleeps and only spins for as long as it has to. A wait never spins
+// for more than a quarter of it (MAX_SPIN_FRACTION), though: where a sleep
+// overshoots by more than that (1ms periods, like the simulation thread's
+// steps, on a coarse OS timer) the pacer sleeps anyway and is a little late,
+// rather than burn a core to be on time. On Windows a pacer also raises the
+// OS timer's resolution to 1ms while it exists (timeBeginPeriod()), or every
+// sleep would take at least 15ms.
+//
+// It knows nothing about SFML, so it can be tested headless.
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <string>
+
+enum class PacingMode
+{
+	UNCAPPED,
+	VSYNC,
+	TARGET_FPS,
+	IDLE,
+};
+
+class FramePacer
+{
+public:
+	// constructor, start in mode, at targetFps for TARGET_FPS
+	explicit FramePacer(PacingMode mode = PacingMode::VSYNC, double targetFps = 60.0);
+
+	// destructor, restore the OS timer's resolution (Windows)
+	~FramePacer();
+
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+
+	PacingMode getMode() const { return mode; }
+	void setMode(PacingMode mode);
+	double getTargetFps() const { return targetFps; }
+	void setTargetFps(double targetFps);
+
+	// in TARGET_FPS mode wait until the next frame is due,
+	// in any other mode return at once
+	void waitForNextFrame();
+
+	// wait for seconds (sleep, then spin)
+	void wait(double seconds);
+
+	// how much longer than asked a sleep is currently expected to take
+	double getSleepOvershoot() const { return sleepOvershoot; }
+
+	// return the mode's name ("uncapped", "vsync", "fps" or "idle")
+	static const char* getModeName(PacingMode mode);
+
+	// set mode from its name
+	//   return false if name isn't a mode's name.
+	static bool parseMode(const std::string& name, PacingMode& mode);
+
+	// return the mode after mode (for cycling through them)
+	static PacingMode getNextMode(PacingMode mode);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	// wait until deadline (sleep, then spin for at most maxSpinSeconds)
+	void waitUntil(Clock::time_point deadline, double maxSpinSeconds);
+
+	// MEMBER VARIABLES
+	PacingMode mode;
+	double targetFps;
+	Clock::time_point nextFrame;		// when the next frame is due (TARGET_FPS)
+	bool hasNextFrame = false;			// false until the first frame is paced
+	double sleepOvershoot = 0.001;		// seconds a sleep overshoots (measured)
+};
+
+#endif /* FRAMEPACER_H */
@@ -0,0 +1,89 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <assert.h>
+
+// the upper bounds of the histogram buckets (milliseconds): a 60 fps frame
+// is 16.7ms, so the buckets are finest below that
+static const double BUCKET_MS[FrameProfiler::HISTOGRAM_BUCKETS] = { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 12.0, 17.0, 33.0, 1e9 };
+
+// return the stats of phase's recent times (any thread)
+PhaseStats FrameProfiler::getStats(ProfilePhase phase) const {
+	std::uint32_t times[RING_SIZE];
+	std::uint32_t allocations[RING_SIZE];
+	PhaseStats stats;
+	stats.samples = copySamples(phase, times, allocations);
+	if (stats.samples == 0) {
+		return stats;
+	}
+	double totalAllocations{ 0.0 };
+	for (int i{ 0 }; i < stats.samples; i++) {
+		totalAllocations += allocations[i];
+		stats.maxAllocations = std::max(stats.maxAllocations, static_cast<int>(allocations[i]));
+	}
+	stats.meanAllocations = totalAllocations / stats.samples;
+	// the percentiles by partial sorts (the 99th first: it partitions
+	// the times so the 50th only needs to search below it)
+	std::uint32_t* end{ times + stats.samples };
+	std::uint32_t* p99{ times + (stats.samples - 1) * 99 / 100 };
+	std::uint32_t* p50{ times + (stats.samples - 1) / 2 };
+	std::nth_element(times, p99, end);
+	std::nth_element(times, p50, p99);
+	stats.p50Ms = *p50 * 1e-6;
+	stats.p99Ms = *p99 * 1e-6;
+	stats.maxMs = *std::max_element(p99, end) * 1e-6;
+	return stats;
+}
+
+// count phase's recent times into histogram buckets (any thread):
+// bucket i counts times up to getHistogramBucketMs(i)
+void FrameProfiler::getHistogram(ProfilePhase phase, int counts[HISTOGRAM_BUCKETS]) const {
+	std::uint32_t times[RING_SIZE];
+	int count{ copySamples(phase, times) };
+	std::fill(counts, counts + HISTOGRAM_BUCKETS, 0);
+	for (int i{ 0 }; i < count; i++) {
+		double ms{ times[i] * 1e-6 };
+		int bucket{ 0 };
+		while (bucket < HISTOGRAM_BUCKETS - 1 && ms > BUCKET_MS[bucket]) {
+			bucket++;
+		}
+		counts[bucket]++;
+	}
+}
+
+// the upper bound of histogram bucket i in milliseconds (the last is unbounded)
+double FrameProfiler::getHistogramBucketMs(int bucket) {
+	assert(bucket >= 0 && bucket < HISTOGRAM_BUCKETS);
+	return BUCKET_MS[bucket];
+}
+
+// return the phase's name ("events", "draw", ...)
+const char* FrameProfiler::getPhaseName(ProfilePhase phase) {
+	switch (phase) {
+		case ProfilePhase::EVENTS: return "events";
+		case ProfilePhase::DRAW: return "draw";
+		case ProfilePhase::DRAW_BOARD: return "draw board";
+		case ProfilePhase::DISPLAY: return "display";
+		case ProfilePhase::FRAME: return "frame";
+		case ProfilePhase::GAME_LOOP: return "game loop";
+		case ProfilePhase::TICK: return "tick";
+		case ProfilePhase::INPUT_LATENCY: return "input";
+		default: return "?";
+	}
+}
+
+// copy phase's recent times (in nanoseconds) into times
+// (and, if allocations isn't nullptr, their allocation counts into allocations)
+//   return the number copied.
+int FrameProfiler::copySamples(ProfilePhase phase, std::uint32_t times[RING_SIZE], std::uint32_t* allocations) const {
+	int index{ static_cast<int>(phase) };
+	assert(index >= 0 && index < PHASE_COUNT);
+	std::uint32_t count{ written[index].load(std::memory_order_acquire) };
+	int copied{ static_cast<int>(std::min<std::uint32_t>(count, RING_SIZE)) };
+	for (int i{ 0 }; i < copied; i++) {
+		times[i] = samples[index][i].load(std::memory_order_relaxed);
+		if (allocations) {
+			allocations[i] = allocationSamples[index][i].load(std::memory_order_relaxed);
+		}
+	}
+	return copied;
+}
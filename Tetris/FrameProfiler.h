@@ -0,0 +1,124 @@
+// The FrameProfiler class times the phases of a frame (and of the simulation
+// step) so spikes can be traced to the phase they came from.
+//
+// A ProfileTimer on the stack times one run of a phase, from its construction
+// to its destruction, and records it in the phase's ring buffer: the last
+// RING_SIZE times, overwritten oldest first. Recording is a clock read and two
+// relaxed atomic stores, and never waits; the overlay (on the window thread)
+// reads the rings while they are being written. That is safe because:
+//   - each phase is only ever timed on one thread (the window thread times
+//     EVENTS, DRAW, DRAW_BOARD, DISPLAY, FRAME and INPUT_LATENCY; the simulation thread
+//     GAME_LOOP and TICK), so every ring has a single writer,
+//   - the samples are atomics, so a reader never sees a torn one (at worst it
+//     sees a few samples newer than the rest, which doesn't matter for stats).
+//
+// Each sample also records how many allocations the phase made (see
+// AllocationCounter), so the overlay can show which phases allocate.
+//
+// It knows nothing about SFML (see ProfilerOverlay for the drawing), so it can
+// be tested headless.
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "AllocationCounter.h"
+
+// the phases that are timed
+enum class ProfilePhase
+{
+	EVENTS,			// main.cpp: polling the window's events
+	DRAW,			// TetrisGame::draw()
+	DRAW_BOARD,		// TetrisGame::drawGameboard() (part of DRAW)
+	DISPLAY,		// main.cpp: window.display()
+	FRAME,			// main.cpp: a whole pass of the main loop
+	GAME_LOOP,		// TetrisGame::processGameLoop() (simulation thread)
+	TICK,			// TetrisGame::tick() (part of GAME_LOOP)
+	INPUT_LATENCY,	// main.cpp: a key press to the display of its effect (see LatencyProbe)
+	COUNT,			// (the number of phases)
+};
+
+// a phase's recent times, in milliseconds
+struct PhaseStats
+{
+	int samples = 0;			// how many times the stats are taken from
+	double p50Ms = 0.0;
+	double p99Ms = 0.0;
+	double maxMs = 0.0;
+	double meanAllocations = 0.0;	// allocations per run of the phase
+	int maxAllocations = 0;
+};
+
+class FrameProfiler
+{
+public:
+	static const int PHASE_COUNT = static_cast<int>(ProfilePhase::COUNT);
+	static const int RING_SIZE = 1024;			// times kept per phase
+	static const int HISTOGRAM_BUCKETS = 10;	// see getHistogramBucketMs()
+
+	// record that phase took nanoseconds and made allocations (on the phase's thread)
+	void record(ProfilePhase phase, std::uint32_t nanoseconds, std::uint32_t allocations = 0) {
+		int index{ static_cast<int>(phase) };
+		std::uint32_t count{ written[index].load(std::memory_order_relaxed) };
+		samples[index][count % RING_SIZE].store(nanoseconds, std::memory_order_relaxed);
+		allocationSamples[index][count % RING_SIZE].store(allocations, std::memory_order_relaxed);
+		written[index].store(count + 1, std::memory_order_release);
+	}
+
+	// return the stats of phase's recent times (any thread)
+	PhaseStats getStats(ProfilePhase phase) const;
+
+	// count phase's recent times into histogram buckets (any thread):
+	// bucket i counts times up to getHistogramBucketMs(i)
+	void getHistogram(ProfilePhase phase, int counts[HISTOGRAM_BUCKETS]) const;
+
+	// the upper bound of histogram bucket i in milliseconds (the last is unbounded)
+	static double getHistogramBucketMs(int bucket);
+
+	// return the phase's name ("events", "draw", ...)
+	static const char* getPhaseName(ProfilePhase phase);
+
+private:
+	// copy phase's recent times (in nanoseconds) into times
+	// (and, if allocations isn't nullptr, their allocation counts into allocations)
+	//   return the number copied.
+	int copySamples(ProfilePhase phase, std::uint32_t times[RING_SIZE], std::uint32_t* allocations = nullptr) const;
+
+	// MEMBER VARIABLES
+	std::atomic<std::uint32_t> samples[PHASE_COUNT][RING_SIZE] = {};
+	std::atomic<std::uint32_t> allocationSamples[PHASE_COUNT][RING_SIZE] = {};
+	std::atomic<std::uint32_t> written[PHASE_COUNT] = {};		// times recorded (ever) per phase
+};
+
+// times a phase from construction to destruction (does nothing without a profiler)
+class ProfileTimer
+{
+public:
+	ProfileTimer(FrameProfiler* pProfiler, ProfilePhase phase) : pProfiler{ pProfiler }, phase{ phase } {
+		if (pProfiler) {
+			allocationsAtStart = AllocationCounter::getThreadCount();
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	~ProfileTimer() {
+		if (pProfiler) {
+			auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			pProfiler->record(phase, nanoseconds < UINT32_MAX ? static_cast<std::uint32_t>(nanoseconds) : UINT32_MAX,
+				static_cast<std::uint32_t>(AllocationCounter::getThreadCount() - allocationsAtStart));
+		}
+	}
+
+	ProfileTimer(const ProfileTimer&) = delete;
+	ProfileTimer& operator=(const ProfileTimer&) = delete;
+
+private:
+	FrameProfiler* pProfiler;
+	ProfilePhase phase;
+	std::chrono::steady_clock::time_point start;
+	std::uint64_t allocationsAtStart = 0;
+};
+
+#endif /* FRAMEPROFILER_H */
@@ -31,6 +31,7 @@ void Gameboard::setContent(Point pt, int content)
 	assert(pt.getX() >= 0 && pt.getX() < MAX_X
 		&& pt.getY() >= 0 && pt.getY() < MAX_Y);
 	grid[pt.getX()][pt.getY()] = content;
+	generation++;
 }
 
 // set the content at an x,y grid loc
@@ -39,18 +40,26 @@ void Gameboard::setContent(int x, int y, int content)
 	assert(x >= 0 && x < MAX_X
 		&& y >= 0 && y < MAX_Y);
 	grid[x][y] = content;
+	generation++;
 }
 
 
 // set the content for an array of grid locs
-void Gameboard::setContent(std::vector<Point> locs, int content)
+void Gameboard::setContent(const std::vector<Point>& locs, int content)
 {
-	for (int i{ 0 }; i < static_cast<int>(locs.size()); i++)
+	setContent(locs.data(), static_cast<int>(locs.size()), content);
+}
+
+// set the content for count grid locs (without needing a vector)
+void Gameboard::setContent(const Point locs[], int count, int content)
+{
+	for (int i{ 0 }; i < count; i++)
 	{
 		assert(locs[i].getX() >= 0 && locs[i].getX() < MAX_X
 			&& locs[i].getY() >= 0 && locs[i].getY() < MAX_Y);
 		grid[locs[i].getX()][locs[i].getY()] = content;
 	}
+	generation++;
 }
 
 
@@ -62,10 +71,16 @@ void Gameboard::setContent(std::vector<Point> locs, int content)
 //   don't use them to index into the grid).  Testing invalid points
 //   would likely result in an out of bounds error or segmentation fault!
 //   If no points are valid, return true
-bool Gameboard::areLocsEmpty(std::vector<Point> locs) const
+bool Gameboard::areLocsEmpty(const std::vector<Point>& locs) const
+{
+	return areLocsEmpty(locs.data(), static_cast<int>(locs.size()));
+}
+
+// the same for count grid locs (without needing a vector)
+bool Gameboard::areLocsEmpty(const Point locs[], int count) const
 {
 	bool allValid = true;
-	for (int i{ 0 }; i < static_cast<int>(locs.size()); i++)
+	for (int i{ 0 }; i < count; i++)
 	{
 		// If point is valid
 		if (locs[i].getX() >= 0 && locs[i].getX() < MAX_X &&
@@ -81,13 +96,28 @@ bool Gameboard::areLocsEmpty(std::vector<Point> locs) const
 }
 
 // removes all completed rows from the board
-//   use getCompletedRowIndices() and removeRows() 
+//   (scans the rows itself rather than collecting them with
+//   getCompletedRowIndices(), so that locking a shape doesn't allocate)
 //   return the # of completed rows removed
 int Gameboard::removeCompletedRows()
 {
-	std::vector<int> fullRows { getCompletedRowIndices() };
-	removeRows(fullRows);
-	return fullRows.size();
+	// bottom up: a removed row is replaced by the one above it,
+	// so the same row index is checked again
+	int removed{ 0 };
+	int y{ MAX_Y - 1 };
+	while (y >= 0)
+	{
+		if (isRowCompleted(y))
+		{
+			removeRow(y);
+			removed++;
+		}
+		else
+		{
+			y--;
+		}
+	}
+	return removed;
 }
 
 
@@ -109,6 +139,23 @@ Point Gameboard::getSpawnLoc() const
 }
 
 
+// return true if other has the same content at every grid loc
+bool Gameboard::operator==(const Gameboard& other) const
+{
+	for (int x{ 0 }; x < MAX_X; x++)
+	{
+		for (int y{ 0 }; y < MAX_Y; y++)
+		{
+			if (grid[x][y] != other.grid[x][y])
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
 // print the grid contents to the console (for debugging purposes)
 //   use std::setw(2) to space the contents out (#include <iomanip>).
 void Gameboard::printToConsole() const
@@ -180,7 +227,7 @@ void Gameboard::removeRow(int rowIndex)
 // given a vector of row indices, remove them 
 //   (iterate through the vector and and call removeRow()
 //   on each row index). 
-void Gameboard::removeRows(std::vector<int> rowIndices)
+void Gameboard::removeRows(const std::vector<int>& rowIndices)
 {
 	for (int i{ 0 }; i < static_cast<int>(rowIndices.size()); i++)
 	{
@@ -196,6 +243,7 @@ void Gameboard::fillRow(int rowIndex, int content)
 	{
 		grid[i][rowIndex] = content;
 	}
+	generation++;
 }
 
 
@@ -206,4 +254,5 @@ void Gameboard::copyRowIntoRow(int sourceRowIndex, int targetRowIndex)
 	{
 		grid[i][targetRowIndex] = grid[i][sourceRowIndex];
 	}
+	generation++;
 }
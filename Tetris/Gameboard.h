@@ -78,7 +78,9 @@ public:
 	void setContent(int x, int y, int content);	
 	
 	// set the content for an array of grid locs
-	void setContent(std::vector<Point> locs, int content);	
+	void setContent(const std::vector<Point>& locs, int content);	
+	// set the content for count grid locs (without needing a vector)
+	void setContent(const Point locs[], int count, int content);
 
 	
 	// return true if the content at ALL (valid) points is empty
@@ -88,10 +90,13 @@ public:
 	//   don't use them to index into the grid).  Testing invalid points
 	//   would likely result in an out of bounds error or segmentation fault!
 	//   If no points are valid, return true
-	bool areLocsEmpty(std::vector<Point> locs) const;
+	bool areLocsEmpty(const std::vector<Point>& locs) const;
+	// the same for count grid locs (without needing a vector)
+	bool areLocsEmpty(const Point locs[], int count) const;
 												
 	// removes all completed rows from the board
-	//   use getCompletedRowIndices() and removeRows() 
+	//   (scans the rows itself rather than collecting them with
+	//   getCompletedRowIndices(), so that locking a shape doesn't allocate)
 	//   return the # of completed rows removed
 	int removeCompletedRows();			
 												
@@ -101,6 +106,13 @@ public:
 												
 	// getter for the spawnLoc for new blocks
 	Point getSpawnLoc() const;					
+
+	// return a number that changes whenever the content of the grid changes
+	//   (so a renderer can tell if what it drew last time is still current)
+	unsigned long long getGeneration() const { return generation; }
+
+	// return true if other has the same content at every grid loc
+	bool operator==(const Gameboard& other) const;
 	
 	// print the grid contents to the console (for debugging purposes)
 	//   use std::setw(2) to space the contents out (#include <iomanip>).
@@ -132,7 +144,7 @@ private:
 	// given a vector of row indices, remove them 
 	//   (iterate through the vector and and call removeRow()
 	//   on each row index). 
-	void removeRows(std::vector<int> rowIndices); 
+	void removeRows(const std::vector<int>& rowIndices); 
 
 	// fill a given grid row with specified content
 	void fillRow(int rowIndex, int content);	
@@ -147,7 +159,9 @@ private:
 	//  ([0][0] is top left, [MAX_X][MAX_Y] is bottom right) 
 	int grid[MAX_X][MAX_Y];				 
 	// the gameboard offset to spawn a new tetromino at.
-	const Point spawnLoc {MAX_X/2, 0};		
+	Point spawnLoc {MAX_X/2, 0};		
+	// bumped by every change to the grid (see getGeneration())
+	unsigned long long generation = 0;
 
 	// FRIENDS
 // for testing purposes (allows TestSuite to access private members of this class)
@@ -0,0 +1,105 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+
+// the space left around each glyph in the atlas (and added around each quad,
+// as sf::Text does, so filtering doesn't cut the glyph's edges)
+static const int GLYPH_PADDING = 1;
+
+// build the atlas from tiles and the glyphs of characters in font at characterSize
+//   return false if the texture couldn't be created.
+bool GlyphAtlas::create(const sf::Image& tiles, const sf::Font& font, unsigned int characterSize, const char* characters) {
+	this->characterSize = characterSize;
+	for (Glyph& glyph : glyphs) {
+		glyph = Glyph();
+	}
+	std::memset(kerning, 0, sizeof(kerning));
+	spaceAdvance = font.getGlyph(L' ', characterSize, false).advance;
+
+	// loading the glyphs renders them into the font's own texture...
+	int count{ static_cast<int>(std::strlen(characters)) };
+	unsigned int rowWidth{ 0 };
+	unsigned int rowHeight{ 0 };
+	for (int i{ 0 }; i < count; i++) {
+		const sf::Glyph& glyph{ font.getGlyph(static_cast<unsigned char>(characters[i]), characterSize, false) };
+		rowWidth += glyph.textureRect.width + 2 * GLYPH_PADDING;
+		rowHeight = std::max(rowHeight, static_cast<unsigned int>(glyph.textureRect.height + 2 * GLYPH_PADDING));
+	}
+
+	// ...from which they are copied (once) below the tiles
+	sf::Image fontImage{ font.getTexture(characterSize).copyToImage() };
+	sf::Image atlas;
+	atlas.create(std::max(tiles.getSize().x, rowWidth), tiles.getSize().y + rowHeight, sf::Color::Transparent);
+	atlas.copy(tiles, 0, 0);
+	unsigned int left{ 0 };
+	unsigned int top{ tiles.getSize().y };
+	for (int i{ 0 }; i < count; i++) {
+		unsigned char character{ static_cast<unsigned char>(characters[i]) };
+		if (character >= 128) {
+			continue;
+		}
+		const sf::Glyph& fontGlyph{ font.getGlyph(character, characterSize, false) };
+		sf::IntRect source{ fontGlyph.textureRect.left - GLYPH_PADDING, fontGlyph.textureRect.top - GLYPH_PADDING,
+			fontGlyph.textureRect.width + 2 * GLYPH_PADDING, fontGlyph.textureRect.height + 2 * GLYPH_PADDING };
+		atlas.copy(fontImage, left, top, source);
+
+		Glyph& glyph{ glyphs[character] };
+		glyph.isBaked = true;
+		glyph.advance = fontGlyph.advance;
+		glyph.bounds = fontGlyph.bounds;
+		glyph.textureRect = sf::FloatRect(static_cast<float>(left + GLYPH_PADDING), static_cast<float>(top + GLYPH_PADDING),
+			static_cast<float>(fontGlyph.textureRect.width), static_cast<float>(fontGlyph.textureRect.height));
+		left += source.width;
+	}
+	for (int i{ 0 }; i < count; i++) {
+		for (int j{ 0 }; j < count; j++) {
+			unsigned char previous{ static_cast<unsigned char>(characters[i]) };
+			unsigned char current{ static_cast<unsigned char>(characters[j]) };
+			if (previous < 128 && current < 128) {
+				kerning[previous][current] = font.getKerning(previous, current, characterSize);
+			}
+		}
+	}
+	return texture.loadFromImage(atlas);
+}
+
+// append the quads of text to quads, with its top left at position
+// (as sf::Text::setPosition() would place it).
+//   characters that weren't baked are skipped.
+void GlyphAtlas::appendText(std::vector<sf::Vertex>& quads, const char* text, sf::Vector2f position, sf::Color color) const {
+	// sf::Text puts the baseline a character size below the top
+	float x{ position.x };
+	float y{ position.y + characterSize };
+	const float padding{ static_cast<float>(GLYPH_PADDING) };
+	unsigned char previous{ 0 };
+	for (const char* c{ text }; *c; c++) {
+		unsigned char character{ static_cast<unsigned char>(*c) };
+		if (character >= 128) {
+			continue;
+		}
+		x += kerning[previous][character];
+		previous = character;
+		if (character == ' ') {
+			x += spaceAdvance;
+			continue;
+		}
+		const Glyph& glyph{ glyphs[character] };
+		if (!glyph.isBaked) {
+			continue;
+		}
+		float left{ x + glyph.bounds.left - padding };
+		float top{ y + glyph.bounds.top - padding };
+		float right{ x + glyph.bounds.left + glyph.bounds.width + padding };
+		float bottom{ y + glyph.bounds.top + glyph.bounds.height + padding };
+		float u1{ glyph.textureRect.left - padding };
+		float v1{ glyph.textureRect.top - padding };
+		float u2{ glyph.textureRect.left + glyph.textureRect.width + padding };
+		float v2{ glyph.textureRect.top + glyph.textureRect.height + padding };
+		quads.push_back(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1)));
+		quads.push_back(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+		quads.push_back(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2)));
+		quads.push_back(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+		x += glyph.advance;
+	}
+}
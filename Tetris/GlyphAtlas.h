@@ -0,0 +1,49 @@
+// The GlyphAtlas class puts the block tiles and a font's glyphs into one
+// texture, so blocks and text can be drawn in the same draw call.
+//
+// The tile image is copied to the top left of the atlas (so tile texture
+// coordinates don't change) and the glyphs of the given characters are baked
+// in a row below it, once, when the atlas is created. appendText() then lays
+// out a string as textured quads the way sf::Text does (same glyph bounds,
+// advances, kerning and padding) without any allocation or re-layout by SFML.
+
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+class GlyphAtlas
+{
+public:
+	// build the atlas from tiles and the glyphs of characters in font at characterSize
+	//   return false if the texture couldn't be created.
+	bool create(const sf::Image& tiles, const sf::Font& font, unsigned int characterSize, const char* characters);
+
+	// the atlas (tiles at the top left, glyphs below them)
+	const sf::Texture& getTexture() const { return texture; }
+
+	// append the quads of text to quads, with its top left at position
+	// (as sf::Text::setPosition() would place it).
+	//   characters that weren't baked are skipped.
+	void appendText(std::vector<sf::Vertex>& quads, const char* text, sf::Vector2f position, sf::Color color) const;
+
+private:
+	// a baked glyph
+	struct Glyph
+	{
+		bool isBaked = false;
+		float advance = 0.0f;
+		sf::FloatRect bounds;			// relative to the baseline (as sf::Glyph::bounds)
+		sf::FloatRect textureRect;		// in the atlas
+	};
+
+	// MEMBER VARIABLES
+	sf::Texture texture;
+	unsigned int characterSize = 0;
+	Glyph glyphs[128];					// by (ASCII) character
+	float kerning[128][128];			// kerning[previous][current], 0 if not baked
+	float spaceAdvance = 0.0f;			// the width of a ' '
+};
+
+#endif /* GLYPHATLAS_H */
@@ -37,13 +37,14 @@ void GridTetromino::move(int xOffset, int yOffset)
 	gridLoc.setXY(gridLoc.getX() + xOffset, gridLoc.getY() + yOffset);
 }
 
-// build and return a vector of Points to represent our inherited
-// blockLocs vector mapped to the gridLoc of this object instance.
-// eg: if we have a Point [x,y] in our vector,
+// build and return a list of Points to represent our inherited
+// blockLocs mapped to the gridLoc of this object instance.
+// eg: if we have a Point [x,y] in our list,
 // and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
-std::vector<Point> GridTetromino::getBlockLocsMappedToGrid() const
+//   (a BlockLocs rather than a std::vector, so this doesn't allocate)
+BlockLocs GridTetromino::getBlockLocsMappedToGrid() const
 {
-	std::vector<Point> LocsOnGrid{};
+	BlockLocs LocsOnGrid{};
 	int x{ gridLoc.getX() };
 	int y{ gridLoc.getY() };
 	for (int i{ 0 }; i < int(blockLocs.size()); i++) {
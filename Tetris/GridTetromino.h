@@ -30,11 +30,12 @@ public:
 	//	(0,1) represents a move down (y+1)
 	void move(int xOffset, int yOffset);	
 
-	// build and return a vector of Points to represent our inherited
-	// blockLocs vector mapped to the gridLoc of this object instance.
-	// eg: if we have a Point [x,y] in our vector,
+	// build and return a list of Points to represent our inherited
+	// blockLocs mapped to the gridLoc of this object instance.
+	// eg: if we have a Point [x,y] in our list,
 	// and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
-	std::vector<Point> getBlockLocsMappedToGrid() const;
+	//   (a BlockLocs rather than a std::vector, so this doesn't allocate)
+	BlockLocs getBlockLocsMappedToGrid() const;
 
 
 	// MEMBER VARIABLES
@@ -0,0 +1,68 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+// add every duration in other
+void LatencyHistogram::add(const LatencyHistogram& other) {
+	for (int i{ 0 }; i < BUCKET_COUNT; i++) {
+		counts[i] += other.counts[i];
+	}
+	count += other.count;
+	totalNs += other.totalNs;
+	maxNs = std::max(maxNs, other.maxNs);
+}
+
+// forget every duration
+void LatencyHistogram::clear() {
+	std::fill(counts, counts + BUCKET_COUNT, 0);
+	count = 0;
+	totalNs = 0;
+	maxNs = 0;
+}
+
+// return the duration percentile percent (0 - 100) of the durations are within
+// (the upper bound of its bucket), 0 if there are none
+double LatencyHistogram::getPercentileNs(double percent) const {
+	if (count == 0) {
+		return 0.0;
+	}
+	// the rank of the duration wanted (1 = the shortest; allowing for rounding,
+	// so 99.9% of 1000 is 999, not 1000)
+	std::uint64_t rank{ static_cast<std::uint64_t>(std::ceil(percent / 100.0 * count - 1e-9)) };
+	rank = std::max<std::uint64_t>(1, std::min(rank, count));
+	std::uint64_t seen{ 0 };
+	for (int i{ 0 }; i < BUCKET_COUNT; i++) {
+		seen += counts[i];
+		if (seen >= rank) {
+			return static_cast<double>(std::min(getBucketMaxNs(i), maxNs));
+		}
+	}
+	return static_cast<double>(maxNs);
+}
+
+// return the bucket of a duration
+int LatencyHistogram::getBucket(std::uint64_t nanoseconds) {
+	if (nanoseconds < SUB_BUCKETS) {
+		return static_cast<int>(nanoseconds);
+	}
+	// the doubling it is in (its top bit), then which part of it
+	int exponent{ 3 };
+	while (exponent < 63 && (nanoseconds >> (exponent + 1)) != 0) {
+		exponent++;
+	}
+	int bucket{ (exponent - 2) * SUB_BUCKETS + static_cast<int>((nanoseconds >> (exponent - 3)) & (SUB_BUCKETS - 1)) };
+	return std::min(bucket, BUCKET_COUNT - 1);
+}
+
+// return the largest duration in bucket
+std::uint64_t LatencyHistogram::getBucketMaxNs(int bucket) {
+	if (bucket < SUB_BUCKETS) {
+		return static_cast<std::uint64_t>(bucket);
+	}
+	if (bucket == BUCKET_COUNT - 1) {
+		return UINT64_MAX;		// (also holds everything longer)
+	}
+	int exponent{ bucket / SUB_BUCKETS + 2 };
+	std::uint64_t width{ std::uint64_t{ 1 } << (exponent - 3) };
+	return (std::uint64_t{ 1 } << exponent) + (bucket % SUB_BUCKETS + 1) * width - 1;
+}
@@ -0,0 +1,60 @@
+// The LatencyHistogram counts durations into logarithmic buckets, so the
+// percentiles of any number of them (millions of ticks over a long session)
+// can be kept in a fixed array, without allocating or sorting.
+//
+// Durations below 8ns get a bucket each; above that every doubling is split
+// into SUB_BUCKETS buckets, so a bucket is at most 1/8 (12.5%) as wide as the
+// durations in it. A percentile is reported as the upper bound of its bucket
+// (never more than the largest duration), so it is at most that much high.
+// The largest duration and the mean are exact.
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+
+class LatencyHistogram
+{
+public:
+	static const int SUB_BUCKETS = 8;							// buckets per doubling
+	static const int BUCKET_COUNT = SUB_BUCKETS * 34;			// up to 2^36ns (about a minute)
+
+	// add a duration
+	void add(std::uint64_t nanoseconds) {
+		counts[getBucket(nanoseconds)]++;
+		count++;
+		totalNs += nanoseconds;
+		if (nanoseconds > maxNs) {
+			maxNs = nanoseconds;
+		}
+	}
+
+	// add every duration in other
+	void add(const LatencyHistogram& other);
+
+	// forget every duration
+	void clear();
+
+	std::uint64_t getCount() const { return count; }
+	std::uint64_t getMaxNs() const { return maxNs; }
+	double getMeanNs() const { return count > 0 ? static_cast<double>(totalNs) / count : 0.0; }
+
+	// return the duration percentile percent (0 - 100) of the durations are within
+	// (the upper bound of its bucket), 0 if there are none
+	double getPercentileNs(double percent) const;
+
+private:
+	// return the bucket of a duration
+	static int getBucket(std::uint64_t nanoseconds);
+
+	// return the largest duration in bucket
+	static std::uint64_t getBucketMaxNs(int bucket);
+
+	// MEMBER VARIABLES
+	std::uint64_t counts[BUCKET_COUNT] = {};
+	std::uint64_t count = 0;
+	std::uint64_t totalNs = 0;
+	std::uint64_t maxNs = 0;
+};
+
+#endif /* LATENCYHISTOGRAM_H */
@@ -0,0 +1,82 @@
+#include "LatencyProbe.h"
+#include <algorithm>
+#include <assert.h>
+#include <cstdio>
+
+// the upper bounds of the histogram buckets (milliseconds): at 60 fps a key
+// can't be shown sooner than the next frame, so most inputs land between one
+// and three frames (16.7 - 50ms)
+static const double BUCKET_MS[LatencyProbe::HISTOGRAM_BUCKETS] = { 8.0, 12.0, 17.0, 25.0, 33.0, 42.0, 50.0, 67.0, 100.0, 1e9 };
+
+// a key press was polled at time
+//   return the id to tag it with (never 0).
+unsigned int LatencyProbe::onInput(Clock::time_point time) {
+	lastInput++;
+	polled[lastInput % MAX_PENDING] = time;
+	return lastInput;
+}
+
+// a frame showing every input up to inputId was displayed at time:
+// time the inputs not timed yet
+//   return the number of inputs timed.
+int LatencyProbe::onFrameDisplayed(unsigned int inputId, Clock::time_point time) {
+	assert(inputId <= lastInput);
+	if (inputId <= lastTimed) {
+		return 0;
+	}
+	// (inputs that have had their slot taken by a newer one are dropped)
+	unsigned int first{ std::max(lastTimed + 1, lastInput >= MAX_PENDING ? lastInput - MAX_PENDING + 1 : 1u) };
+	int timed{ 0 };
+	for (unsigned int id{ first }; id <= inputId; id++) {
+		auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time - polled[id % MAX_PENDING]).count();
+		double ms{ nanoseconds * 1e-6 };
+		int bucket{ 0 };
+		while (bucket < HISTOGRAM_BUCKETS - 1 && ms > BUCKET_MS[bucket]) {
+			bucket++;
+		}
+		histogram[bucket]++;
+		count++;
+		totalMs += ms;
+		maxMs = std::max(maxMs, ms);
+		if (pProfiler) {
+			pProfiler->record(ProfilePhase::INPUT_LATENCY, nanoseconds < UINT32_MAX ? static_cast<std::uint32_t>(nanoseconds) : UINT32_MAX);
+		}
+		timed++;
+	}
+	lastTimed = inputId;
+	return timed;
+}
+
+// the number of inputs timed in histogram bucket i (each input goes in the
+// first bucket its latency fits)
+int LatencyProbe::getHistogramCount(int bucket) const {
+	assert(bucket >= 0 && bucket < HISTOGRAM_BUCKETS);
+	return histogram[bucket];
+}
+
+// the upper bound of histogram bucket i in milliseconds (the last is unbounded)
+double LatencyProbe::getHistogramBucketMs(int bucket) {
+	assert(bucket >= 0 && bucket < HISTOGRAM_BUCKETS);
+	return BUCKET_MS[bucket];
+}
+
+// return the histogram as text, a line per bucket with a bar of #s
+std::string LatencyProbe::getReport() const {
+	static const int BAR_WIDTH = 40;
+	char line[128];
+	std::snprintf(line, sizeof(line), "input latency: %d inputs, mean %.1fms, max %.1fms\n", count, getMeanMs(), maxMs);
+	std::string report{ line };
+	int most{ std::max(1, *std::max_element(histogram, histogram + HISTOGRAM_BUCKETS)) };
+	for (int i{ 0 }; i < HISTOGRAM_BUCKETS; i++) {
+		if (i < HISTOGRAM_BUCKETS - 1) {
+			std::snprintf(line, sizeof(line), "  <= %5.1fms %6d ", BUCKET_MS[i], histogram[i]);
+		}
+		else {
+			std::snprintf(line, sizeof(line), "   > %5.1fms %6d ", BUCKET_MS[i - 1], histogram[i]);
+		}
+		report += line;
+		report.append(histogram[i] * BAR_WIDTH / most, '#');
+		report += '\n';
+	}
+	return report;
+}
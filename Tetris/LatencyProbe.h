@@ -0,0 +1,75 @@
+// The LatencyProbe measures input-to-photon latency: the time from a key
+// press being polled to window.display() returning with the first frame that
+// shows what the key did. Frame times alone don't show that: a key waits for
+// the simulation thread to handle it, for the next frame to be drawn from the
+// resulting Snapshot, and for that frame to be displayed (see main.cpp).
+//
+// The window thread does all of it, so nothing here is shared:
+//   1) onInput() when a KeyPressed event is polled: it returns an id, which
+//      goes to the game with the key (TetrisGame::onKeyPressed()),
+//   2) the simulation thread notes the last id it has handled in the Snapshot
+//      it publishes (even if the key changed nothing), so a drawn frame knows
+//      which inputs it shows (TetrisGame::getDrawnInputId()),
+//   3) onFrameDisplayed() when display() returns: every input up to the
+//      frame's id is timed.
+// The latencies go to a FrameProfiler (the INPUT_LATENCY phase, so the
+// overlay shows their recent p50, p99 & max) and into a histogram of every
+// input since the start, for a report at the end of a measuring session.
+//
+// It knows nothing about SFML, so it can be tested headless.
+
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <chrono>
+#include <string>
+#include "FrameProfiler.h"
+
+class LatencyProbe
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const int MAX_PENDING = 64;			// inputs in flight at once (older ones aren't timed)
+	static const int HISTOGRAM_BUCKETS = 10;	// see getHistogramBucketMs()
+
+	// constructor, record the latencies in pProfiler too (unless it is nullptr)
+	explicit LatencyProbe(FrameProfiler* pProfiler = nullptr) : pProfiler{ pProfiler } {}
+
+	// a key press was polled at time
+	//   return the id to tag it with (never 0).
+	unsigned int onInput(Clock::time_point time = Clock::now());
+
+	// a frame showing every input up to inputId was displayed at time:
+	// time the inputs not timed yet
+	//   return the number of inputs timed.
+	int onFrameDisplayed(unsigned int inputId, Clock::time_point time = Clock::now());
+
+	// return the number of inputs timed, and the mean & max of their latencies
+	int getCount() const { return count; }
+	double getMeanMs() const { return count > 0 ? totalMs / count : 0.0; }
+	double getMaxMs() const { return maxMs; }
+
+	// the number of inputs timed in histogram bucket i (each input goes in the
+	// first bucket its latency fits)
+	int getHistogramCount(int bucket) const;
+
+	// the upper bound of histogram bucket i in milliseconds (the last is unbounded)
+	static double getHistogramBucketMs(int bucket);
+
+	// return the histogram as text, a line per bucket with a bar of #s
+	std::string getReport() const;
+
+private:
+	// MEMBER VARIABLES
+	FrameProfiler* pProfiler;
+	Clock::time_point polled[MAX_PENDING];	// when input id was polled (at id % MAX_PENDING)
+	unsigned int lastInput = 0;				// the last id handed out
+	unsigned int lastTimed = 0;				// inputs up to this id have been timed (or dropped)
+	int histogram[HISTOGRAM_BUCKETS] = {};
+	int count = 0;
+	double totalMs = 0.0;
+	double maxMs = 0.0;
+};
+
+#endif /* LATENCYPROBE_H */
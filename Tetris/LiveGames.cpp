@@ -0,0 +1,148 @@
+#include "LiveGames.h"
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+#include "Metrics.h"
+
+// how long a waiting worker sleeps at most before checking whether it should stop
+static const std::chrono::milliseconds MAX_SLEEP{ 20 };
+
+// constructor, gameCount games spread over threadCount workers
+// (0 means one per core), each placing piecesPerSecond (0 = flat out).
+// the games' seeds are seed, seed + 1, ...
+LiveGames::LiveGames(int gameCount, int threadCount, double piecesPerSecond, unsigned long long seed)
+	: piecesPerSecond{ piecesPerSecond } {
+	assert(gameCount > 0);
+	if (threadCount <= 0) {
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	this->threadCount = std::max(1, std::min(threadCount, gameCount));
+	for (int i{ 0 }; i < gameCount; i++) {
+		games.emplace_back(new Game(seed + i));
+		publish(*games.back());
+	}
+}
+
+// destructor, stop the workers
+LiveGames::~LiveGames() {
+	stop();
+}
+
+// start the workers (if they aren't running)
+void LiveGames::start() {
+	if (!workers.empty()) {
+		return;
+	}
+	stopping = false;
+	int gameCount{ getGameCount() };
+	for (int i{ 0 }; i < threadCount; i++) {
+		workers.emplace_back(&LiveGames::runWorker, this,
+			i * gameCount / threadCount, (i + 1) * gameCount / threadCount);
+	}
+}
+
+// stop the workers and wait for them to finish
+void LiveGames::stop() {
+	stopping = true;
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+// take the latest board of game index.
+//   return true if it changed since the last update(index)
+bool LiveGames::update(int index) {
+	assert(index >= 0 && index < getGameCount());
+	return games[index]->boards.update();
+}
+
+// the board of game index, as of the last update(index)
+const LiveBoard& LiveGames::getBoard(int index) const {
+	assert(index >= 0 && index < getGameCount());
+	return games[index]->boards.getReadBuffer();
+}
+
+// wait (up to seconds) until a worker has finished a round (a piece in
+// each of its games) since the last call
+//   return true if one has.
+bool LiveGames::waitForRound(double seconds) {
+	std::unique_lock<std::mutex> lock(roundMutex);
+	bool finished{ roundDone.wait_for(lock, std::chrono::duration<double>(seconds),
+		[this]() { return roundsDone != roundsWaitedFor; }) };
+	roundsWaitedFor = roundsDone;
+	return finished;
+}
+
+// play games [first, last) until stopping
+void LiveGames::runWorker(int first, int last) {
+	using Clock = std::chrono::steady_clock;
+	Evaluator evaluator;
+	Clock::duration round{ piecesPerSecond > 0.0
+		? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / piecesPerSecond))
+		: Clock::duration::zero() };
+	Clock::time_point nextRound{ Clock::now() };
+	while (!stopping) {
+		for (int i{ first }; i < last; i++) {
+			step(*games[i], evaluator);
+		}
+		{
+			std::lock_guard<std::mutex> lock(roundMutex);
+			roundsDone++;
+		}
+		roundDone.notify_one();
+		if (round == Clock::duration::zero()) {
+			continue;
+		}
+
+		// wait for the next round (in short sleeps, so stop() isn't kept waiting).
+		// a worker that has fallen behind skips ahead rather than catching up
+		nextRound += round;
+		Clock::time_point now{ Clock::now() };
+		if (nextRound < now) {
+			nextRound = now;
+		}
+		while (!stopping && now < nextRound) {
+			std::this_thread::sleep_for(std::min<Clock::duration>(nextRound - now, MAX_SLEEP));
+			now = Clock::now();
+		}
+	}
+}
+
+// place one piece in game (starting it over if it tops out) and publish its board
+void LiveGames::step(Game& game, Evaluator& evaluator) {
+	if (game.engine.isGameOver()) {
+		game.gamesPlayed++;
+		game.bestScore = std::max(game.bestScore, game.engine.getScore());
+		gamesPlayed++;
+		Metrics::add(Metric::GAMES);
+		// the next seed no other game has used yet
+		game.seed += games.size();
+		game.engine.reset(game.seed);
+	}
+	else {
+		Placement placement;
+		evaluator.choosePlacement(game.engine, placement);
+		int rows{ game.engine.applyPlacement(placement) };
+		piecesPlaced.fetch_add(1, std::memory_order_relaxed);
+		Metrics::add(Metric::PIECES);
+		Metrics::add(Metric::ROWS, rows > 0 ? rows : 0);
+	}
+	publish(game);
+}
+
+// publish game's board through game.boards
+void LiveGames::publish(Game& game) {
+	LiveBoard& board{ game.boards.getWriteBuffer() };
+	const Gameboard& gameboard{ game.engine.getBoard() };
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+			int content{ gameboard.getContent(x, y) };
+			board.content[y][x] = content == Gameboard::EMPTY_BLOCK ? LiveBoard::EMPTY : static_cast<std::uint8_t>(content);
+		}
+	}
+	board.score = game.engine.getScore();
+	board.gamesPlayed = game.gamesPlayed;
+	board.bestScore = game.bestScore;
+	game.boards.publish();
+}
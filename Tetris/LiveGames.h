@@ -0,0 +1,122 @@
+// The LiveGames class keeps a number of bot games running on worker threads,
+// for watching them (see SpectatorWall). Every game is played by a greedy bot
+// (an Evaluator) and starts over with a new seed when it tops out.
+//
+// The games are spread over the workers in contiguous ranges; each worker
+// places one piece in each of its games per round, then waits for the next
+// round (piecesPerSecond sets the pace, 0 plays flat out). After every piece
+// the game's board is published through its own TripleBuffer, so:
+//   - a worker never waits for whoever is watching,
+//   - the watcher only ever sees complete boards, and update(i) tells it
+//     which boards changed since it last looked (the dirty flag), so it can
+//     skip the others.
+
+#ifndef LIVEGAMES_H
+#define LIVEGAMES_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Evaluator.h"
+#include "Gameboard.h"
+#include "TetrisEngine.h"
+#include "TripleBuffer.h"
+
+// what the watcher gets to see of a game
+struct LiveBoard
+{
+	static const std::uint8_t EMPTY = 0xff;		// an empty grid loc
+
+	std::uint8_t content[Gameboard::MAX_Y][Gameboard::MAX_X];	// color or EMPTY, [0] is the top row
+	int score = 0;				// rows cleared in the current game
+	int gamesPlayed = 0;		// games finished so far
+	int bestScore = 0;			// best score of the finished games
+};
+
+class LiveGames
+{
+public:
+	// constructor, gameCount games spread over threadCount workers
+	// (0 means one per core), each placing piecesPerSecond (0 = flat out).
+	// the games' seeds are seed, seed + 1, ...
+	LiveGames(int gameCount, int threadCount = 0, double piecesPerSecond = 10.0, unsigned long long seed = 1);
+
+	// destructor, stop the workers
+	~LiveGames();
+
+	LiveGames(const LiveGames&) = delete;
+	LiveGames& operator=(const LiveGames&) = delete;
+
+	int getGameCount() const { return static_cast<int>(games.size()); }
+	int getThreadCount() const { return threadCount; }
+
+	// start the workers (if they aren't running)
+	void start();
+
+	// stop the workers and wait for them to finish
+	void stop();
+
+	// READER (one thread only) ==========================================
+
+	// take the latest board of game index.
+	//   return true if it changed since the last update(index)
+	bool update(int index);
+
+	// the board of game index, as of the last update(index)
+	const LiveBoard& getBoard(int index) const;
+
+	// pieces placed in all games so far
+	long long getPiecesPlaced() const { return piecesPlaced.load(std::memory_order_relaxed); }
+
+	// games finished so far (all games)
+	int getGamesPlayed() const { return gamesPlayed.load(std::memory_order_relaxed); }
+
+	// wait (up to seconds) until a worker has finished a round (a piece in
+	// each of its games) since the last call
+	//   return true if one has.
+	bool waitForRound(double seconds);
+
+private:
+	// one game and its published board
+	struct Game
+	{
+		explicit Game(unsigned long long seed) : engine(seed), seed{ seed } {}
+
+		TetrisEngine engine;
+		unsigned long long seed;		// the current game's seed
+		int gamesPlayed = 0;
+		int bestScore = 0;
+		TripleBuffer<LiveBoard> boards;
+	};
+
+	// play games [first, last) until stopping
+	void runWorker(int first, int last);
+
+	// place one piece in game (starting it over if it tops out) and publish its board
+	void step(Game& game, Evaluator& evaluator);
+
+	// publish game's board through game.boards
+	static void publish(Game& game);
+
+	// MEMBER VARIABLES
+	std::vector<std::unique_ptr<Game>> games;	// (TripleBuffers can't be moved)
+	int threadCount;
+	double piecesPerSecond;
+	std::vector<std::thread> workers;
+	std::atomic<bool> stopping{ false };
+	std::atomic<long long> piecesPlaced{ 0 };
+	std::atomic<int> gamesPlayed{ 0 };
+	std::mutex roundMutex;
+	std::condition_variable roundDone;		// signalled when a worker finishes a round
+	long long roundsDone = 0;				// rounds finished by all workers (guarded by roundMutex)
+	long long roundsWaitedFor = 0;			// roundsDone as of the last waitForRound() (reader)
+
+	// FRIENDS
+	friend class TestSuite;
+};
+
+#endif /* LIVEGAMES_H */
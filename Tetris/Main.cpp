@@ -1,16 +1,307 @@
 
 #include <SFML/Graphics.hpp>
 #include <time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 #include "TetrisGame.h"
+#include "Evaluator.h"
+#include "FrameCounter.h"
+#include "FramePacer.h"
+#include "AllocationCounter.h"
+#include "FrameProfiler.h"
+#include "LatencyProbe.h"
+#include "LiveGames.h"
+#include "Metrics.h"
+#include "MetricsExporter.h"
+#include "ProfilerOverlay.h"
+#include "SoftwareRenderer.h"
+#include "SpectatorWall.h"
+#include "StepMonitor.h"
 #include "TestSuite.h"
+#include "Tracer.h"
 
+// how long the IDLE pacing mode waits for the game to change before polling the
+// window's events again (the game's keys don't wait for it: the simulation thread
+// samples them, and a key that moves anything is a change)
+const double IDLE_EVENT_SECONDS = 0.05;
 
-int main()
+// how often the profiler overlay's figures are refreshed (while it is shown)
+const double PROFILER_UPDATE_SECONDS = 0.25;
+
+// where F4 writes the trace when no --trace file was given
+const char* const DEFAULT_TRACE_PATH = "tetris-trace.json";
+
+// switch the window's vsync on for VSYNC pacing (and off for everything else)
+void applyPacing(sf::RenderWindow& window, const FramePacer& pacer)
+{
+	window.setVerticalSyncEnabled(pacer.getMode() == PacingMode::VSYNC);
+}
+
+// watch wallSize bot games, each placing piecesPerSecond, tiled over one window
+int runSpectatorWall(int wallSize, double piecesPerSecond, FramePacer& pacer, const sf::Texture& blockTexture)
+{
+	LiveGames games(wallSize, 0, piecesPerSecond);
+
+	sf::RenderWindow window(sf::VideoMode(1600, 900), "Spectator Wall");
+	applyPacing(window, pacer);
+	SpectatorWall wall(games, &blockTexture, 32, sf::Vector2f(1600, 900));
+	games.start();
+
+	sf::Clock clock;
+	sf::Clock drawClock;
+	FrameCounter frameCounter;
+	long long piecesAtLastReport = 0;
+	while (window.isOpen())
+	{
+		sf::Event event;
+		while (window.pollEvent(event))
+		{
+			if (event.type == sf::Event::Closed)
+			{
+				window.close();
+			}
+		}
+
+		drawClock.restart();
+		int boardsChanged = wall.update();		// (only the boards that changed)
+
+		// IDLE: with no board changed, wait for the workers' next round and check again
+		if (pacer.getMode() == PacingMode::IDLE && boardsChanged == 0)
+		{
+			games.waitForRound(IDLE_EVENT_SECONDS);
+			continue;
+		}
+
+		float frameSeconds = clock.getElapsedTime().asSeconds();
+		clock.restart();
+
+		window.clear(sf::Color::Black);
+		window.draw(wall);
+		float drawSeconds = drawClock.getElapsedTime().asSeconds();
+		window.display();
+		pacer.waitForNextFrame();
+		Metrics::add(Metric::FRAMES);
+		Metrics::record(Metric::FRAME_TIME, static_cast<std::uint64_t>(frameSeconds * 1e9f));
+
+		if (frameCounter.addFrame(frameSeconds, drawSeconds))
+		{
+			long long pieces = games.getPiecesPlaced();
+			window.setTitle("Spectator Wall - " + std::to_string(wallSize) + " games, "
+				+ std::to_string(pieces - piecesAtLastReport) + " pieces/s, "
+				+ std::to_string(games.getGamesPlayed()) + " over - " + frameCounter.getReport());
+			piecesAtLastReport = pieces;
+		}
+	}
+	games.stop();
+	return 0;
+}
+
+// play a bot game of pieces pieces (seeded with seed) and write every frame of it
+// to stdout as raw RGBA (640x800), for an encoder to read, e.g.
+//   tetris --video 200 | ffmpeg -f rawvideo -pix_fmt rgba -s 640x800 -r 60 -i - clip.mp4
+// frames are drawn on the CPU (SoftwareRenderer), so no window or GPU is needed.
+int exportVideo(int pieces, unsigned long long seed)
+{
+	sf::Image tiles;
+	sf::Image background;
+	if (!tiles.loadFromFile("images/tiles.png") || !background.loadFromFile("images/background.png"))
+	{
+		std::cerr << "can't load the images\n";
+		return 1;
+	}
+#ifdef _WIN32
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+	SoftwareRenderer renderer(640, 800);
+	renderer.setTiles(tiles.getPixelsPtr(), tiles.getSize().x, tiles.getSize().y);
+	renderer.setBackground(background.getPixelsPtr(), background.getSize().x, background.getSize().y);
+
+	// the bot moves the shape one step per frame, the way it plays in TetrisGame:
+	// rotate, slide, then fall a row at a time until it locks
+	TetrisEngine engine(seed);
+	Evaluator evaluator;
+	sf::Clock clock;
+	int frames = 0;
+	while (!engine.isGameOver() && engine.getPiecesPlaced() < pieces)
+	{
+		Placement placement;
+		evaluator.choosePlacement(engine, placement);
+		int rotationsLeft = placement.rotation;
+		bool locked = false;
+		while (!locked)
+		{
+			renderer.drawGame(engine, Point(54, 125), Point(490, 210));
+			if (std::fwrite(renderer.getPixels(), renderer.getByteCount(), 1, stdout) != 1)
+			{
+				return 1;		// the encoder went away
+			}
+			frames++;
+
+			int xDistance = placement.x - engine.getCurrentShape().getGridLoc().getX();
+			bool moved = false;
+			if (rotationsLeft > 0)
+			{
+				moved = engine.attemptRotate();
+				rotationsLeft--;
+			}
+			else if (xDistance != 0)
+			{
+				moved = engine.attemptMove(xDistance > 0 ? 1 : -1, 0);
+			}
+			if (!moved)
+			{
+				locked = engine.tick();
+			}
+		}
+	}
+	std::fflush(stdout);
+	float seconds = clock.getElapsedTime().asSeconds();
+	std::cerr << frames << " frames in " << seconds << "s (" << frames / seconds << " frames/s)\n";
+	return 0;
+}
+
+// write the trace recorded so far to path (see Tracer), and say so
+void writeTrace(const std::string& path)
+{
+	if (Tracer::writeJson(path))
+	{
+		std::cout << "wrote " << Tracer::getEventCount() << " trace events to " << path
+			<< " (" << Tracer::getDroppedCount() << " dropped)\n";
+	}
+	else
+	{
+		std::cerr << "can't write " << path << "\n";
+	}
+}
+
+// write the input latency histogram to path ("-" for stdout)
+void writeLatencyReport(const LatencyProbe& probe, const std::string& path)
+{
+	if (path == "-")
+	{
+		std::cout << probe.getReport();
+		return;
+	}
+	std::ofstream file(path);
+	file << probe.getReport();
+	if (!file)
+	{
+		std::cerr << "can't write " << path << "\n";
+	}
+}
+
+// write how long the engine steps took, and the slowest one to path (see StepMonitor)
+void writeStepReport(const StepMonitor& monitor, const std::string& path)
 {
+	std::cout << monitor.getReport() << "\n";
+	if (monitor.writeSlowest(path))
+	{
+		std::cout << "wrote the slowest step to " << path << " (replay it with tetris-bench --replay " << path << ")\n";
+	}
+	else if (monitor.getCount() > 0)
+	{
+		std::cerr << "can't write " << path << "\n";
+	}
+}
+
+// usage: tetris [--pacing uncapped|vsync|fps|idle] [--fps N] [--wall N] [--wall-speed PIECES_PER_SEC]
+//               [--video PIECES] [--seed N] [--trace FILE] [--latency FILE] [--steps FILE]
+//               [--metrics HOST[:PORT]]
+//   P cycles through the pacing modes while playing.
+//   F3 shows (and hides) the profiler overlay: the times of each phase of a frame.
+//   F4 starts tracing; pressed again it writes the trace (to --trace's FILE, or
+//      tetris-trace.json) and stops.
+//   --trace traces from the start and writes FILE on exit (open it in ui.perfetto.dev).
+//   --latency writes a histogram of the input-to-photon latency of every key press
+//      to FILE ("-" for stdout) on exit (see LatencyProbe; F3 shows the recent figures).
+//   --steps times every engine step (tick, lock, drop) and on exit prints their p99.9 & max
+//      and writes the slowest, with the game before it, to FILE (see StepMonitor).
+//   --metrics sends fps, frame time, games, pieces & rows, bot nodes and the input
+//      queue's depth every second as StatsD lines over UDP to HOST:PORT (port 8125
+//      by default), for a local agent (see Metrics and MetricsExporter).
+//   --wall watches N bot games instead of playing one.
+//   --video writes a bot game's frames to stdout (see exportVideo()).
+int main(int argc, char* argv[])
+{
+	FramePacer pacer(PacingMode::VSYNC, 60.0);
+	int wallSize = 0;
+	double wallSpeed = 10.0;
+	int videoPieces = 0;
+	unsigned long long seed = 1;
+	std::string tracePath;
+	std::string latencyPath;
+	std::string stepsPath;
+	std::string metricsAddress;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		PacingMode mode;
+		if (std::strcmp(argv[i], "--pacing") == 0 && FramePacer::parseMode(argv[i + 1], mode))
+		{
+			pacer.setMode(mode);
+		}
+		else if (std::strcmp(argv[i], "--fps") == 0)
+		{
+			pacer.setTargetFps(std::atof(argv[i + 1]));
+		}
+		else if (std::strcmp(argv[i], "--wall") == 0)
+		{
+			wallSize = std::atoi(argv[i + 1]);
+		}
+		else if (std::strcmp(argv[i], "--wall-speed") == 0)
+		{
+			wallSpeed = std::atof(argv[i + 1]);
+		}
+		else if (std::strcmp(argv[i], "--video") == 0)
+		{
+			videoPieces = std::atoi(argv[i + 1]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0)
+		{
+			seed = std::strtoull(argv[i + 1], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--trace") == 0)
+		{
+			tracePath = argv[i + 1];
+		}
+		else if (std::strcmp(argv[i], "--latency") == 0)
+		{
+			latencyPath = argv[i + 1];
+		}
+		else if (std::strcmp(argv[i], "--steps") == 0)
+		{
+			stepsPath = argv[i + 1];
+		}
+		else if (std::strcmp(argv[i], "--metrics") == 0)
+		{
+			metricsAddress = argv[i + 1];
+		}
+		else
+		{
+			std::cout << "usage: tetris [--pacing uncapped|vsync|fps|idle] [--fps N] [--wall N] [--wall-speed PIECES_PER_SEC]\n"
+				<< "              [--video PIECES] [--seed N] [--trace FILE] [--latency FILE] [--steps FILE]\n"
+				<< "              [--metrics HOST[:PORT]]\n";
+			return 1;
+		}
+	}
+
 	// run some sanity tests on our classes to ensure they're working as expected.
 	//assert(TestSuite::runTestSuite());
 
+	if (videoPieces > 0)
+	{
+		return exportVideo(videoPieces, seed);	// (needs no window)
+	}
+
 	sf::Sprite blockSprite;			// the tetromino block sprite
 	sf::Texture blockTexture;		// the tetromino block texture
 	sf::Sprite backgroundSprite;	// the background sprite
@@ -25,43 +316,156 @@ int main()
 
 	srand((unsigned int)time(0));	// seed our randomizer
 
+	// export the metrics (for as long as the game or wall runs)
+	std::unique_ptr<MetricsExporter> pMetricsExporter;
+	if (!metricsAddress.empty())
+	{
+		sf::IpAddress address;
+		unsigned short port;
+		if (!MetricsExporter::parseAddress(metricsAddress, address, port))
+		{
+			std::cerr << "can't send metrics to " << metricsAddress << "\n";
+			return 1;
+		}
+		pMetricsExporter.reset(new MetricsExporter(address, port));
+	}
+
+	if (wallSize > 0)
+	{
+		return runSpectatorWall(wallSize, wallSpeed, pacer, blockTexture);
+	}
+
+	Tracer::setThreadName("render");
+	Tracer::setEnabled(!tracePath.empty());
+
 	// create the game window
 	sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");
+	applyPacing(window, pacer);
 
-	// set up a tetris game
-	TetrisGame game(&window, &blockSprite, Point(54, 125), Point(490, 210));
+	// set up a tetris game (timing its phases)
+	FrameProfiler profiler;
+	StepMonitor stepMonitor;	// (only with --steps)
+	TetrisGame game(&window, &blockSprite, Point(54, 125), Point(490, 210), &profiler,
+		stepsPath.empty() ? nullptr : &stepMonitor);
+	LatencyProbe latencyProbe(&profiler);	// times key presses to the screen
+
+	sf::Font overlayFont;
+	overlayFont.loadFromFile("fonts/RedOctober.ttf");
+	ProfilerOverlay overlay(profiler, overlayFont);
+	overlay.setPosition(8, 8);
+	bool showProfiler = false;
+	sf::Clock profilerClock;	// times the overlay's refreshes
 
 
 	sf::Clock clock;	// set up a clock so we can determine seconds per game loop
+	sf::Clock drawClock;		// times the drawing part of each loop
+	FrameCounter frameCounter;	// frame times, shown in the window title
+	std::uint64_t allocationsAtLastFrame = AllocationCounter::getThreadCount();
 
 	// the main game loop
 	while (window.isOpen())
 	{
-		// how long since the last loop (fraction of a second)
-		float gameLoopSeconds = clock.getElapsedTime().asSeconds();
-		clock.restart();
-
 		// handle any window or keyboard events that have occured since the last game loop
-		sf::Event event;
-		while (window.pollEvent(event))
+		bool hadEvent = false;
 		{
-			if (event.type == sf::Event::Closed)
-			{
-				window.close();
-			}
-			else if (event.type == sf::Event::KeyPressed)
+			ProfileTimer timer(&profiler, ProfilePhase::EVENTS);
+			TRACE_SCOPE("events");
+			sf::Event event;
+			while (window.pollEvent(event))
 			{
-				game.onKeyPressed(event);	// handle key press
+				hadEvent = true;
+				if (event.type == sf::Event::Closed)
+				{
+					window.close();
+				}
+				else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P)
+				{
+					pacer.setMode(FramePacer::getNextMode(pacer.getMode()));
+					applyPacing(window, pacer);
+				}
+				else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+				{
+					showProfiler = !showProfiler;
+					overlay.update();
+				}
+				else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F4)
+				{
+					if (Tracer::isEnabled())
+					{
+						Tracer::setEnabled(false);
+						writeTrace(tracePath.empty() ? DEFAULT_TRACE_PATH : tracePath);
+					}
+					else
+					{
+						Tracer::setEnabled(true);
+					}
+				}
+				else if (event.type == sf::Event::KeyPressed)
+				{
+					game.onKeyPressed(event, latencyProbe.onInput());	// handle key press
+				}
 			}
 		}
 
-		game.processGameLoop(gameLoopSeconds);	// handle tetris game logic in here.
+		// IDLE: with no window event, wait until the game changes (a tick, a key,
+		// a bot move) rather than drawing the same frame over again
+		if (pacer.getMode() == PacingMode::IDLE && !hadEvent && !game.waitForChange(IDLE_EVENT_SECONDS))
+		{
+			continue;
+		}
 
+		// how long since the last loop (fraction of a second)
+		float gameLoopSeconds = clock.getElapsedTime().asSeconds();
+		clock.restart();
+		std::uint64_t allocations = AllocationCounter::getThreadCount();
+		profiler.record(ProfilePhase::FRAME, static_cast<std::uint32_t>(gameLoopSeconds * 1e9f),
+			static_cast<std::uint32_t>(allocations - allocationsAtLastFrame));
+		allocationsAtLastFrame = allocations;
+		Metrics::add(Metric::FRAMES);
+		Metrics::record(Metric::FRAME_TIME, static_cast<std::uint64_t>(gameLoopSeconds * 1e9f));
+
+		// (the game logic runs on the game's own simulation thread)
 
+		drawClock.restart();
 		window.clear(sf::Color::White);		// clear the entire window
 		window.draw(backgroundSprite);	// draw the background (onto the window) 
 		game.draw();					// draw the game (onto the window)
-		window.display();				// re-display the entire window
+		if (showProfiler)
+		{
+			if (profilerClock.getElapsedTime().asSeconds() >= PROFILER_UPDATE_SECONDS)
+			{
+				overlay.update();
+				profilerClock.restart();
+			}
+			window.draw(overlay);
+		}
+		float drawSeconds = drawClock.getElapsedTime().asSeconds();
+		{
+			ProfileTimer timer(&profiler, ProfilePhase::DISPLAY);
+			TRACE_SCOPE("display");
+			window.display();			// re-display the entire window
+		}
+		latencyProbe.onFrameDisplayed(game.getDrawnInputId());	// (the keys this frame shows)
+		pacer.waitForNextFrame();		// (only waits in TARGET_FPS mode)
+
+		if (frameCounter.addFrame(gameLoopSeconds, drawSeconds))
+		{
+			window.setTitle(std::string("Tetris Game Window - [") + FramePacer::getModeName(pacer.getMode())
+				+ "] " + frameCounter.getReport());
+		}
+	}
+	if (Tracer::isEnabled())
+	{
+		Tracer::setEnabled(false);
+		writeTrace(tracePath.empty() ? DEFAULT_TRACE_PATH : tracePath);
+	}
+	if (!latencyPath.empty())
+	{
+		writeLatencyReport(latencyProbe, latencyPath);
+	}
+	if (!stepsPath.empty())
+	{
+		writeStepReport(stepMonitor, stepsPath);
 	}
 	return 0;
 }
@@ -0,0 +1,190 @@
+#include "MctsBot.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// constructor, allocate the node pool
+MctsBot::MctsBot(const MctsSettings& settings, const Evaluator& evaluator)
+	: settings{ settings }, evaluator{ evaluator }, nodes{ new Node[MAX_NODES] } {
+}
+
+// search from the engine's current state and write the best
+// placement of its currentShape into best.
+//   return false (leaving best untouched) if there are no placements.
+bool MctsBot::choosePlacement(const TetrisEngine& engine, Placement& best) {
+	if (engine.isGameOver()) {
+		return false;
+	}
+	nodeCount = 0;
+	iterationsStarted = 0;
+	allocateNodes(1);	// the root
+
+	// every search (and every thread) gets its own stream of random futures
+	Rng seeds(settings.seed + static_cast<unsigned long long>(engine.getPiecesPlaced()));
+	std::vector<std::thread> helpers;
+	for (int i{ 1 }; i < settings.threads; i++) {
+		helpers.emplace_back(&MctsBot::searchWorker, this, std::cref(engine), seeds.next());
+	}
+	searchWorker(engine, seeds.next());
+	for (std::thread& helper : helpers) {
+		helper.join();
+	}
+
+	const Node& root{ nodes[0] };
+	if (root.state.load() != EXPANDED || root.childCount == 0) {
+		return false;
+	}
+	int bestChild{ root.firstChild };
+	for (int i{ root.firstChild + 1 }; i < root.firstChild + root.childCount; i++) {
+		if (nodes[i].visits.load() > nodes[bestChild].visits.load()) {
+			bestChild = i;
+		}
+	}
+	best = nodes[bestChild].placement;
+	return true;
+}
+
+// run iterations until the shared iteration budget is used up
+// (each search thread runs this)
+void MctsBot::searchWorker(const TetrisEngine& root, unsigned long long seed) {
+	Rng rng(seed);
+	TetrisEngine scratch{ root };		// reused by every iteration
+	int path[MAX_TREE_DEPTH + 1];
+
+	while (iterationsStarted.fetch_add(1) < settings.iterations) {
+		// the current & next shapes are known, anything after them is a guess
+		scratch = root;
+		scratch.reseedRandom(rng.next());
+
+		// 1) selection & 2) expansion
+		int depth{ 0 };
+		path[0] = 0;
+		nodes[0].visits += VIRTUAL_LOSS;
+		while (depth < MAX_TREE_DEPTH && !scratch.isGameOver()) {
+			Node& node{ nodes[path[depth]] };
+			if (node.state.load(std::memory_order_acquire) != EXPANDED) {
+				expand(node, scratch);
+				// another thread is still filling the node in: roll out from here
+				if (node.state.load(std::memory_order_acquire) != EXPANDED) {
+					break;
+				}
+			}
+			if (node.childCount == 0) {
+				break;
+			}
+			int child{ selectChild(node) };
+			nodes[child].visits += VIRTUAL_LOSS;
+			scratch.applyPlacement(nodes[child].placement);
+			path[++depth] = child;
+		}
+
+		// 3) rollout
+		rollout(scratch, rng);
+
+		// 4) backup (swapping the virtual losses for a real visit)
+		double reward{ getReward(root, scratch) };
+		for (int i{ 0 }; i <= depth; i++) {
+			nodes[path[i]].visits += 1 - VIRTUAL_LOSS;
+			addReward(nodes[path[i]], reward);
+		}
+	}
+}
+
+// claim count consecutive nodes from the pool and reset them.
+//   return the index of the first one, or -1 if the pool is used up.
+int MctsBot::allocateNodes(int count) {
+	int first{ nodeCount.fetch_add(count) };
+	if (first + count > MAX_NODES) {
+		return -1;
+	}
+	for (int i{ first }; i < first + count; i++) {
+		nodes[i].firstChild = 0;
+		nodes[i].childCount = 0;
+		nodes[i].state.store(UNEXPANDED);
+		nodes[i].visits.store(0);
+		nodes[i].totalReward.store(0.0);
+	}
+	return first;
+}
+
+// expand node (if no other thread beat us to it) with the placements
+// of the scratch engine's currentShape
+void MctsBot::expand(Node& node, const TetrisEngine& scratch) {
+	int expected{ UNEXPANDED };
+	if (!node.state.compare_exchange_strong(expected, EXPANDING)) {
+		return;
+	}
+	Placement placements[TetrisEngine::MAX_PLACEMENTS];
+	int count{ scratch.getPlacements(placements) };
+	int first{ allocateNodes(count) };
+	if (first < 0) {
+		count = 0;	// out of nodes, this stays a leaf
+	}
+	for (int i{ 0 }; i < count; i++) {
+		nodes[first + i].placement = placements[i];
+	}
+	node.firstChild = first;
+	node.childCount = count;
+	node.state.store(EXPANDED, std::memory_order_release);
+}
+
+// return the index of the child of node with the best UCT score
+int MctsBot::selectChild(const Node& node) const {
+	double logParentVisits{ std::log(static_cast<double>(std::max(1, node.visits.load()))) };
+	int best{ node.firstChild };
+	double bestScore{ -1.0 };
+	for (int i{ node.firstChild }; i < node.firstChild + node.childCount; i++) {
+		int visits{ nodes[i].visits.load() };
+		if (visits == 0) {
+			return i;	// try everything once before exploiting anything
+		}
+		double score{ nodes[i].totalReward.load() / visits
+			+ settings.exploration * std::sqrt(logParentVisits / visits) };
+		if (score > bestScore) {
+			bestScore = score;
+			best = i;
+		}
+	}
+	return best;
+}
+
+// play rolloutDepth shapes on scratch using the rollout policy
+void MctsBot::rollout(TetrisEngine& scratch, Rng& rng) const {
+	Placement placements[TetrisEngine::MAX_PLACEMENTS];
+	for (int i{ 0 }; i < settings.rolloutDepth && !scratch.isGameOver(); i++) {
+		if (settings.policy == RolloutPolicy::GREEDY) {
+			Placement best;
+			evaluator.choosePlacement(scratch, best);
+			scratch.applyPlacement(best);
+		}
+		else {
+			int count{ scratch.getPlacements(placements) };
+			scratch.applyPlacement(placements[rng.nextInt(count)]);
+		}
+	}
+}
+
+// return the reward (0 to 1) of the game state scratch reached from root
+double MctsBot::getReward(const TetrisEngine& root, const TetrisEngine& scratch) const {
+	if (scratch.isGameOver()) {
+		return 0.0;
+	}
+	// half the reward is for clearing rows: 4 blocks per shape and 10 per row
+	// means no board can keep up more than 0.4 rows per shape
+	int shapes{ scratch.getPiecesPlaced() - root.getPiecesPlaced() };
+	int rows{ scratch.getScore() - root.getScore() };
+	double rowRate{ shapes > 0 ? std::min(1.0, rows / (shapes * 0.4)) : 0.0 };
+	// the other half is for leaving a low board without holes behind
+	BoardFeatures features{ Evaluator::getFeatures(scratch.getBoard()) };
+	double filled{ static_cast<double>(features.aggregateHeight + features.holes)
+		/ (Gameboard::MAX_X * Gameboard::MAX_Y) };
+	return 0.5 * rowRate + 0.5 * (1.0 - std::min(1.0, filled));
+}
+
+// add reward to node's total (atomically)
+void MctsBot::addReward(Node& node, double reward) {
+	double total{ node.totalReward.load() };
+	while (!node.totalReward.compare_exchange_weak(total, total + reward)) {}
+}
@@ -0,0 +1,124 @@
+// The MctsBot class picks placements using Monte Carlo Tree Search.
+//
+// The tree covers the shapes that are known: the currentShape (first level) and
+// the nextShape (second level). Every node is a placement. Each iteration:
+//   1) selection: walk down the tree picking the child with the best UCT score,
+//   2) expansion: add the placements of a leaf as its children,
+//   3) rollout:   play on from there with a cheap policy (random or greedy)
+//                 for a fixed number of shapes, with a random future,
+//   4) backup:    add the rollout's reward to every node on the path.
+// The most visited first level placement is the answer.
+//
+// Searches can run on several threads that share one tree (tree parallelism).
+// A thread walking through a node adds a "virtual loss" to it, which makes
+// the other threads prefer different branches until the result is backed up.
+//
+// Nodes live in a pool that is allocated once, and every thread keeps one
+// scratch TetrisEngine that snapshots are copied into, so iterations don't
+// allocate (rollout throughput is what makes the bot strong).
+
+#ifndef MCTSBOT_H
+#define MCTSBOT_H
+
+#include <atomic>
+#include <memory>
+#include "Evaluator.h"
+#include "Placement.h"
+#include "Rng.h"
+#include "TetrisEngine.h"
+
+// how the rollouts choose their placements
+enum class RolloutPolicy
+{
+	RANDOM,		// any placement, uniformly (fastest)
+	GREEDY,		// the Evaluator's best placement (strongest per rollout)
+};
+
+// search settings
+struct MctsSettings
+{
+	int iterations = 2000;				// rollouts per search (shared by all threads)
+	int threads = 1;					// threads searching the tree
+	int rolloutDepth = 10;				// shapes played per rollout (beyond the tree)
+	double exploration = 0.5;			// UCT exploration constant
+	RolloutPolicy policy = RolloutPolicy::GREEDY;
+	unsigned long long seed = 1;		// seeds the rollouts' random futures
+};
+
+class MctsBot
+{
+public:
+	// constructor, allocate the node pool
+	explicit MctsBot(const MctsSettings& settings = MctsSettings(), const Evaluator& evaluator = Evaluator());
+
+	// search from the engine's current state and write the best
+	// placement of its currentShape into best.
+	//   return false (leaving best untouched) if there are no placements.
+	bool choosePlacement(const TetrisEngine& engine, Placement& best);
+
+	const MctsSettings& getSettings() const { return settings; }
+	void setSettings(const MctsSettings& settings) { this->settings = settings; }
+
+	// the number of tree nodes the last search created
+	int getLastNodeCount() const { return nodeCount.load() < MAX_NODES ? nodeCount.load() : MAX_NODES; }
+
+private:
+	// the tree only covers the currentShape and the nextShape
+	static const int MAX_TREE_DEPTH = 2;
+	static const int MAX_NODES = 1 + TetrisEngine::MAX_PLACEMENTS
+		+ TetrisEngine::MAX_PLACEMENTS * TetrisEngine::MAX_PLACEMENTS;
+	// visits added (without reward) while a thread is exploring a node
+	static const int VIRTUAL_LOSS = 1;
+
+	// node expansion states
+	static const int UNEXPANDED = 0;
+	static const int EXPANDING = 1;
+	static const int EXPANDED = 2;
+
+	struct Node
+	{
+		Placement placement;				// the placement that leads to this node
+		int firstChild = 0;					// index of the first child in the pool
+		int childCount = 0;					// children are stored next to each other
+		std::atomic<int> state{ UNEXPANDED };
+		std::atomic<int> visits{ 0 };		// includes virtual losses in flight
+		std::atomic<double> totalReward{ 0.0 };
+	};
+
+	// run iterations until the shared iteration budget is used up
+	// (each search thread runs this)
+	void searchWorker(const TetrisEngine& root, unsigned long long seed);
+
+	// claim count consecutive nodes from the pool and reset them.
+	//   return the index of the first one, or -1 if the pool is used up.
+	int allocateNodes(int count);
+
+	// expand node (if no other thread beat us to it) with the placements
+	// of the scratch engine's currentShape
+	void expand(Node& node, const TetrisEngine& scratch);
+
+	// return the index of the child of node with the best UCT score
+	int selectChild(const Node& node) const;
+
+	// play rolloutDepth shapes on scratch using the rollout policy
+	void rollout(TetrisEngine& scratch, Rng& rng) const;
+
+	// return the reward (0 to 1) of the game state scratch reached from root
+	double getReward(const TetrisEngine& root, const TetrisEngine& scratch) const;
+
+	// add reward to node's total (atomically)
+	static void addReward(Node& node, double reward);
+
+	// MEMBER VARIABLES
+	MctsSettings settings;
+	Evaluator evaluator;					// drives the greedy rollouts
+	std::unique_ptr<Node[]> nodes;			// the node pool (nodes[0] is the root)
+	std::atomic<int> nodeCount{ 0 };		// nodes in use
+	std::atomic<int> iterationsStarted{ 0 };
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* MCTSBOT_H */
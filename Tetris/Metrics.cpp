@@ -0,0 +1,99 @@
+#include "Metrics.h"
+#include <assert.h>
+#include <cstdio>
+
+// how each metric is sent: its name, kind and the scale its values are sent in
+struct MetricInfo
+{
+	const char* name;
+	MetricKind kind;
+	double scale;
+};
+static const MetricInfo METRIC_INFO[static_cast<int>(Metric::COUNT)] = {
+	{ "fps", MetricKind::RATE, 1.0 },
+	{ "frame_ms", MetricKind::MEAN, 1e-6 },
+	{ "games_per_sec", MetricKind::RATE, 1.0 },
+	{ "pieces_per_sec", MetricKind::RATE, 1.0 },
+	{ "rows_cleared", MetricKind::COUNTER, 1.0 },
+	{ "bot_nodes_per_sec", MetricKind::RATE, 1.0 },
+	{ "input_queue", MetricKind::MAX, 1.0 },
+};
+
+std::atomic<bool> Metrics::enabled{ false };
+Metrics::ThreadSlot Metrics::slots[Metrics::MAX_THREADS];
+std::atomic<int> Metrics::nextSlot{ 0 };
+thread_local int Metrics::threadSlot{ -1 };
+std::atomic<std::uint64_t> Metrics::maxima[static_cast<int>(Metric::COUNT)];
+std::mutex Metrics::mutex;
+std::uint64_t Metrics::collectedCounts[static_cast<int>(Metric::COUNT)];
+std::uint64_t Metrics::collectedSums[static_cast<int>(Metric::COUNT)];
+
+// record a value of metric (a MEAN or MAX)
+void Metrics::record(Metric metric, std::uint64_t value) {
+	if (!isEnabled()) {
+		return;
+	}
+	int i{ static_cast<int>(metric) };
+	if (METRIC_INFO[i].kind == MetricKind::MAX) {
+		std::uint64_t largest{ maxima[i].load(std::memory_order_relaxed) };
+		while (value > largest && !maxima[i].compare_exchange_weak(largest, value, std::memory_order_relaxed)) {
+		}
+		return;
+	}
+	ThreadSlot& slot{ getThreadSlot() };
+	slot.sums[i].fetch_add(value, std::memory_order_relaxed);
+	slot.counts[i].fetch_add(1, std::memory_order_relaxed);
+}
+
+// return the name metric is sent as (without the "tetris." prefix)
+const char* Metrics::getName(Metric metric) {
+	assert(metric >= Metric::FRAMES && metric < Metric::COUNT);
+	return METRIC_INFO[static_cast<int>(metric)].name;
+}
+
+// return how metric is sent
+MetricKind Metrics::getKind(Metric metric) {
+	assert(metric >= Metric::FRAMES && metric < Metric::COUNT);
+	return METRIC_INFO[static_cast<int>(metric)].kind;
+}
+
+// append a StatsD line per metric to lines, for what was counted since the
+// last call (seconds ago, for the rates)
+void Metrics::collect(double seconds, std::string& lines) {
+	std::lock_guard<std::mutex> lock(mutex);
+	char line[96];
+	for (int i{ 0 }; i < static_cast<int>(Metric::COUNT); i++) {
+		const MetricInfo& info{ METRIC_INFO[i] };
+		if (info.kind == MetricKind::MAX) {
+			std::uint64_t largest{ maxima[i].exchange(0, std::memory_order_relaxed) };
+			std::snprintf(line, sizeof(line), "tetris.%s:%g|g\n", info.name, largest * info.scale);
+			lines += line;
+			continue;
+		}
+
+		// (the slots only ever grow, so what was added since is the difference in the totals)
+		std::uint64_t count{ 0 };
+		std::uint64_t sum{ 0 };
+		for (const ThreadSlot& slot : slots) {
+			count += slot.counts[i].load(std::memory_order_relaxed);
+			sum += slot.sums[i].load(std::memory_order_relaxed);
+		}
+		std::uint64_t added{ count - collectedCounts[i] };
+		std::uint64_t addedSum{ sum - collectedSums[i] };
+		collectedCounts[i] = count;
+		collectedSums[i] = sum;
+		if (info.kind == MetricKind::COUNTER) {
+			std::snprintf(line, sizeof(line), "tetris.%s:%llu|c\n", info.name, static_cast<unsigned long long>(added));
+		}
+		else if (info.kind == MetricKind::RATE) {
+			std::snprintf(line, sizeof(line), "tetris.%s:%g|g\n", info.name, seconds > 0.0 ? added * info.scale / seconds : 0.0);
+		}
+		else if (added > 0) {
+			std::snprintf(line, sizeof(line), "tetris.%s:%g|g\n", info.name, static_cast<double>(addedSum) / added * info.scale);
+		}
+		else {
+			continue;
+		}
+		lines += line;
+	}
+}
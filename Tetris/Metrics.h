@@ -0,0 +1,105 @@
+// The Metrics class counts what the game is doing (frames, games, pieces,
+// rows, bot nodes, queue depths) for a live dashboard: collect() turns what
+// was counted since its last call into StatsD lines ("tetris.fps:59.8|g"),
+// which MetricsExporter sends to a local agent over UDP.
+//
+// Counting is meant for the hot threads: when metrics are off it costs one
+// relaxed load of an atomic flag, when on one relaxed add to the calling
+// thread's own slot (a cache line per thread, so threads never contend for one;
+// past MAX_THREADS threads share slots, which stays correct, just slower).
+// collect() sums the slots, on whatever thread calls it.
+//
+// Each metric is sent as its kind says:
+//   COUNTER  what was added since the last collect() ("|c")
+//   RATE     that, per second ("|g")
+//   MEAN     the mean of the values recorded since then ("|g"; not sent if none)
+//   MAX      the largest value recorded since then ("|g", 0 if none)
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// the metrics counted
+enum class Metric
+{
+	FRAMES,			// main.cpp: frames displayed (sent as fps)
+	FRAME_TIME,		// main.cpp: nanoseconds per frame (sent as the mean, in ms)
+	GAMES,			// games that ended (sent per second)
+	PIECES,			// pieces locked (sent per second)
+	ROWS,			// rows cleared (sent as a counter)
+	BOT_NODES,		// tree nodes the bot searched (sent per second)
+	INPUT_QUEUE,	// key presses waiting for the simulation thread (sent as the max)
+	COUNT,			// (the number of metrics)
+};
+
+// how a metric is sent (see above)
+enum class MetricKind
+{
+	COUNTER,
+	RATE,
+	MEAN,
+	MAX,
+};
+
+class Metrics
+{
+public:
+	static const int MAX_THREADS = 64;		// threads with a slot of their own
+
+	// return true if counting is on (any thread, as cheap as it gets)
+	static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+	// switch counting on or off
+	static void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+	// count amount more of metric (a COUNTER or RATE)
+	static void add(Metric metric, std::uint64_t amount = 1) {
+		if (isEnabled()) {
+			getThreadSlot().counts[static_cast<int>(metric)].fetch_add(amount, std::memory_order_relaxed);
+		}
+	}
+
+	// record a value of metric (a MEAN or MAX)
+	static void record(Metric metric, std::uint64_t value);
+
+	// return the name metric is sent as (without the "tetris." prefix)
+	static const char* getName(Metric metric);
+
+	// return how metric is sent
+	static MetricKind getKind(Metric metric);
+
+	// append a StatsD line per metric to lines, for what was counted since the
+	// last call (seconds ago, for the rates)
+	static void collect(double seconds, std::string& lines);
+
+private:
+	// a thread's counts (written by that thread only, unless threads share it)
+	struct alignas(64) ThreadSlot
+	{
+		std::atomic<std::uint64_t> counts[static_cast<int>(Metric::COUNT)];
+		std::atomic<std::uint64_t> sums[static_cast<int>(Metric::COUNT)];	// (MEAN only)
+	};
+
+	// return the calling thread's slot
+	static ThreadSlot& getThreadSlot() {
+		if (threadSlot < 0) {
+			threadSlot = nextSlot.fetch_add(1, std::memory_order_relaxed) % MAX_THREADS;
+		}
+		return slots[threadSlot];
+	}
+
+	static std::atomic<bool> enabled;
+	static ThreadSlot slots[MAX_THREADS];
+	static std::atomic<int> nextSlot;						// the slot the next new thread gets
+	static thread_local int threadSlot;						// the calling thread's (-1 until it counts)
+	static std::atomic<std::uint64_t> maxima[static_cast<int>(Metric::COUNT)];	// (MAX only, since the last collect())
+	static std::mutex mutex;								// guards collect()'s totals
+	static std::uint64_t collectedCounts[static_cast<int>(Metric::COUNT)];	// the totals at the last collect()
+	static std::uint64_t collectedSums[static_cast<int>(Metric::COUNT)];
+};
+
+#endif /* METRICS_H */
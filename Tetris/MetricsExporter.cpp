@@ -0,0 +1,87 @@
+#include "MetricsExporter.h"
+#include <chrono>
+#include <cstdlib>
+#include "Metrics.h"
+#include "Tracer.h"
+
+// constructor, send the Metrics to address:port every intervalSeconds
+// (from a thread of its own)
+MetricsExporter::MetricsExporter(const sf::IpAddress& address, unsigned short port, double intervalSeconds)
+	: address{ address }, port{ port }, intervalSeconds{ intervalSeconds } {
+	socket.setBlocking(false);
+	lines.reserve(MAX_PACKET * 2);
+	Metrics::setEnabled(true);
+	thread = std::thread(&MetricsExporter::run, this);
+}
+
+// destructor, send a last batch, stop the thread
+MetricsExporter::~MetricsExporter() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeUp.notify_one();
+	thread.join();
+	Metrics::setEnabled(false);
+}
+
+// read "host[:port]" into address & port (DEFAULT_PORT if there is none)
+//   return false if host can't be resolved or port isn't a number.
+bool MetricsExporter::parseAddress(const std::string& text, sf::IpAddress& address, unsigned short& port) {
+	std::size_t colon{ text.rfind(':') };
+	port = DEFAULT_PORT;
+	if (colon != std::string::npos) {
+		char* end{ nullptr };
+		long number{ std::strtol(text.c_str() + colon + 1, &end, 10) };
+		if (*end != '\0' || number <= 0 || number > 65535) {
+			return false;
+		}
+		port = static_cast<unsigned short>(number);
+	}
+	address = sf::IpAddress(text.substr(0, colon));
+	return address != sf::IpAddress::None;
+}
+
+// the thread's main loop: flush every interval until stopping
+void MetricsExporter::run() {
+	Tracer::setThreadName("metrics");
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point last{ Clock::now() };
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!stopping) {
+		wakeUp.wait_for(lock, std::chrono::duration<double>(intervalSeconds), [this]() { return stopping; });
+		Clock::time_point now{ Clock::now() };
+		lock.unlock();
+		flush(std::chrono::duration<double>(now - last).count());
+		lock.lock();
+		last = now;
+	}
+}
+
+// collect the Metrics counted over the last seconds and send them
+void MetricsExporter::flush(double seconds) {
+	TRACE_SCOPE("metrics flush");
+	lines.clear();
+	Metrics::collect(seconds, lines);
+
+	// send whole lines, as many as fit in a packet at a time
+	std::size_t start{ 0 };
+	while (start < lines.size()) {
+		std::size_t end{ start };
+		for (;;) {
+			std::size_t next{ lines.find('\n', end) };
+			if (next == std::string::npos || (next + 1 - start > MAX_PACKET && end > start)) {
+				break;
+			}
+			end = next + 1;
+		}
+		if (end == start) {
+			end = lines.size();		// (a last line without a newline, which collect() never writes)
+		}
+		// (without the last newline)
+		if (socket.send(lines.data() + start, end - start - 1, address, port) == sf::Socket::Done) {
+			packetsSent++;
+		}
+		start = end;
+	}
+}
@@ -0,0 +1,67 @@
+// The MetricsExporter sends the Metrics to a StatsD agent (statsd, Telegraf,
+// the Datadog agent ...) listening on a local UDP address, for live dashboards.
+//
+// A background thread wakes every interval, collects what was counted since
+// the last time (Metrics::collect()) and sends it as few packets as it can:
+// lines are batched, newline separated, up to MAX_PACKET bytes per packet (which
+// fits an Ethernet frame, so nothing is fragmented). UDP never blocks the game:
+// if no agent is listening the packets are simply lost.
+//
+// Constructing one switches the Metrics on; destroying it sends a last batch
+// and switches them off.
+
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class MetricsExporter
+{
+public:
+	static const std::size_t MAX_PACKET = 1432;		// bytes of StatsD lines per packet
+	static const unsigned short DEFAULT_PORT = 8125;	// StatsD's
+
+	// constructor, send the Metrics to address:port every intervalSeconds
+	// (from a thread of its own)
+	MetricsExporter(const sf::IpAddress& address, unsigned short port, double intervalSeconds = 1.0);
+
+	// destructor, send a last batch, stop the thread
+	~MetricsExporter();
+
+	MetricsExporter(const MetricsExporter&) = delete;
+	MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+	// read "host[:port]" into address & port (DEFAULT_PORT if there is none)
+	//   return false if host can't be resolved or port isn't a number.
+	static bool parseAddress(const std::string& text, sf::IpAddress& address, unsigned short& port);
+
+	// the packets sent so far (that the socket took)
+	int getPacketsSent() const { return packetsSent; }
+
+private:
+	// the thread's main loop: flush every interval until stopping
+	void run();
+
+	// collect the Metrics counted over the last seconds and send them
+	void flush(double seconds);
+
+	// MEMBER VARIABLES
+	sf::UdpSocket socket;
+	sf::IpAddress address;
+	unsigned short port;
+	double intervalSeconds;
+	std::string lines;				// the collected lines (reused, so flushes don't allocate)
+	std::atomic<int> packetsSent{ 0 };
+
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	bool stopping = false;			// (guarded by mutex)
+	std::thread thread;				// started last, once everything above is ready
+};
+
+#endif /* METRICSEXPORTER_H */
@@ -0,0 +1,19 @@
+// A Placement describes where a tetromino comes to rest when it is locked:
+//  - rotation: how many times it was rotated clockwise (0-3) at the spawn loc
+//  - x, y:     the gridLoc the tetromino ends up at after sliding and dropping
+//
+// Bots think in placements rather than individual key presses. The engine
+// generates every reachable placement for the current shape and can apply one
+// directly (rotate, slide, drop and lock in a single step).
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+struct Placement
+{
+	int rotation = 0;	// number of clockwise rotations from the spawn orientation
+	int x = 0;			// final gridLoc x
+	int y = 0;			// final gridLoc y (where the drop stopped)
+};
+
+#endif /* PLACEMENT_H */
@@ -0,0 +1,93 @@
+#include "ProfilerOverlay.h"
+#include <algorithm>
+#include <cstdio>
+
+// the layout (pixels)
+static const unsigned int CHARACTER_SIZE = 12;
+static const float LINE_HEIGHT = 15.0f;
+static const float PADDING = 6.0f;
+static const float COLUMN_X[] = { 0.0f, 90.0f, 150.0f, 210.0f, 270.0f };
+static const float WIDTH = 330.0f;
+static const float BAR_X = 70.0f;				// where the histogram's bars start
+static const float BAR_WIDTH = WIDTH - BAR_X - 2 * PADDING;
+
+// add a rectangle to quads
+static void addRectangle(sf::VertexArray& quads, float left, float top, float width, float height, sf::Color color) {
+	quads.append(sf::Vertex(sf::Vector2f(left, top), color));
+	quads.append(sf::Vertex(sf::Vector2f(left + width, top), color));
+	quads.append(sf::Vertex(sf::Vector2f(left + width, top + height), color));
+	quads.append(sf::Vertex(sf::Vector2f(left, top + height), color));
+}
+
+// constructor, show profiler's figures in font
+ProfilerOverlay::ProfilerOverlay(const FrameProfiler& profiler, const sf::Font& font) : profiler(profiler) {
+	for (int i{ 0 }; i < COLUMNS; i++) {
+		columns[i].setFont(font);
+		columns[i].setCharacterSize(CHARACTER_SIZE);
+		columns[i].setFillColor(sf::Color::White);
+		columns[i].setPosition(PADDING + COLUMN_X[i], PADDING);
+	}
+	histogramLabels.setFont(font);
+	histogramLabels.setCharacterSize(CHARACTER_SIZE);
+	histogramLabels.setFillColor(sf::Color::White);
+	update();
+}
+
+// rebuild the figures from the profiler's latest times
+void ProfilerOverlay::update() {
+	// the stats table: a header, then a line per phase
+	std::string text[COLUMNS]{ "phase\n", "p50\n", "p99\n", "max ms\n", "allocs\n" };
+	char number[32];
+	for (int i{ 0 }; i < FrameProfiler::PHASE_COUNT; i++) {
+		ProfilePhase phase{ static_cast<ProfilePhase>(i) };
+		PhaseStats stats{ profiler.getStats(phase) };
+		text[0] += FrameProfiler::getPhaseName(phase);
+		text[0] += '\n';
+		std::snprintf(number, sizeof(number), "%.2f\n", stats.p50Ms);
+		text[1] += number;
+		std::snprintf(number, sizeof(number), "%.2f\n", stats.p99Ms);
+		text[2] += number;
+		std::snprintf(number, sizeof(number), "%.2f\n", stats.maxMs);
+		text[3] += number;
+		std::snprintf(number, sizeof(number), "%d\n", stats.maxAllocations);
+		text[4] += number;
+	}
+	for (int i{ 0 }; i < COLUMNS; i++) {
+		columns[i].setString(text[i]);
+	}
+
+	// the frame time histogram below it: a bar per bucket
+	int counts[FrameProfiler::HISTOGRAM_BUCKETS];
+	profiler.getHistogram(ProfilePhase::FRAME, counts);
+	int most{ std::max(1, *std::max_element(counts, counts + FrameProfiler::HISTOGRAM_BUCKETS)) };
+	float histogramTop{ PADDING + (FrameProfiler::PHASE_COUNT + 2) * LINE_HEIGHT };
+	float height{ histogramTop + FrameProfiler::HISTOGRAM_BUCKETS * LINE_HEIGHT + PADDING };
+
+	quads.clear();
+	addRectangle(quads, 0, 0, WIDTH, height, sf::Color(0, 0, 0, 190));
+	std::string labels{ "frames\n" };
+	for (int i{ 0 }; i < FrameProfiler::HISTOGRAM_BUCKETS; i++) {
+		if (i < FrameProfiler::HISTOGRAM_BUCKETS - 1) {
+			std::snprintf(number, sizeof(number), "<= %g\n", FrameProfiler::getHistogramBucketMs(i));
+		}
+		else {
+			std::snprintf(number, sizeof(number), "> %g\n", FrameProfiler::getHistogramBucketMs(i - 1));
+		}
+		labels += number;
+		float top{ histogramTop + i * LINE_HEIGHT + 3.0f };
+		addRectangle(quads, PADDING + BAR_X, top, BAR_WIDTH * counts[i] / most, LINE_HEIGHT - 5.0f,
+			sf::Color(90, 200, 90));
+	}
+	histogramLabels.setString(labels);
+	histogramLabels.setPosition(PADDING, histogramTop - LINE_HEIGHT);
+}
+
+// draw the overlay (sf::Drawable)
+void ProfilerOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+	states.transform *= getTransform();
+	target.draw(quads, states);
+	for (const sf::Text& column : columns) {
+		target.draw(column, states);
+	}
+	target.draw(histogramLabels, states);
+}
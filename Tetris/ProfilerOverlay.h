@@ -0,0 +1,35 @@
+// The ProfilerOverlay class draws a FrameProfiler's figures over the game:
+// the p50, p99 and max time of every phase (and the most allocations a run of
+// it made, see AllocationCounter) and a histogram of the frame
+// times. The figures are only rebuilt by update() (a few times a second is
+// plenty), so drawing the overlay costs a few draw calls and no text layout.
+
+#ifndef PROFILEROVERLAY_H
+#define PROFILEROVERLAY_H
+
+#include <SFML/Graphics.hpp>
+#include "FrameProfiler.h"
+
+class ProfilerOverlay : public sf::Drawable, public sf::Transformable
+{
+public:
+	// constructor, show profiler's figures in font
+	ProfilerOverlay(const FrameProfiler& profiler, const sf::Font& font);
+
+	// rebuild the figures from the profiler's latest times
+	void update();
+
+private:
+	// draw the overlay (sf::Drawable)
+	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+	// MEMBER VARIABLES
+	const FrameProfiler& profiler;
+
+	static const int COLUMNS = 5;		// phase, p50, p99, max, allocations
+	sf::Text columns[COLUMNS];			// the stats table, a column per text
+	sf::Text histogramLabels;			// the bucket bounds
+	sf::VertexArray quads{ sf::Quads };	// the panel & the histogram's bars
+};
+
+#endif /* PROFILEROVERLAY_H */
@@ -0,0 +1,55 @@
+// The Rng class is a small, fast pseudo random number generator (xorshift64*).
+// Unlike rand(), every instance carries its own state, so a headless game can
+// be replayed from its seed and several bots can roll dice on different
+// threads without stepping on each other.
+// The whole state is a single integer, which keeps engine snapshots cheap to copy.
+
+#ifndef RNG_H
+#define RNG_H
+
+class Rng
+{
+public:
+	// constructor, seed the generator (any seed is fine, including 0)
+	explicit Rng(unsigned long long seed = 1) { setSeed(seed); }
+
+	// restart the sequence from a new seed.
+	//   the seed is scrambled (splitmix64) so that nearby seeds such as
+	//   1, 2, 3... still produce unrelated sequences.
+	void setSeed(unsigned long long seed)
+	{
+		seed += 0x9E3779B97F4A7C15ULL;
+		seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+		state = seed ^ (seed >> 31);
+		if (state == 0) {
+			state = 0x9E3779B97F4A7C15ULL;	// xorshift must never hold 0
+		}
+	}
+
+	// return the next 64 random bits
+	unsigned long long next()
+	{
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 0x2545F4914F6CDD1DULL;
+	}
+
+	// return a random int in the range [0, bound)
+	int nextInt(int bound) { return static_cast<int>((next() >> 33) % static_cast<unsigned long long>(bound)); }
+
+	// return a random double in the range [0, 1)
+	double nextDouble() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+	// return the whole state (to save a game, see TetrisEngine::write())
+	unsigned long long getState() const { return state; }
+
+	// continue from a state returned by getState()
+	void setState(unsigned long long state) { this->state = state != 0 ? state : 0x9E3779B97F4A7C15ULL; }
+
+private:
+	unsigned long long state;
+};
+
+#endif /* RNG_H */
@@ -0,0 +1,166 @@
+#include "SoftwareRenderer.h"
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARERENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
+// x / 255 for x in 0..65535 (no division)
+static inline int div255(int x) {
+	return (x + 1 + (x >> 8)) >> 8;
+}
+
+#ifdef SOFTWARERENDERER_SSE2
+// div255() on every 16 bit lane
+static inline __m128i div255(__m128i x) {
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+// blend 2 pixels (widened to 16 bit lanes: r g b a r g b a) of src over dst
+static inline __m128i blendPixels(__m128i src, __m128i dst, __m128i tint) {
+	src = div255(_mm_mullo_epi16(src, tint));
+	__m128i alpha{ _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)) };
+	__m128i inverse{ _mm_sub_epi16(_mm_set1_epi16(255), alpha) };
+	// (at most 255 * 255 in total, so the sum fits 16 bits unsigned)
+	return div255(_mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, inverse)));
+}
+#endif
+
+// constructor, frames of width x height pixels
+SoftwareRenderer::SoftwareRenderer(int width, int height) : width{ width }, height{ height } {
+	assert(width > 0 && height > 0);
+	pixels.assign(static_cast<size_t>(width) * height * 4, 255);
+	background = pixels;
+}
+
+// set the tile image: the block colors side by side, each a square
+// of height pixels (pixels is width * height * 4 bytes, r g b a)
+void SoftwareRenderer::setTiles(const std::uint8_t* tilePixels, int tilesWidth, int tilesHeight) {
+	assert(tilePixels && tilesHeight > 0 && tilesWidth >= tilesHeight);
+	this->tilesWidth = tilesWidth;
+	blockSize = tilesHeight;
+	tiles.assign(tilePixels, tilePixels + static_cast<size_t>(tilesWidth) * tilesHeight * 4);
+
+	// opaque tiles can be copied rather than blended
+	int colors{ tilesWidth / blockSize };
+	isTileOpaque.assign(colors, true);
+	for (int y{ 0 }; y < blockSize; y++) {
+		for (int x{ 0 }; x < colors * blockSize; x++) {
+			if (tiles[(static_cast<size_t>(y) * tilesWidth + x) * 4 + 3] != 255) {
+				isTileOpaque[x / blockSize] = false;
+			}
+		}
+	}
+}
+
+// set the image every frame starts from (drawn at the top left, over
+// white, as the window is cleared to white before the background is drawn)
+void SoftwareRenderer::setBackground(const std::uint8_t* backgroundPixels, int backgroundWidth, int backgroundHeight) {
+	background.assign(pixels.size(), 255);
+	int columns{ std::min(width, backgroundWidth) };
+	for (int y{ 0 }; y < std::min(height, backgroundHeight); y++) {
+		blendRow(&background[static_cast<size_t>(y) * width * 4],
+			&backgroundPixels[static_cast<size_t>(y) * backgroundWidth * 4], columns, Rgba());
+	}
+}
+
+// draw engine's game the way TetrisGame::draw() does
+void SoftwareRenderer::drawGame(const TetrisEngine& engine, Point gameboardOffset, Point nextShapeOffset) {
+	clear();
+	const Gameboard& board{ engine.getBoard() };
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+			int content{ board.getContent(x, y) };
+			if (content != Gameboard::EMPTY_BLOCK) {
+				drawBlock(x, y, static_cast<TetColor>(content), gameboardOffset);
+			}
+		}
+	}
+	if (!engine.isGameOver()) {
+		GridTetromino ghost{ engine.getCurrentShape() };
+		engine.drop(ghost);
+		drawTetromino(ghost, gameboardOffset, Rgba(255, 255, 255, 60));
+	}
+	drawTetromino(engine.getCurrentShape(), gameboardOffset);
+	drawTetromino(engine.getNextShape(), nextShapeOffset);
+}
+
+// start a frame: copy the background into it
+void SoftwareRenderer::clear() {
+	std::memcpy(pixels.data(), background.data(), pixels.size());
+}
+
+// draw a block of color at grid loc x,y (origin is the grid's top left in pixels)
+void SoftwareRenderer::drawBlock(int x, int y, TetColor color, Point origin, Rgba tint) {
+	assert(blockSize > 0);
+	int index{ static_cast<int>(color) };
+	int left{ origin.getX() + x * blockSize };
+	int top{ origin.getY() + y * blockSize };
+
+	// clip the block to the frame
+	int firstColumn{ std::max(0, -left) };
+	int lastColumn{ std::min(blockSize, width - left) };
+	int firstRow{ std::max(0, -top) };
+	int lastRow{ std::min(blockSize, height - top) };
+	if (firstColumn >= lastColumn || firstRow >= lastRow) {
+		return;
+	}
+
+	bool copy{ tint.r == 255 && tint.g == 255 && tint.b == 255 && tint.a == 255
+		&& index < static_cast<int>(isTileOpaque.size()) && isTileOpaque[index] };
+	int count{ lastColumn - firstColumn };
+	for (int row{ firstRow }; row < lastRow; row++) {
+		std::uint8_t* dst{ &pixels[(static_cast<size_t>(top + row) * width + left + firstColumn) * 4] };
+		const std::uint8_t* src{ &tiles[(static_cast<size_t>(row) * tilesWidth + index * blockSize + firstColumn) * 4] };
+		if (copy) {
+			std::memcpy(dst, src, count * 4);
+		}
+		else {
+			blendRow(dst, src, count, tint);
+		}
+	}
+}
+
+// draw a tetromino's blocks (origin as for drawBlock())
+void SoftwareRenderer::drawTetromino(const GridTetromino& tetromino, Point origin, Rgba tint) {
+	BlockLocs locs{ tetromino.getBlockLocsMappedToGrid() };
+	for (const Point& loc : locs) {
+		drawBlock(loc.getX(), loc.getY(), tetromino.getColor(), origin, tint);
+	}
+}
+
+// blend count pixels of src (tinted) over dst, leaving dst opaque
+void SoftwareRenderer::blendRow(std::uint8_t* dst, const std::uint8_t* src, int count, Rgba tint) {
+	int i{ 0 };
+#ifdef SOFTWARERENDERER_SSE2
+	// 4 pixels at a time: widen each half to 16 bit lanes, blend, narrow again
+	const __m128i zero{ _mm_setzero_si128() };
+	const __m128i tints{ _mm_setr_epi16(tint.r, tint.g, tint.b, tint.a, tint.r, tint.g, tint.b, tint.a) };
+	const __m128i opaque{ _mm_set1_epi32(static_cast<int>(0xff000000u)) };
+	for (; i + 4 <= count; i += 4) {
+		__m128i source{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4)) };
+		__m128i destination{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i * 4)) };
+		__m128i low{ blendPixels(_mm_unpacklo_epi8(source, zero), _mm_unpacklo_epi8(destination, zero), tints) };
+		__m128i high{ blendPixels(_mm_unpackhi_epi8(source, zero), _mm_unpackhi_epi8(destination, zero), tints) };
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_packus_epi16(low, high), opaque));
+	}
+#endif
+	if (i < count) {
+		blendRowScalar(dst + i * 4, src + i * 4, count - i, tint);
+	}
+}
+
+// blendRow() without SIMD (what blendRow() must match)
+void SoftwareRenderer::blendRowScalar(std::uint8_t* dst, const std::uint8_t* src, int count, Rgba tint) {
+	const int tints[4]{ tint.r, tint.g, tint.b, tint.a };
+	for (int i{ 0 }; i < count; i++, src += 4, dst += 4) {
+		int alpha{ div255(src[3] * tints[3]) };
+		for (int channel{ 0 }; channel < 3; channel++) {
+			int color{ div255(src[channel] * tints[channel]) };
+			dst[channel] = static_cast<std::uint8_t>(div255(color * alpha + dst[channel] * (255 - alpha)));
+		}
+		dst[3] = 255;
+	}
+}
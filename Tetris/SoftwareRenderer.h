@@ -0,0 +1,95 @@
+// The SoftwareRenderer class draws a game into an RGBA pixel buffer on the CPU,
+// for exporting video on machines without a GPU (or a display). The buffer is
+// laid out as sf::Image expects (4 bytes per pixel, r g b a, row by row), so it
+// can be handed to sf::Image::create() or streamed straight to an encoder.
+//
+// The layout is the same as TetrisGame::draw(): the background, the locked
+// blocks, the ghost of the current shape, the current shape and the next
+// shape, with the gameboard and the next shape at the offsets TetrisGame uses.
+// (The score text isn't drawn.)
+//
+// Blocks are copied from the tile image (images/tiles.png: the colors side by
+// side, each a square of blockSize pixels) a row at a time:
+//   - a row of opaque pixels is a plain memcpy,
+//   - a faded (tinted) row is blended over the frame with SSE2, 4 pixels per
+//     iteration (one 128 bit load, blended as two halves of 2 pixels in 16 bit
+//     lanes), where SSE2 is available (and pixel by pixel where it isn't).
+// Blocks are clipped to the frame, so shapes sticking out above the board are
+// fine. It knows nothing about SFML: the images are passed in as pixels.
+
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <cstdint>
+#include <vector>
+#include "Point.h"
+#include "TetrisEngine.h"
+
+// a color (or a tint: each channel is multiplied by channel / 255)
+struct Rgba
+{
+	std::uint8_t r = 255;
+	std::uint8_t g = 255;
+	std::uint8_t b = 255;
+	std::uint8_t a = 255;
+
+	Rgba() {}
+	Rgba(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a = 255) : r{ r }, g{ g }, b{ b }, a{ a } {}
+};
+
+class SoftwareRenderer
+{
+public:
+	// constructor, frames of width x height pixels
+	SoftwareRenderer(int width, int height);
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	// the frame's pixels (width * height * 4 bytes, r g b a)
+	const std::uint8_t* getPixels() const { return pixels.data(); }
+	int getByteCount() const { return static_cast<int>(pixels.size()); }
+
+	// set the tile image: the block colors side by side, each a square
+	// of height pixels (pixels is width * height * 4 bytes, r g b a)
+	void setTiles(const std::uint8_t* tilePixels, int tilesWidth, int tilesHeight);
+
+	// set the image every frame starts from (drawn at the top left, over
+	// white, as the window is cleared to white before the background is drawn)
+	void setBackground(const std::uint8_t* backgroundPixels, int backgroundWidth, int backgroundHeight);
+
+	// draw engine's game the way TetrisGame::draw() does
+	void drawGame(const TetrisEngine& engine, Point gameboardOffset, Point nextShapeOffset);
+
+	// start a frame: copy the background into it
+	void clear();
+
+	// draw a block of color at grid loc x,y (origin is the grid's top left in pixels)
+	void drawBlock(int x, int y, TetColor color, Point origin, Rgba tint = Rgba());
+
+	// draw a tetromino's blocks (origin as for drawBlock())
+	void drawTetromino(const GridTetromino& tetromino, Point origin, Rgba tint = Rgba());
+
+	// blend count pixels of src (tinted) over dst, leaving dst opaque
+	static void blendRow(std::uint8_t* dst, const std::uint8_t* src, int count, Rgba tint);
+
+	// blendRow() without SIMD (what blendRow() must match)
+	static void blendRowScalar(std::uint8_t* dst, const std::uint8_t* src, int count, Rgba tint);
+
+private:
+	// MEMBER VARIABLES
+	int width;
+	int height;
+	std::vector<std::uint8_t> pixels;			// the frame
+	std::vector<std::uint8_t> background;		// what clear() starts a frame from
+
+	std::vector<std::uint8_t> tiles;			// the tile image
+	int tilesWidth = 0;
+	int blockSize = 0;							// the tiles' size (and a grid loc's, in pixels)
+	std::vector<bool> isTileOpaque;				// per color: every pixel has alpha 255
+
+	// FRIENDS
+	friend class TestSuite;
+};
+
+#endif /* SOFTWARERENDERER_H */
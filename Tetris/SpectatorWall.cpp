@@ -0,0 +1,136 @@
+#include "SpectatorWall.h"
+#include <assert.h>
+#include <algorithm>
+
+// the vertices of one grid loc, and of one board
+static const int VERTICES_PER_BLOCK = 4;
+static const int VERTICES_PER_BOARD = VERTICES_PER_BLOCK * Gameboard::MAX_X * Gameboard::MAX_Y;
+
+// the color behind the blocks of a board
+static const sf::Color BOARD_BACKGROUND(24, 24, 32);
+
+// constructor, tile the boards of games over an area of size pixels.
+// pTexture holds the block colors side by side, textureBlockSize pixels square
+SpectatorWall::SpectatorWall(LiveGames& games, const sf::Texture* pTexture, int textureBlockSize, sf::Vector2f size)
+	: games(games), pTexture{ pTexture }, textureBlockSize{ textureBlockSize } {
+	assert(pTexture);
+	layOut(size);
+
+	int boardCount{ games.getGameCount() };
+	float width{ blockSize * Gameboard::MAX_X };
+	float height{ blockSize * Gameboard::MAX_Y };
+	for (int i{ 0 }; i < boardCount; i++) {
+		sf::Vector2f position{ getBoardPosition(i) };
+		backgrounds.append(sf::Vertex(position, BOARD_BACKGROUND));
+		backgrounds.append(sf::Vertex(position + sf::Vector2f(width, 0), BOARD_BACKGROUND));
+		backgrounds.append(sf::Vertex(position + sf::Vector2f(width, height), BOARD_BACKGROUND));
+		backgrounds.append(sf::Vertex(position + sf::Vector2f(0, height), BOARD_BACKGROUND));
+	}
+
+	vertices.resize(static_cast<size_t>(VERTICES_PER_BOARD) * boardCount);
+	useVertexBuffer = sf::VertexBuffer::isAvailable() && vertexBuffer.create(vertices.size());
+	for (int i{ 0 }; i < boardCount; i++) {
+		games.update(i);
+		buildBoard(i, games.getBoard(i));
+	}
+	uploadBoards(0, boardCount - 1);
+}
+
+// bring the vertices up to date with the boards that changed
+//   return the number of boards that were rebuilt
+int SpectatorWall::update() {
+	int boardCount{ games.getGameCount() };
+	int rebuilt{ 0 };
+	int firstChanged{ -1 };
+	for (int i{ 0 }; i <= boardCount; i++) {
+		if (i < boardCount && games.update(i)) {
+			buildBoard(i, games.getBoard(i));
+			rebuilt++;
+			if (firstChanged < 0) {
+				firstChanged = i;
+			}
+		}
+		else if (firstChanged >= 0) {
+			uploadBoards(firstChanged, i - 1);
+			firstChanged = -1;
+		}
+	}
+	return rebuilt;
+}
+
+// return the on-screen top left of board index
+sf::Vector2f SpectatorWall::getBoardPosition(int index) const {
+	float left{ (index % columns) * (blockSize * Gameboard::MAX_X + gap) + gap };
+	float top{ (index / columns) * (blockSize * Gameboard::MAX_Y + gap) + gap };
+	return sf::Vector2f(left, top);
+}
+
+// draw the wall (sf::Drawable)
+void SpectatorWall::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+	target.draw(backgrounds, states);
+	states.texture = pTexture;
+	if (useVertexBuffer) {
+		target.draw(vertexBuffer, states);
+	}
+	else {
+		target.draw(vertices.data(), vertices.size(), sf::Quads, states);
+	}
+}
+
+// choose the columns, rows and block size that make the boards as large as
+// possible within size
+void SpectatorWall::layOut(sf::Vector2f size) {
+	int boardCount{ games.getGameCount() };
+	gap = boardCount > 64 ? 1.0f : 4.0f;
+	blockSize = 0.0f;
+	for (int tryColumns{ 1 }; tryColumns <= boardCount; tryColumns++) {
+		int tryRows{ (boardCount + tryColumns - 1) / tryColumns };
+		float byWidth{ (size.x - gap) / tryColumns - gap };
+		float byHeight{ (size.y - gap) / tryRows - gap };
+		float tryBlockSize{ std::min(byWidth / Gameboard::MAX_X, byHeight / Gameboard::MAX_Y) };
+		if (tryBlockSize > blockSize) {
+			blockSize = tryBlockSize;
+			columns = tryColumns;
+			rows = tryRows;
+		}
+	}
+	// whole pixels keep the blocks from shimmering (unless they're tiny)
+	if (blockSize >= 2.0f) {
+		blockSize = static_cast<float>(static_cast<int>(blockSize));
+	}
+}
+
+// rebuild the block vertices of board index from board
+void SpectatorWall::buildBoard(int index, const LiveBoard& board) {
+	sf::Vector2f position{ getBoardPosition(index) };
+	sf::Vertex* quad{ &vertices[static_cast<size_t>(index) * VERTICES_PER_BOARD] };
+	float size{ static_cast<float>(textureBlockSize) };
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+		float top{ position.y + y * blockSize };
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++, quad += VERTICES_PER_BLOCK) {
+			float left{ position.x + x * blockSize };
+			std::uint8_t content{ board.content[y][x] };
+			if (content == LiveBoard::EMPTY) {
+				// a quad with no area: nothing is drawn
+				for (int i{ 0 }; i < VERTICES_PER_BLOCK; i++) {
+					quad[i] = sf::Vertex(sf::Vector2f(left, top));
+				}
+				continue;
+			}
+			float textureLeft{ content * size };
+			quad[0] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(textureLeft, 0));
+			quad[1] = sf::Vertex(sf::Vector2f(left + blockSize, top), sf::Vector2f(textureLeft + size, 0));
+			quad[2] = sf::Vertex(sf::Vector2f(left + blockSize, top + blockSize), sf::Vector2f(textureLeft + size, size));
+			quad[3] = sf::Vertex(sf::Vector2f(left, top + blockSize), sf::Vector2f(textureLeft, size));
+		}
+	}
+}
+
+// upload the vertices of boards first to last (inclusive)
+void SpectatorWall::uploadBoards(int first, int last) {
+	if (!useVertexBuffer) {
+		return;		// drawn straight from vertices
+	}
+	unsigned int offset{ static_cast<unsigned int>(first * VERTICES_PER_BOARD) };
+	vertexBuffer.update(&vertices[offset], (last - first + 1) * VERTICES_PER_BOARD, offset);
+}
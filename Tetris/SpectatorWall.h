@@ -0,0 +1,73 @@
+// The SpectatorWall class tiles the boards of a LiveGames (hundreds of them)
+// over one window, for watching bot tournaments.
+//
+// All of the boards are drawn in two draw calls: one for the board backgrounds
+// (which never change) and one for the blocks of every board, textured from the
+// one block texture (images/tiles.png, used as an atlas: each color is a
+// column of it). Like BoardRenderer, every grid loc owns a quad of an
+// sf::VertexBuffer; the boards lie one after the other in it.
+//
+// update() asks LiveGames which boards changed since the last frame (their
+// dirty flags), rebuilds only those, and uploads each run of neighbouring
+// changed boards with a single update. Reading a board never blocks the
+// workers playing it, so a slow frame can't slow the games down.
+
+#ifndef SPECTATORWALL_H
+#define SPECTATORWALL_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "LiveGames.h"
+
+class SpectatorWall : public sf::Drawable
+{
+public:
+	// constructor, tile the boards of games over an area of size pixels.
+	// pTexture holds the block colors side by side, textureBlockSize pixels square
+	SpectatorWall(LiveGames& games, const sf::Texture* pTexture, int textureBlockSize, sf::Vector2f size);
+
+	// bring the vertices up to date with the boards that changed
+	//   return the number of boards that were rebuilt
+	int update();
+
+	// the size of a grid loc on screen, in pixels
+	float getBlockSize() const { return blockSize; }
+
+	// the number of board columns (and rows) of the wall
+	int getColumns() const { return columns; }
+	int getRows() const { return rows; }
+
+	// return the on-screen top left of board index
+	sf::Vector2f getBoardPosition(int index) const;
+
+private:
+	// draw the wall (sf::Drawable)
+	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+	// choose the columns, rows and block size that make the boards as large as
+	// possible within size
+	void layOut(sf::Vector2f size);
+
+	// rebuild the block vertices of board index from board
+	void buildBoard(int index, const LiveBoard& board);
+
+	// upload the vertices of boards first to last (inclusive)
+	void uploadBoards(int first, int last);
+
+	// MEMBER VARIABLES
+	LiveGames& games;
+	const sf::Texture* pTexture;
+	int textureBlockSize;
+
+	int columns = 1;
+	int rows = 1;
+	float blockSize = 1.0f;		// pixels per grid loc on screen
+	float gap = 1.0f;			// pixels between boards
+
+	sf::VertexArray backgrounds{ sf::Quads };	// a quad per board
+	std::vector<sf::Vertex> vertices;			// 4 per grid loc, board by board
+	sf::VertexBuffer vertexBuffer{ sf::Quads, sf::VertexBuffer::Stream };
+	bool useVertexBuffer = false;
+};
+
+#endif /* SPECTATORWALL_H */
@@ -0,0 +1,57 @@
+// The SpscQueue class hands values from one thread (the writer) to another
+// (the reader) in order, without locks: a ring of CAPACITY slots with a head
+// (the next slot to read) and a tail (the next slot to write), each an atomic
+// owned by one side. Unlike a TripleBuffer, every value arrives, so it suits
+// events (key presses) rather than states.
+//
+// Neither side ever waits: push() fails if the ring is full, pop() if it's
+// empty.
+//
+// Only one thread may push and only one thread may pop.
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+
+template <typename T, int CAPACITY>
+class SpscQueue
+{
+	static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of 2 (so the indexes wrap around cleanly)");
+
+public:
+	// WRITER ========================================================
+
+	// add value at the back
+	//   return false if the queue is full (value is dropped).
+	bool push(const T& value) {
+		unsigned int tail{ this->tail.load(std::memory_order_relaxed) };
+		if (tail - head.load(std::memory_order_acquire) == CAPACITY) {
+			return false;
+		}
+		slots[tail % CAPACITY] = value;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// READER ========================================================
+
+	// take the value at the front into value
+	//   return false if the queue is empty.
+	bool pop(T& value) {
+		unsigned int head{ this->head.load(std::memory_order_relaxed) };
+		if (head == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		value = slots[head % CAPACITY];
+		this->head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	T slots[CAPACITY];
+	std::atomic<unsigned int> head{ 0 };	// written by the reader
+	std::atomic<unsigned int> tail{ 0 };	// written by the writer
+};
+
+#endif /* SPSCQUEUE_H */
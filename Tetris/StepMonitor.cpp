@@ -0,0 +1,134 @@
+#include "StepMonitor.h"
+#include <assert.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+// the first line of a file written by writeSlowest()
+static const char* const SLOWEST_HEADER = "tetris-slowest-step 1";
+
+// make step on engine
+//   return true if it locked the current shape.
+bool StepMonitor::runStep(TetrisEngine& engine, EngineStep step) {
+	switch (step) {
+		case EngineStep::TICK:
+			return engine.tick();
+		case EngineStep::LOCK:
+			engine.lockCurrentShape();
+			return true;
+		case EngineStep::DROP:
+			engine.drop();
+			engine.lockCurrentShape();
+			return true;
+		default:
+			assert(false && "unknown engine step");
+			return false;
+	}
+}
+
+// return the name of step ("tick", "lock", "drop")
+const char* StepMonitor::getStepName(EngineStep step) {
+	static const char* const NAMES[] = { "tick", "lock", "drop" };
+	assert(step >= EngineStep::TICK && step < EngineStep::COUNT);
+	return NAMES[static_cast<int>(step)];
+}
+
+// make step on engine (see runStep()), timing it
+//   return true if it locked the current shape.
+bool StepMonitor::step(TetrisEngine& engine, EngineStep step) {
+	beforeStep = engine;
+	auto start = std::chrono::steady_clock::now();
+	bool locked{ runStep(engine, step) };
+	auto end = std::chrono::steady_clock::now();
+	lastNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	record(step, lastNs, beforeStep);
+	return locked;
+}
+
+// record a step that took nanoseconds, from the game before (the slowest
+// is kept; step() calls this)
+void StepMonitor::record(EngineStep step, std::uint64_t nanoseconds, const TetrisEngine& before) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (steps.getCount() == 0 || nanoseconds > steps.getMaxNs()) {
+		slowestStep = step;
+		slowestBefore = before;
+	}
+	steps.add(nanoseconds);
+	if (nanoseconds > BUDGET_NS) {
+		overBudget++;
+	}
+}
+
+std::uint64_t StepMonitor::getCount() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return steps.getCount();
+}
+
+std::uint64_t StepMonitor::getOverBudgetCount() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return overBudget;
+}
+
+std::uint64_t StepMonitor::getMaxNs() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return steps.getMaxNs();
+}
+
+double StepMonitor::getPercentileNs(double percent) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return steps.getPercentileNs(percent);
+}
+
+// return a line summing up the steps: count, p50, p99.9, max & the steps over budget
+std::string StepMonitor::getReport() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	char report[200];
+	std::snprintf(report, sizeof(report), "%llu engine steps: p50 %.0f ns, p99.9 %.0f ns, max %llu ns (a %s); %llu over the %llu ns budget",
+		static_cast<unsigned long long>(steps.getCount()), steps.getPercentileNs(50), steps.getPercentileNs(99.9),
+		static_cast<unsigned long long>(steps.getMaxNs()), getStepName(slowestStep),
+		static_cast<unsigned long long>(overBudget), static_cast<unsigned long long>(BUDGET_NS));
+	return report;
+}
+
+// write the slowest step & the game before it to path, for readSlowest()
+//   return false if there were no steps or path couldn't be written.
+bool StepMonitor::writeSlowest(const std::string& path) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (steps.getCount() == 0) {
+		return false;
+	}
+	std::ofstream file(path);
+	file << SLOWEST_HEADER << '\n';
+	file << "step " << getStepName(slowestStep) << '\n';
+	file << "nanoseconds " << steps.getMaxNs() << '\n';
+	slowestBefore.write(file);
+	return static_cast<bool>(file);
+}
+
+// read a step written by writeSlowest() into step, nanoseconds & before
+//   return false if path doesn't hold one.
+bool StepMonitor::readSlowest(const std::string& path, EngineStep& step, std::uint64_t& nanoseconds, TetrisEngine& before) {
+	std::ifstream file(path);
+	std::string line;
+	if (!std::getline(file, line) || line != SLOWEST_HEADER) {
+		return false;
+	}
+	std::string label;
+	std::string name;
+	std::uint64_t readNanoseconds{ 0 };
+	if (!(file >> label >> name) || label != "step" || !(file >> label >> readNanoseconds) || label != "nanoseconds") {
+		return false;
+	}
+	int found{ -1 };
+	for (int i{ 0 }; i < static_cast<int>(EngineStep::COUNT); i++) {
+		if (name == getStepName(static_cast<EngineStep>(i))) {
+			found = i;
+		}
+	}
+	if (found < 0 || !before.read(file)) {
+		return false;
+	}
+	step = static_cast<EngineStep>(found);
+	nanoseconds = readNanoseconds;
+	return true;
+}
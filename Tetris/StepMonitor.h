@@ -0,0 +1,83 @@
+// The StepMonitor times every engine step (what the game does when a piece
+// falls a row or is dropped: tick, lock, clear rows, spawn the next piece)
+// against a worst-case budget, since the simulation must never stall. It keeps:
+//   - the steps' percentiles (see LatencyHistogram), for p99.9,
+//   - the slowest step, with the whole game as it was just before it
+//     (a copy of the engine), so the step can be replayed: writeSlowest()
+//     dumps it and readSlowest() loads it back (tetris-bench --replay).
+//   - how many steps went over BUDGET_NS.
+//
+// step() copies the engine before starting the clock, so the copy isn't timed.
+// Only one thread may call step(); the getters and writeSlowest() can be
+// called from any thread meanwhile (there is a mutex, taken outside the timing).
+
+#ifndef STEPMONITOR_H
+#define STEPMONITOR_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "LatencyHistogram.h"
+#include "TetrisEngine.h"
+
+// the engine steps that are timed
+enum class EngineStep
+{
+	TICK,			// TetrisEngine::tick() (which locks when the piece can't fall)
+	LOCK,			// TetrisEngine::lockCurrentShape() (a soft drop that landed)
+	DROP,			// TetrisEngine::drop() then lockCurrentShape() (a hard drop)
+	COUNT,			// (the number of steps)
+};
+
+class StepMonitor
+{
+public:
+	static const std::uint64_t BUDGET_NS = 10000;		// the worst a step may take
+
+	// make step on engine
+	//   return true if it locked the current shape.
+	static bool runStep(TetrisEngine& engine, EngineStep step);
+
+	// return the name of step ("tick", "lock", "drop")
+	static const char* getStepName(EngineStep step);
+
+	// make step on engine (see runStep()), timing it
+	//   return true if it locked the current shape.
+	bool step(TetrisEngine& engine, EngineStep step);
+
+	// record a step that took nanoseconds, from the game before (the slowest
+	// is kept; step() calls this)
+	void record(EngineStep step, std::uint64_t nanoseconds, const TetrisEngine& before);
+
+	// return how long the last step() took (call on the thread calling step())
+	std::uint64_t getLastNs() const { return lastNs; }
+
+	// getters
+	std::uint64_t getCount() const;
+	std::uint64_t getOverBudgetCount() const;
+	std::uint64_t getMaxNs() const;
+	double getPercentileNs(double percent) const;
+
+	// return a line summing up the steps: count, p50, p99.9, max & the steps over budget
+	std::string getReport() const;
+
+	// write the slowest step & the game before it to path, for readSlowest()
+	//   return false if there were no steps or path couldn't be written.
+	bool writeSlowest(const std::string& path) const;
+
+	// read a step written by writeSlowest() into step, nanoseconds & before
+	//   return false if path doesn't hold one.
+	static bool readSlowest(const std::string& path, EngineStep& step, std::uint64_t& nanoseconds, TetrisEngine& before);
+
+private:
+	// MEMBER VARIABLES
+	mutable std::mutex mutex;			// (guards everything below)
+	LatencyHistogram steps;
+	std::uint64_t overBudget = 0;
+	EngineStep slowestStep = EngineStep::TICK;
+	TetrisEngine slowestBefore;			// the game just before the slowest step
+	TetrisEngine beforeStep;			// the game before the step being timed (step() only)
+	std::uint64_t lastNs = 0;			// how long the last step() took (step() only)
+};
+
+#endif /* STEPMONITOR_H */
@@ -0,0 +1,75 @@
+#include "TerminalScreen.h"
+#include <assert.h>
+#include <cstdio>
+
+// constructor, a screen of columns x rows cells
+TerminalScreen::TerminalScreen(int columns, int rows) : columns{ columns }, rows{ rows } {
+	assert(columns > 0 && rows > 0);
+	cells.resize(static_cast<size_t>(columns) * rows);
+	shown.resize(cells.size());
+}
+
+// start a new frame: every cell blank (a space on the default background)
+void TerminalScreen::clear() {
+	for (Cell& cell : cells) {
+		cell = Cell();
+	}
+}
+
+// set the cell at column,row (0 based) of the new frame
+//   cells outside the screen are ignored.
+void TerminalScreen::setCell(int column, int row, char character, std::uint8_t color) {
+	if (column < 0 || column >= columns || row < 0 || row >= rows) {
+		return;
+	}
+	Cell& cell{ cells[static_cast<size_t>(row) * columns + column] };
+	cell.character = character;
+	cell.color = color;
+}
+
+// write text into the new frame from column,row on (on the default background)
+void TerminalScreen::putText(int column, int row, const char* text) {
+	for (int i{ 0 }; text[i]; i++) {
+		setCell(column + i, row, text[i]);
+	}
+}
+
+// append the escape sequences that turn the frame the terminal shows into
+// the new frame to output (nothing if nothing changed)
+//   return the number of cells that changed.
+int TerminalScreen::render(std::string& output) {
+	char sequence[32];
+	int changed{ 0 };
+	int cursor{ -1 };				// the cell the terminal's cursor is at (-1: unknown)
+	int color{ DEFAULT_COLOR };		// the color last written (every render() ends on the default)
+	for (int i{ 0 }; i < static_cast<int>(cells.size()); i++) {
+		if (isShown && !(cells[i] != shown[i])) {
+			continue;
+		}
+		changed++;
+		if (cursor != i) {
+			std::snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", i / columns + 1, i % columns + 1);
+			output += sequence;
+		}
+		if (color != cells[i].color) {
+			if (cells[i].color == DEFAULT_COLOR) {
+				output += "\x1b[0m";
+			}
+			else {
+				std::snprintf(sequence, sizeof(sequence), "\x1b[48;5;%dm", cells[i].color);
+				output += sequence;
+			}
+			color = cells[i].color;
+		}
+		output += cells[i].character;
+		shown[i] = cells[i];
+		// the cursor moves on, but wraps (or stops) at the end of a row
+		cursor = (i + 1) % columns == 0 ? -1 : i + 1;
+	}
+	// leave the terminal's own color as it was
+	if (color != DEFAULT_COLOR) {
+		output += "\x1b[0m";
+	}
+	isShown = true;
+	return changed;
+}
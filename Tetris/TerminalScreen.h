@@ -0,0 +1,79 @@
+// The TerminalScreen class keeps the frame a text terminal should show and
+// turns it into ANSI escape sequences, writing only what changed.
+//
+// A frame is a grid of cells (a character and a background color from the
+// terminal's 256 color palette). Each frame is drawn from scratch with
+// clear() & setCell()/putText(); render() then compares it with the frame the
+// terminal already shows and appends the sequences for the changed cells only:
+//   - a cursor move (ESC [ row ; column H) when the next changed cell isn't
+//     where the cursor already is (runs of changed cells need just one),
+//   - a color change (ESC [ 48;5;n m) only when the color differs from the
+//     last one written.
+// A game frame typically changes a handful of cells (the falling shape moved a
+// row), so a frame costs tens of bytes rather than the whole screen. The caller
+// writes the output with a single write(), see TetrisTerm.
+//
+// It knows nothing about the terminal itself (raw mode, keys): it only
+// produces text, so it can be tested headless.
+
+#ifndef TERMINALSCREEN_H
+#define TERMINALSCREEN_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TerminalScreen
+{
+public:
+	static const std::uint8_t DEFAULT_COLOR = 0xff;		// the terminal's own background
+
+	// constructor, a screen of columns x rows cells
+	TerminalScreen(int columns, int rows);
+
+	int getColumns() const { return columns; }
+	int getRows() const { return rows; }
+
+	// start a new frame: every cell blank (a space on the default background)
+	void clear();
+
+	// set the cell at column,row (0 based) of the new frame
+	//   cells outside the screen are ignored.
+	void setCell(int column, int row, char character, std::uint8_t color = DEFAULT_COLOR);
+
+	// write text into the new frame from column,row on (on the default background)
+	void putText(int column, int row, const char* text);
+
+	// append the escape sequences that turn the frame the terminal shows into
+	// the new frame to output (nothing if nothing changed)
+	//   return the number of cells that changed.
+	int render(std::string& output);
+
+	// forget what the terminal shows, so the next render() redraws every cell
+	// (after the screen was cleared or resized)
+	void invalidate() { isShown = false; }
+
+private:
+	// a character on a background color
+	struct Cell
+	{
+		char character = ' ';
+		std::uint8_t color = DEFAULT_COLOR;
+
+		bool operator!=(const Cell& other) const {
+			return character != other.character || color != other.color;
+		}
+	};
+
+	// MEMBER VARIABLES
+	int columns;
+	int rows;
+	std::vector<Cell> cells;		// the new frame, row by row
+	std::vector<Cell> shown;		// what the terminal shows (if isShown)
+	bool isShown = false;
+
+	// FRIENDS
+	friend class TestSuite;
+};
+
+#endif /* TERMINALSCREEN_H */
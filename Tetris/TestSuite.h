@@ -1,11 +1,37 @@
 #ifndef TESTSUITE_H
 #define TESTSUITE_H
 
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
 #include <vector>
 #include <assert.h>
 #include "Point.h"
 #include "Tetromino.h"
 #include "GridTetromino.h"
+#include "TetrisEngine.h"
+#include "Evaluator.h"
+#include "BatchEvaluator.h"
+#include "MctsBot.h"
+#include "BatchSimulator.h"
+#include "BotThread.h"
+#include "DatasetWriter.h"
+#include "FrameCounter.h"
+#include "FramePacer.h"
+#include "TripleBuffer.h"
+#include "SpscQueue.h"
+#include "LiveGames.h"
+#include "SoftwareRenderer.h"
+#include "TerminalScreen.h"
+#include "FrameProfiler.h"
+#include "LatencyProbe.h"
+#include "LatencyHistogram.h"
+#include "StepMonitor.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include "AllocationCounter.h"
 
 
 #ifdef GAMEBOARD_H
@@ -28,6 +54,27 @@ public:
 #ifdef GAMEBOARD_H
 		TestSuite::testGameboardClass();
 #endif
+		TestSuite::testTetrisEngineClass();
+		TestSuite::testEvaluatorClass();
+		TestSuite::testBatchEvaluatorClass();
+		TestSuite::testMctsBotClass();
+		TestSuite::testBatchSimulatorClass();
+		TestSuite::testBotThreadClass();
+		TestSuite::testDatasetWriterClass();
+		TestSuite::testFrameCounterClass();
+		TestSuite::testFramePacerClass();
+		TestSuite::testTripleBufferClass();
+		TestSuite::testSpscQueueClass();
+		TestSuite::testLiveGamesClass();
+		TestSuite::testSoftwareRendererClass();
+		TestSuite::testTerminalScreenClass();
+		TestSuite::testFrameProfilerClass();
+		TestSuite::testTracerClass();
+		TestSuite::testAllocationCounterClass();
+		TestSuite::testLatencyProbeClass();
+		TestSuite::testLatencyHistogramClass();
+		TestSuite::testStepMonitorClass();
+		TestSuite::testMetricsClass();
 
 		std::cout << "TestSuite complete -----------------------" << "\n";
 		return true;
@@ -59,7 +106,7 @@ public:
 		// test getBlockLocsMappedToGrid()
 		gt.blockLocs = { Point(1,2) };
 		gt.setGridLoc(5, 5);
-		std::vector<Point> locs = gt.getBlockLocsMappedToGrid();
+		BlockLocs locs = gt.getBlockLocsMappedToGrid();
 		assert(locs[0].getX() == 6 && locs[0].getY() == 7);
 
 
@@ -186,6 +233,1154 @@ public:
 		return true;
 	}
 
+	static bool testTetrisEngineClass()
+	{
+		std::cout << " testTetrisEngineClass...";
+
+		// the same seed must always produce the same game
+		TetrisEngine a(42);
+		TetrisEngine b(42);
+		for (int i = 0; i < 20; i++) {
+			assert(a.getCurrentShape().getShape() == b.getCurrentShape().getShape());
+			assert(a.getNextShape().getShape() == b.getNextShape().getShape());
+			a.drop();
+			a.lockCurrentShape();
+			b.drop();
+			b.lockCurrentShape();
+		}
+
+		// reset() starts a fresh game
+		a.reset(7);
+		assert(a.getScore() == 0 && a.getPiecesPlaced() == 0 && !a.isGameOver());
+		assert(TestSuite::isGameboardEmpty(a.board));
+		assert(a.getCurrentShape().getGridLoc().getX() == a.getBoard().getSpawnLoc().getX());
+
+		// moves are blocked by the borders
+		while (a.attemptMove(-1, 0)) {}
+		for (const Point& loc : a.getCurrentShape().getBlockLocsMappedToGrid()) {
+			assert(loc.getX() >= 0);
+		}
+		assert(!a.attemptMove(-1, 0));
+
+		// a tick only locks once the shape can't move down
+		// (and only locking changes the board's generation)
+		unsigned long long generation = a.getBoard().getGeneration();
+		a.attemptRotate();
+		a.drop();
+		assert(a.getBoard().getGeneration() == generation);
+		assert(a.tick() == true);
+		assert(a.getPiecesPlaced() == 1);
+		assert(a.getBoard().getGeneration() != generation);
+
+		// every placement is a legal resting spot and locks 4 blocks
+		a.reset(3);
+		Placement placements[TetrisEngine::MAX_PLACEMENTS];
+		int count = a.getPlacements(placements);
+		assert(count > 0 && count <= TetrisEngine::MAX_PLACEMENTS);
+		for (int i = 0; i < count; i++) {
+			TetrisEngine copy = a;
+			assert(copy.applyPlacement(placements[i]) == 0);
+			int blocks = 0;
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				for (int y = 0; y < Gameboard::MAX_Y; y++) {
+					if (copy.getBoard().getContent(x, y) != Gameboard::EMPTY_BLOCK) { blocks++; }
+				}
+			}
+			assert(blocks == 4);
+			// previewPlacement() must agree with applyPlacement()
+			Gameboard preview;
+			a.previewPlacement(placements[i], preview);
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				for (int y = 0; y < Gameboard::MAX_Y; y++) {
+					assert(preview.getContent(x, y) == copy.getBoard().getContent(x, y));
+				}
+			}
+		}
+
+		// an O shape only has one distinct rotation, I has 2, T has 4
+		assert(TetrisEngine::getRotationCount(TetShape::SHAPE_O) == 1);
+		assert(TetrisEngine::getRotationCount(TetShape::SHAPE_I) == 2);
+		assert(TetrisEngine::getRotationCount(TetShape::SHAPE_T) == 4);
+
+		// a placement that isn't resting on anything is rejected
+		Placement floating = placements[0];
+		floating.y -= 1;
+		assert(a.applyPlacement(floating) == -1);
+
+		// completing a row clears it and scores it
+		a.reset(5);
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			a.board.setContent(x, Gameboard::MAX_Y - 1, 0);
+		}
+		a.board.setContent(a.getBoard().getSpawnLoc().getX(), Gameboard::MAX_Y - 1, Gameboard::EMPTY_BLOCK);
+		a.currentShape.setShape(TetShape::SHAPE_I);
+		a.drop();
+		assert(a.lockCurrentShape() == 1);
+		assert(a.getScore() == 1);
+
+		// filling the board up ends the game
+		a.reset(9);
+		while (!a.isGameOver()) {
+			a.drop();
+			a.lockCurrentShape();
+		}
+		assert(a.getPlacements(placements) == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testEvaluatorClass()
+	{
+		std::cout << " testEvaluatorClass...";
+
+		Gameboard g;
+		BoardFeatures features = Evaluator::getFeatures(g);
+		assert(features.aggregateHeight == 0 && features.holes == 0 && features.bumpiness == 0);
+
+		// a single block 2 rows up, with a hole under it
+		g.setContent(0, Gameboard::MAX_Y - 2, 1);
+		features = Evaluator::getFeatures(g);
+		assert(features.aggregateHeight == 2 && features.holes == 1 && features.bumpiness == 2);
+		assert(features.maxHeight == 2);
+
+		// clearing rows is good, holes are bad
+		Evaluator evaluator;
+		Gameboard empty;
+		assert(evaluator.evaluate(empty, 1) > evaluator.evaluate(empty, 0));
+		assert(evaluator.evaluate(empty, 0) > evaluator.evaluate(g, 0));
+
+		// the greedy choice is always one of the engine's placements
+		TetrisEngine engine(11);
+		Placement best;
+		assert(evaluator.choosePlacement(engine, best));
+		assert(engine.applyPlacement(best) >= 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testBatchEvaluatorClass()
+	{
+		std::cout << " testBatchEvaluatorClass...";
+
+		// every lane matches the one-board-at-a-time Evaluator, all game long
+		Evaluator evaluator;
+		TetrisEngine engine(17);
+		Placement placements[TetrisEngine::MAX_PLACEMENTS];
+		BatchEvaluator batch;
+		BoardFeatures features[BatchEvaluator::MAX_BOARDS];
+		double scores[BatchEvaluator::MAX_BOARDS];
+		int rowsSeen = 0;
+		for (int piece = 0; piece < 200 && !engine.isGameOver(); piece++) {
+			int count = engine.getPlacements(placements);
+			batch.loadPlacements(engine, placements, count);
+			batch.getFeatures(features);
+			batch.evaluate(evaluator.getWeights(), scores);
+			assert(batch.getBoardCount() == count);
+			for (int i = 0; i < count; i++) {
+				Gameboard preview;
+				int rowsCleared = engine.previewPlacement(placements[i], preview);
+				BoardFeatures expected = Evaluator::getFeatures(preview);
+				assert(batch.getRowsCleared(i) == rowsCleared);
+				assert(features[i].aggregateHeight == expected.aggregateHeight);
+				assert(features[i].holes == expected.holes);
+				assert(features[i].bumpiness == expected.bumpiness);
+				assert(features[i].maxHeight == expected.maxHeight);
+				assert(scores[i] == evaluator.evaluate(preview, rowsCleared));
+				rowsSeen += rowsCleared;
+			}
+			// the AVX2 build of the loops agrees with the default one
+			if (BatchEvaluator::isAvx2Supported()) {
+				int heights[2][BatchEvaluator::MAX_BOARDS], holes[2][BatchEvaluator::MAX_BOARDS];
+				int bumpiness[2][BatchEvaluator::MAX_BOARDS], maxHeights[2][BatchEvaluator::MAX_BOARDS];
+				batch.measureDefault(heights[0], holes[0], bumpiness[0], maxHeights[0]);
+				batch.measureAvx2(heights[1], holes[1], bumpiness[1], maxHeights[1]);
+				for (int i = 0; i < count; i++) {
+					assert(heights[0][i] == heights[1][i] && holes[0][i] == holes[1][i]);
+					assert(bumpiness[0][i] == bumpiness[1][i] && maxHeights[0][i] == maxHeights[1][i]);
+				}
+			}
+			// play randomly-ish so the boards get holes & clear rows
+			engine.applyPlacement(placements[piece % 3 == 0 ? piece % count : 0]);
+			if (engine.isGameOver()) {
+				engine.reset(piece);
+			}
+		}
+		assert(rowsSeen > 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testMctsBotClass()
+	{
+		std::cout << " testMctsBotClass...";
+
+		MctsSettings settings;
+		settings.iterations = 200;
+		settings.rolloutDepth = 4;
+		for (int threads = 1; threads <= 2; threads++) {
+			settings.threads = threads;
+			MctsBot bot(settings);
+			TetrisEngine engine(13);
+			for (int i = 0; i < 5; i++) {
+				Placement best;
+				assert(bot.choosePlacement(engine, best));
+				assert(bot.getLastNodeCount() > 1);
+				assert(engine.applyPlacement(best) >= 0);
+			}
+			// every iteration was backed up to the root exactly once
+			assert(bot.nodes[0].visits.load() == settings.iterations);
+		}
+
+		// no placements once the game is over
+		TetrisEngine over(1);
+		while (!over.isGameOver()) {
+			over.drop();
+			over.lockCurrentShape();
+		}
+		MctsBot bot(settings);
+		Placement best;
+		assert(!bot.choosePlacement(over, best));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testBatchSimulatorClass()
+	{
+		std::cout << " testBatchSimulatorClass...";
+
+		std::vector<GameJob> jobs(6);
+		for (int i = 0; i < static_cast<int>(jobs.size()); i++) {
+			jobs[i].seed = i % 3;	// every game is played twice
+		}
+		// a game plays out the same way whichever thread plays it
+		std::vector<GameResult> single;
+		std::vector<GameResult> multi;
+		BatchSimulator(1, 100).run(jobs, single);
+		BatchSimulator(3, 100).run(jobs, multi);
+		assert(single.size() == jobs.size() && multi.size() == jobs.size());
+		for (int i = 0; i < static_cast<int>(jobs.size()); i++) {
+			assert(single[i].rowsCleared == multi[i].rowsCleared);
+			assert(single[i].piecesPlaced == multi[i].piecesPlaced);
+			assert(single[i].rowsCleared == single[i % 3].rowsCleared);
+			// games are stopped at maxPieces
+			assert(single[i].piecesPlaced <= 100);
+			assert(single[i].toppedOut || single[i].piecesPlaced == 100);
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// poll bot for request id until it answers (or a few seconds pass)
+	static bool waitForPlacement(const BotThread& bot, unsigned int id, Placement& placement)
+	{
+		auto giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!bot.pollPlacement(id, placement)) {
+			if (std::chrono::steady_clock::now() > giveUp) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	static bool testBotThreadClass()
+	{
+		std::cout << " testBotThreadClass...";
+
+		MctsSettings settings;
+		settings.iterations = 200;
+		settings.rolloutDepth = 4;
+		BotThread bot(settings);
+		TetrisEngine engine(21);
+		Placement placement;
+		assert(!bot.pollPlacement(1, placement));	// nothing asked yet
+
+		for (unsigned int id = 1; id <= 5; id++) {
+			bot.requestPlacement(engine, id);
+			assert(waitForPlacement(bot, id, placement));
+			// answers are for the latest request only
+			assert(!bot.pollPlacement(id + 1, placement));
+			assert(engine.applyPlacement(placement) >= 0);
+		}
+
+		// a newer request replaces one the bot hasn't answered yet
+		bot.requestPlacement(engine, 10);
+		bot.requestPlacement(engine, 11);
+		assert(waitForPlacement(bot, 11, placement));
+		assert(engine.applyPlacement(placement) >= 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testDatasetWriterClass()
+	{
+		std::cout << " testDatasetWriterClass...";
+		const char* path = "TestSuite.dataset";
+
+		// self-play: one sample per piece, outcomes count down to the end of the game
+		std::vector<GameJob> jobs(3);
+		for (int i = 0; i < 3; i++) {
+			jobs[i].seed = i + 1;
+		}
+		std::vector<GameResult> results;
+		DatasetWriter dataset;
+		assert(dataset.open(path));
+		BatchSimulator simulator(1, 150);
+		simulator.setDataset(&dataset);
+		simulator.run(jobs, results);
+		assert(dataset.close());
+
+		std::vector<DatasetSample> samples;
+		assert(DatasetWriter::readFile(path, samples));
+		int first = 0;
+		for (const GameResult& result : results) {
+			assert(first + result.piecesPlaced <= static_cast<int>(samples.size()));
+			assert(samples[first].rowsClearedAfter == static_cast<unsigned int>(result.rowsCleared));
+			assert(samples[first].rows[Gameboard::MAX_Y - 1] == 0);	// games start on an empty board
+			for (int i = first; i < first + result.piecesPlaced; i++) {
+				assert(samples[i].toppedOut == result.toppedOut);
+				assert(i == first || samples[i].rowsClearedAfter <= samples[i - 1].rowsClearedAfter);
+			}
+			first += result.piecesPlaced;
+		}
+		assert(first == static_cast<int>(samples.size()));
+
+		// many writers, more than one chunk: nothing is lost or torn
+		assert(dataset.open(path));
+		auto writeMany = [&dataset](int id) {
+			DatasetSample game[100];
+			for (int i = 0; i < 100; i++) {
+				game[i].rowsClearedAfter = id;
+				game[i].placement.x = -3;
+			}
+			for (int i = 0; i < 100; i++) {
+				dataset.write(game, 100);
+			}
+		};
+		std::thread other(writeMany, 1);
+		writeMany(2);
+		other.join();
+		assert(dataset.getSampleCount() == 20000);
+		assert(dataset.close());
+		assert(DatasetWriter::readFile(path, samples));
+		assert(samples.size() == 20000);
+		for (int i = 0; i < 20000; i += 100) {
+			assert(samples[i].rowsClearedAfter == samples[i + 99].rowsClearedAfter);
+			assert(samples[i].placement.x == -3);
+		}
+
+		// a chunk in a codec it can't decode fails the read, unless the caller
+		// asks for it to be skipped (and counted)
+		int skipped = -1;
+		{
+			std::ofstream append(path, std::ios::binary | std::ios::app);
+			// (payload bytes 2, 1 sample, codec 7, then the payload)
+			const char unknown[14] = { 2, 0, 0, 0, 1, 0, 0, 0, 7, 0, 0, 0, 'z', 'z' };
+			append.write(unknown, sizeof(unknown));
+		}
+		assert(!DatasetWriter::readFile(path, samples));
+		assert(DatasetWriter::readFile(path, samples, &skipped));
+		assert(skipped == 1 && samples.size() == 20000);
+		// a file cut off in a chunk header is malformed, not a shorter dataset
+		{
+			std::ofstream append(path, std::ios::binary | std::ios::app);
+			append.write("\x30\0\0\0\1", 5);
+		}
+		assert(!DatasetWriter::readFile(path, samples, &skipped));
+		std::remove(path);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testFrameCounterClass()
+	{
+		std::cout << " testFrameCounterClass...";
+
+		FrameCounter counter(1.0);
+		assert(counter.getFramesPerSecond() == 0.0);
+		// 0.25s of frames isn't a report yet
+		for (int i = 0; i < 25; i++) {
+			assert(!counter.addFrame(0.01, 0.002));
+		}
+		// 100 frames later (one of them slow) the second is over
+		bool reported = false;
+		for (int i = 0; i < 75 && !reported; i++) {
+			reported = counter.addFrame(i == 10 ? 0.26 : 0.01, 0.002);
+		}
+		assert(reported);
+		assert(counter.getFramesPerSecond() > 74.0 && counter.getFramesPerSecond() < 76.0);
+		assert(counter.getWorstFrameMs() > 259.0 && counter.getWorstFrameMs() < 261.0);
+		assert(counter.getAverageDrawMs() > 1.99 && counter.getAverageDrawMs() < 2.01);
+		assert(counter.getReport().find("75 fps") == 0);
+
+		assert(counter.getJitterMs() > 25.0);		// one slow frame among fast ones
+		assert(counter.getCpuPercent() >= 0.0);
+
+		// and counting starts over (steady frames have no jitter)
+		assert(!counter.addFrame(0.5, 0.0));
+		assert(counter.addFrame(0.5, 0.0));
+		assert(counter.getFramesPerSecond() == 2.0 && counter.getWorstFrameMs() == 500.0);
+		assert(counter.getJitterMs() < 0.001);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testFramePacerClass()
+	{
+		std::cout << " testFramePacerClass...";
+
+		PacingMode mode = PacingMode::UNCAPPED;
+		assert(FramePacer::parseMode("idle", mode) && mode == PacingMode::IDLE);
+		assert(!FramePacer::parseMode("fast", mode) && mode == PacingMode::IDLE);
+		// cycling visits every mode and comes back around
+		for (int i = 0; i < 4; i++) {
+			mode = FramePacer::getNextMode(mode);
+			assert(FramePacer::parseMode(FramePacer::getModeName(mode), mode));
+		}
+		assert(mode == PacingMode::IDLE);
+
+		// a wait is never short (and not wildly long)
+		FramePacer pacer(PacingMode::TARGET_FPS, 200.0);
+		auto start = std::chrono::steady_clock::now();
+		pacer.wait(0.004);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		assert(seconds >= 0.004 && seconds < 0.1);
+
+		// 21 frames at 200 fps: the first isn't waited for, then 20 * 5ms
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 21; i++) {
+			pacer.waitForNextFrame();
+		}
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		assert(seconds >= 0.1 && seconds < 0.3);
+
+		// a 1ms period (the simulation thread's) is slept through, not spun:
+		// 300 frames take 0.3s but well under 0.3s of CPU
+		FramePacer fast(PacingMode::TARGET_FPS, 1000.0);
+		double cpuStart = FrameCounter::getProcessCpuSeconds();
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 301; i++) {
+			fast.waitForNextFrame();
+		}
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double cpuSeconds = FrameCounter::getProcessCpuSeconds() - cpuStart;
+		assert(seconds >= 0.3 && seconds < 1.0);
+		assert(cpuSeconds < 0.5 * seconds);
+
+		// other modes don't wait
+		pacer.setMode(PacingMode::VSYNC);
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 100; i++) {
+			pacer.waitForNextFrame();
+		}
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		assert(seconds < 0.05);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	struct TripleBufferValue
+	{
+		int a = 0;
+		int b = 0;
+	};
+
+	static bool testTripleBufferClass()
+	{
+		std::cout << " testTripleBufferClass...";
+
+		TripleBuffer<TripleBufferValue> buffer;
+		assert(!buffer.hasUpdate() && !buffer.update());
+
+		// only the latest value is read
+		buffer.getWriteBuffer().a = 1;
+		buffer.publish();
+		buffer.getWriteBuffer().a = 2;
+		buffer.publish();
+		assert(buffer.hasUpdate() && buffer.update());
+		assert(buffer.getReadBuffer().a == 2);
+		assert(!buffer.update() && buffer.getReadBuffer().a == 2);
+
+		// a writer thread racing a reader: values are never torn,
+		// never go backwards, and the last one always arrives
+		const int LAST = 200000;
+		std::thread writer([&buffer, LAST]() {
+			for (int i = 3; i <= LAST; i++) {
+				TripleBufferValue& value = buffer.getWriteBuffer();
+				value.a = i;
+				value.b = -i;
+				buffer.publish();
+			}
+		});
+		int seen = 2;
+		while (seen != LAST) {
+			if (buffer.update()) {
+				const TripleBufferValue& value = buffer.getReadBuffer();
+				assert(value.a == -value.b);
+				assert(value.a > seen);
+				seen = value.a;
+			}
+		}
+		writer.join();
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testSpscQueueClass()
+	{
+		std::cout << " testSpscQueueClass...";
+
+		SpscQueue<int, 4> queue;
+		int value = 0;
+		assert(!queue.pop(value));
+		// first in, first out, and a full queue drops what doesn't fit
+		for (int i = 1; i <= 4; i++) {
+			assert(queue.push(i));
+		}
+		assert(!queue.push(5));
+		assert(queue.pop(value) && value == 1);
+		assert(queue.push(6));
+		for (int expected : { 2, 3, 4, 6 }) {
+			assert(queue.pop(value) && value == expected);
+		}
+		assert(!queue.pop(value));
+
+		// a writer thread racing a reader: every value arrives, in order
+		const int LAST = 200000;
+		SpscQueue<int, 64> shared;
+		std::thread writer([&shared, LAST]() {
+			for (int i = 1; i <= LAST; i++) {
+				while (!shared.push(i)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+		int seen = 0;
+		while (seen != LAST) {
+			if (shared.pop(value)) {
+				assert(value == seen + 1);
+				seen = value;
+			}
+		}
+		writer.join();
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testLiveGamesClass()
+	{
+		std::cout << " testLiveGamesClass...";
+
+		// before starting, every board is published once (empty)
+		LiveGames games(6, 2, 0.0, 7);
+		assert(games.getGameCount() == 6 && games.getThreadCount() == 2);
+		for (int i = 0; i < games.getGameCount(); i++) {
+			assert(games.update(i));
+			assert(!games.update(i));
+			assert(games.getBoard(i).content[Gameboard::MAX_Y - 1][0] == LiveBoard::EMPTY);
+		}
+
+		// flat out, every board changes and games get finished
+		games.start();
+		std::vector<bool> changed(games.getGameCount(), false);
+		int changedCount = 0;
+		while (changedCount < games.getGameCount() || games.getGamesPlayed() == 0) {
+			for (int i = 0; i < games.getGameCount(); i++) {
+				if (games.update(i) && !changed[i]) {
+					changed[i] = true;
+					changedCount++;
+				}
+			}
+		}
+		games.stop();
+		assert(games.getPiecesPlaced() > 0);
+
+		// once stopped, the latest boards are complete and valid
+		for (int i = 0; i < games.getGameCount(); i++) {
+			games.update(i);
+			assert(!games.update(i));
+			const LiveBoard& board = games.getBoard(i);
+			for (int y = 0; y < Gameboard::MAX_Y; y++) {
+				for (int x = 0; x < Gameboard::MAX_X; x++) {
+					assert(board.content[y][x] == LiveBoard::EMPTY || board.content[y][x] <= static_cast<int>(TetColor::PURPLE));
+				}
+			}
+		}
+
+		// paced, a game places about piecesPerSecond pieces a second
+		LiveGames paced(2, 1, 100.0);
+		paced.start();
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		paced.stop();
+		assert(paced.getPiecesPlaced() > 0 && paced.getPiecesPlaced() <= 2 * 22 + 2);
+
+		// a watcher waiting for a round wakes up for it, and times out without one
+		assert(paced.waitForRound(0.0));		// (the rounds above)
+		assert(!paced.waitForRound(0.01));
+		LiveGames slow(1, 1, 20.0);
+		slow.start();
+		assert(slow.waitForRound(1.0));			// (the first round is at once)
+		auto start = std::chrono::steady_clock::now();
+		assert(slow.waitForRound(1.0));			// (the next one 50ms later)
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		assert(seconds < 0.5);
+		slow.stop();
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testSoftwareRendererClass()
+	{
+		std::cout << " testSoftwareRendererClass...";
+
+		// the SIMD blend matches the scalar one (odd counts cover the tails)
+		std::vector<std::uint8_t> src(4 * 37), dst(4 * 37), expected;
+		unsigned int random = 12345;
+		for (int tintAlpha : { 0, 60, 90, 255 }) {
+			for (int count : { 1, 4, 5, 37 }) {
+				for (size_t i = 0; i < src.size(); i++) {
+					random = random * 1103515245 + 12345;
+					src[i] = static_cast<std::uint8_t>(random >> 16);
+					dst[i] = static_cast<std::uint8_t>(random >> 8);
+				}
+				expected = dst;
+				Rgba tint(255, 200, 100, static_cast<std::uint8_t>(tintAlpha));
+				SoftwareRenderer::blendRowScalar(expected.data(), src.data(), count, tint);
+				SoftwareRenderer::blendRow(dst.data(), src.data(), count, tint);
+				assert(dst == expected);
+			}
+		}
+		// opaque over anything is the source, transparent leaves dst alone
+		std::uint8_t pixel[4] = { 10, 20, 30, 255 };
+		std::uint8_t color[4] = { 200, 100, 50, 255 };
+		SoftwareRenderer::blendRow(pixel, color, 1, Rgba());
+		assert(pixel[0] == 200 && pixel[1] == 100 && pixel[2] == 50 && pixel[3] == 255);
+		SoftwareRenderer::blendRow(pixel, color, 1, Rgba(255, 255, 255, 0));
+		assert(pixel[0] == 200 && pixel[1] == 100 && pixel[2] == 50);
+
+		// 2x2 tiles: color i is (i * 10, 0, 0), opaque
+		const int TILE = 2, COLORS = 7;
+		std::vector<std::uint8_t> tiles(TILE * COLORS * TILE * 4, 255);
+		for (int x = 0; x < TILE * COLORS; x++) {
+			for (int y = 0; y < TILE; y++) {
+				std::uint8_t* p = &tiles[(y * TILE * COLORS + x) * 4];
+				p[0] = static_cast<std::uint8_t>(x / TILE * 10);
+				p[1] = p[2] = 0;
+			}
+		}
+		SoftwareRenderer renderer(40, 50);
+		renderer.setTiles(tiles.data(), TILE * COLORS, TILE);
+		auto red = [&renderer](int x, int y) { return renderer.getPixels()[(y * renderer.getWidth() + x) * 4]; };
+
+		// a block lands at origin + loc * tile size
+		renderer.clear();
+		assert(red(4, 6) == 255);
+		renderer.drawBlock(2, 3, TetColor::GREEN, Point(0, 0));
+		assert(red(4, 6) == 30 && red(5, 7) == 30 && red(6, 6) == 255);
+		// and is clipped at the frame's edges
+		renderer.drawBlock(-1, -1, TetColor::RED, Point(1, 1));
+		renderer.drawBlock(19, 24, TetColor::YELLOW, Point(1, 1));
+		assert(red(0, 0) == 0 && red(39, 49) == 20);
+		renderer.drawBlock(-5, -5, TetColor::RED, Point(0, 0));
+
+		// a game is drawn as TetrisGame draws it: the current shape on the board
+		TetrisEngine engine(3);
+		renderer.drawGame(engine, Point(0, 10), Point(30, 0));
+		assert(red(4, 6) == 255);
+		BlockLocs locs = engine.getCurrentShape().getBlockLocsMappedToGrid();
+		for (const Point& loc : locs) {
+			if (loc.getY() >= 0) {
+				assert(red(loc.getX() * TILE, 10 + loc.getY() * TILE) == static_cast<int>(engine.getCurrentShape().getColor()) * 10);
+			}
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTerminalScreenClass()
+	{
+		std::cout << " testTerminalScreenClass...";
+
+		// the first frame draws every cell
+		TerminalScreen screen(6, 3);
+		std::string output;
+		screen.clear();
+		screen.putText(1, 1, "ab");
+		assert(screen.render(output) == 18);
+		assert(output.find("\x1b[1;1H") == 0 && output.find("ab") != std::string::npos);
+
+		// the same frame again sends nothing
+		output.clear();
+		screen.clear();
+		screen.putText(1, 1, "ab");
+		assert(screen.render(output) == 0 && output.empty());
+
+		// one changed cell: a cursor move and the character
+		output.clear();
+		screen.clear();
+		screen.putText(1, 1, "ax");
+		assert(screen.render(output) == 1);
+		assert(output == "\x1b[2;3Hx");
+
+		// a run of changed cells needs one cursor move, a color is set once
+		// (and reset at the end)
+		output.clear();
+		screen.clear();
+		screen.putText(1, 1, "ax");
+		screen.setCell(2, 2, ' ', 196);
+		screen.setCell(3, 2, ' ', 196);
+		screen.setCell(9, 9, '!');		// off the screen: ignored
+		assert(screen.render(output) == 2);
+		assert(output == "\x1b[3;3H\x1b[48;5;196m  \x1b[0m");
+
+		// invalidate() redraws everything
+		output.clear();
+		screen.invalidate();
+		assert(screen.render(output) == 18);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testFrameProfilerClass()
+	{
+		std::cout << " testFrameProfilerClass...";
+
+		FrameProfiler profiler;
+		assert(profiler.getStats(ProfilePhase::DRAW).samples == 0);
+
+		// 1..100 ms: p50 is the 50th, p99 the 99th
+		for (int ms = 100; ms >= 1; ms--) {
+			profiler.record(ProfilePhase::DRAW, ms * 1000000);
+		}
+		PhaseStats stats = profiler.getStats(ProfilePhase::DRAW);
+		assert(stats.samples == 100);
+		assert(std::abs(stats.p50Ms - 50.0) < 1e-9 && std::abs(stats.p99Ms - 99.0) < 1e-9);
+		assert(std::abs(stats.maxMs - 100.0) < 1e-9);
+		assert(profiler.getStats(ProfilePhase::TICK).samples == 0);
+
+		// the ring keeps the latest RING_SIZE times only
+		for (int i = 0; i < FrameProfiler::RING_SIZE; i++) {
+			profiler.record(ProfilePhase::DRAW, 2000000);
+		}
+		stats = profiler.getStats(ProfilePhase::DRAW);
+		assert(stats.samples == FrameProfiler::RING_SIZE && std::abs(stats.maxMs - 2.0) < 1e-9);
+
+		// the histogram puts each time in the first bucket it fits
+		int counts[FrameProfiler::HISTOGRAM_BUCKETS];
+		profiler.record(ProfilePhase::FRAME, 100000);			// 0.1ms
+		profiler.record(ProfilePhase::FRAME, 16000000);			// 16ms
+		profiler.record(ProfilePhase::FRAME, 500000000);		// 500ms
+		profiler.getHistogram(ProfilePhase::FRAME, counts);
+		assert(counts[0] == 1 && counts[FrameProfiler::HISTOGRAM_BUCKETS - 1] == 1);
+		int bucket = 0;
+		while (FrameProfiler::getHistogramBucketMs(bucket) < 16.0) {
+			bucket++;
+		}
+		assert(counts[bucket] == 1);
+
+		// a timer records one time, nothing without a profiler
+		{
+			ProfileTimer timer(&profiler, ProfilePhase::TICK);
+			ProfileTimer nothing(nullptr, ProfilePhase::TICK);
+		}
+		assert(profiler.getStats(ProfilePhase::TICK).samples == 1);
+
+		// a writer thread and a reader: stats are always made of whole samples
+		std::thread writer([&profiler]() {
+			for (int i = 0; i < 100000; i++) {
+				profiler.record(ProfilePhase::GAME_LOOP, 1000000 + (i % 2) * 1000000);
+			}
+		});
+		for (int i = 0; i < 200; i++) {
+			stats = profiler.getStats(ProfilePhase::GAME_LOOP);
+			assert(stats.samples == 0 || (stats.p50Ms >= 1.0 && stats.maxMs <= 2.0));
+		}
+		writer.join();
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTracerClass()
+	{
+		std::cout << " testTracerClass...";
+
+		const char* path = "TestSuite.trace";
+
+		// off: a scope records nothing
+		Tracer::setEnabled(false);
+		int events = Tracer::getEventCount();
+		{
+			TRACE_SCOPE("test off");
+		}
+		assert(Tracer::getEventCount() == events);
+
+		// on: every scope of every thread is recorded, under its thread's name
+		// (a new capture, so the earlier ones don't count)
+		Tracer::setEnabled(true);
+		std::thread other([]() {
+			Tracer::setThreadName("test thread");
+			for (int i = 0; i < 1000; i++) {
+				TRACE_SCOPE("test other");
+			}
+		});
+		for (int i = 0; i < 1000; i++) {
+			TRACE_SCOPE("test main");
+		}
+		other.join();
+		Tracer::setEnabled(false);
+		assert(Tracer::getEventCount() == 2000);
+
+		// the JSON holds both threads' events, each a complete one ("X")
+		assert(Tracer::writeJson(path));
+		std::FILE* file = std::fopen(path, "rb");
+		assert(file);
+		std::string json;
+		char chunk[4096];
+		size_t read;
+		while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+			json.append(chunk, read);
+		}
+		std::fclose(file);
+		std::remove(path);
+		assert(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+		assert(json.find("\"args\":{\"name\":\"test thread\"}") != std::string::npos);
+		assert(json.find("test off") == std::string::npos);
+		int mainCount = 0;
+		int otherCount = 0;
+		for (size_t at = json.find("\"ph\":\"X\""); at != std::string::npos; at = json.find("\"ph\":\"X\"", at + 1)) {
+			mainCount += json.compare(at + 16, 11, "\"test main\"") == 0;
+			otherCount += json.compare(at + 16, 12, "\"test other\"") == 0;
+		}
+		assert(mainCount == 1000 && otherCount == 1000);
+		assert(json.compare(json.size() - 4, 4, "\n]}\n") == 0);
+
+		// two captures in a row, the first filling the buffer: the second gets
+		// the whole buffer again, and only its own events are written
+		Tracer::setEnabled(true);
+		for (int i = 0; i < Tracer::EVENTS_PER_THREAD + 10; i++) {
+			TRACE_SCOPE("test first");
+		}
+		Tracer::setEnabled(false);
+		assert(Tracer::getEventCount() == Tracer::EVENTS_PER_THREAD && Tracer::getDroppedCount() == 10);
+		Tracer::setEnabled(true);
+		assert(Tracer::getEventCount() == 0 && Tracer::getDroppedCount() == 0);
+		for (int i = 0; i < 100; i++) {
+			TRACE_SCOPE("test second");
+		}
+		Tracer::setEnabled(false);
+		assert(Tracer::getEventCount() == 100 && Tracer::getDroppedCount() == 0);
+		assert(Tracer::writeJson(path));
+		file = std::fopen(path, "rb");
+		assert(file);
+		json.clear();
+		while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+			json.append(chunk, read);
+		}
+		std::fclose(file);
+		std::remove(path);
+		assert(json.find("test first") == std::string::npos && json.find("test main") == std::string::npos);
+		int secondCount = 0;
+		for (size_t at = json.find("\"test second\""); at != std::string::npos; at = json.find("\"test second\"", at + 1)) {
+			secondCount++;
+		}
+		assert(secondCount == 100);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testAllocationCounterClass()
+	{
+		std::cout << " testAllocationCounterClass...";
+
+		// every new is counted, on the thread that made it
+		std::uint64_t before = AllocationCounter::getThreadCount();
+		std::uint64_t bytesBefore = AllocationCounter::getThreadBytes();
+		int* number = new int(1);
+		std::vector<int> numbers(10);
+		delete number;
+		std::thread other([]() {
+			for (int i = 0; i < 100; i++) {
+				delete new int(i);
+			}
+		});
+		other.join();
+		std::uint64_t allocations = AllocationCounter::getThreadCount() - before;
+		std::uint64_t bytes = AllocationCounter::getThreadBytes() - bytesBefore;
+		if (AllocationCounter::isCounting()) {
+			// (starting the thread may allocate too, but not 100 times)
+			assert(allocations >= 2 && allocations < 50);
+			assert(bytes >= sizeof(int) + 10 * sizeof(int));
+		}
+		else {
+			assert(allocations == 0 && bytes == 0);
+		}
+
+		// steady-state gameplay doesn't allocate: the moves, ticks, drops, locks
+		// and row clears of a game, with the bot choosing where the shapes go and
+		// the engine copied as TetrisGame publishes its Snapshots
+		TetrisEngine engine(5);
+		TetrisEngine snapshot;
+		Evaluator evaluator;
+		Placement placement;
+		evaluator.choosePlacement(engine, placement);		// (builds its tables)
+		before = AllocationCounter::getThreadCount();
+		int rowsCleared = 0;
+		for (int piece = 0; piece < 300; piece++) {
+			if (engine.isGameOver()) {
+				engine.reset(piece);
+			}
+			int score = engine.getScore();
+			evaluator.choosePlacement(engine, placement);
+			for (int r = 0; r < placement.rotation; r++) {
+				engine.attemptRotate();
+			}
+			while (engine.getCurrentShape().getGridLoc().getX() != placement.x
+				&& engine.attemptMove(placement.x < engine.getCurrentShape().getGridLoc().getX() ? -1 : 1, 0)) {
+				snapshot = engine;
+			}
+			if (piece % 2 == 0) {
+				engine.drop();
+			}
+			while (!engine.tick()) {
+				snapshot = engine;
+			}
+			rowsCleared += engine.getScore() - score;
+		}
+		assert(rowsCleared > 0);
+		allocations = AllocationCounter::getThreadCount() - before;
+		assert(allocations == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testLatencyProbeClass()
+	{
+		std::cout << " testLatencyProbeClass...";
+
+		using ms = std::chrono::milliseconds;
+		FrameProfiler profiler;
+		LatencyProbe probe(&profiler);
+		LatencyProbe::Clock::time_point start = LatencyProbe::Clock::now();
+
+		// two keys, shown by the same frame 20ms after the first
+		unsigned int first = probe.onInput(start);
+		unsigned int second = probe.onInput(start + ms(10));
+		assert(first != 0 && second > first);
+		assert(probe.onFrameDisplayed(0, start + ms(15)) == 0);		// (a frame from before them)
+		assert(probe.onFrameDisplayed(second, start + ms(20)) == 2);
+		assert(probe.onFrameDisplayed(second, start + ms(37)) == 0);	// (already timed)
+		assert(probe.getCount() == 2);
+		assert(std::abs(probe.getMeanMs() - 15.0) < 1e-6 && std::abs(probe.getMaxMs() - 20.0) < 1e-6);
+		int bucket10 = 0;
+		while (LatencyProbe::getHistogramBucketMs(bucket10) < 10.0) {
+			bucket10++;
+		}
+		int bucket20 = 0;
+		while (LatencyProbe::getHistogramBucketMs(bucket20) < 20.0) {
+			bucket20++;
+		}
+		assert(bucket10 != bucket20);
+		assert(probe.getHistogramCount(bucket10) == 1 && probe.getHistogramCount(bucket20) == 1);
+		PhaseStats stats = profiler.getStats(ProfilePhase::INPUT_LATENCY);
+		assert(stats.samples == 2 && std::abs(stats.maxMs - 20.0) < 1e-6);
+
+		// a frame that shows only some of the keys times only those
+		unsigned int third = probe.onInput(start + ms(100));
+		probe.onInput(start + ms(101));
+		assert(probe.onFrameDisplayed(third, start + ms(150)) == 1);
+		assert(probe.getCount() == 3 && std::abs(probe.getMaxMs() - 50.0) < 1e-6);
+
+		// more keys in flight than MAX_PENDING: only the latest are timed
+		unsigned int last = 0;
+		for (int i = 0; i < LatencyProbe::MAX_PENDING + 10; i++) {
+			last = probe.onInput(start + ms(200));
+		}
+		assert(probe.onFrameDisplayed(last, start + ms(500)) == LatencyProbe::MAX_PENDING);
+		assert(probe.getHistogramCount(LatencyProbe::HISTOGRAM_BUCKETS - 1) == LatencyProbe::MAX_PENDING);
+		assert(probe.getReport().find("input latency: 67 inputs") == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testLatencyHistogramClass()
+	{
+		std::cout << " testLatencyHistogramClass...";
+
+		LatencyHistogram histogram;
+		assert(histogram.getCount() == 0 && histogram.getPercentileNs(50) == 0.0);
+
+		// small durations are exact
+		for (int ns = 1; ns <= 4; ns++) {
+			histogram.add(ns);
+		}
+		assert(histogram.getPercentileNs(50) == 2.0 && histogram.getPercentileNs(100) == 4.0);
+		assert(histogram.getMeanNs() == 2.5 && histogram.getMaxNs() == 4);
+
+		// 1..100000ns: percentiles are within a bucket's width (12.5%) above the exact ones
+		histogram.clear();
+		for (int ns = 1; ns <= 100000; ns++) {
+			histogram.add(ns);
+		}
+		const double exact[] = { 50000, 99000, 99900 };
+		const double percents[] = { 50, 99, 99.9 };
+		for (int i = 0; i < 3; i++) {
+			double ns = histogram.getPercentileNs(percents[i]);
+			assert(ns >= exact[i] && ns <= exact[i] * 1.125);
+		}
+		assert(histogram.getPercentileNs(100) == 100000.0 && histogram.getMaxNs() == 100000);
+
+		// one slow outlier in a thousand shows up at p99.9 and max, not p99
+		histogram.clear();
+		for (int i = 0; i < 999; i++) {
+			histogram.add(1000);
+		}
+		histogram.add(5000000);
+		assert(histogram.getPercentileNs(99) <= 1000 * 1.125);
+		assert(histogram.getPercentileNs(99.9) <= 1000 * 1.125 && histogram.getPercentileNs(99.95) == 5000000.0);
+
+		// merging, and durations too long for the buckets
+		LatencyHistogram other;
+		other.add(UINT64_MAX / 2);
+		histogram.add(other);
+		assert(histogram.getCount() == 1001 && histogram.getMaxNs() == UINT64_MAX / 2);
+		assert(histogram.getPercentileNs(100) == static_cast<double>(UINT64_MAX / 2));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testStepMonitorClass()
+	{
+		std::cout << " testStepMonitorClass...";
+
+		// a saved game plays on exactly as the original does
+		TetrisEngine engine(7);
+		Evaluator evaluator;
+		Placement placement;
+		for (int i = 0; i < 40; i++) {
+			evaluator.choosePlacement(engine, placement);
+			engine.applyPlacement(placement);
+		}
+		engine.attemptRotate();
+		engine.attemptMove(1, 1);
+		std::stringstream saved;
+		engine.write(saved);
+		TetrisEngine loaded;
+		assert(loaded.read(saved));
+		assert(loaded.isSamePosition(engine) && loaded.getScore() == engine.getScore()
+			&& loaded.getPiecesPlaced() == engine.getPiecesPlaced());
+		for (int i = 0; i < 200 && !engine.isGameOver(); i++) {
+			assert(engine.tick() == loaded.tick());
+			assert(loaded.isSamePosition(engine));
+		}
+		std::stringstream broken(saved.str().substr(0, 40));
+		assert(!loaded.read(broken) && loaded.isSamePosition(engine));
+
+		// steps do what the engine does
+		TetrisEngine stepped(3);
+		TetrisEngine expected(3);
+		assert(StepMonitor::runStep(stepped, EngineStep::DROP));
+		expected.drop();
+		expected.lockCurrentShape();
+		assert(stepped.isSamePosition(expected) && stepped.getPiecesPlaced() == 1);
+
+		// every step is timed, and the slowest is kept with the game before it
+		StepMonitor monitor;
+		TetrisEngine game(5);
+		monitor.step(game, EngineStep::TICK);
+		TetrisEngine slowest = game;
+		monitor.record(EngineStep::LOCK, StepMonitor::BUDGET_NS * 2, slowest);
+		monitor.step(game, EngineStep::DROP);
+		monitor.record(EngineStep::TICK, 100, game);
+		assert(monitor.getCount() == 4 && monitor.getOverBudgetCount() >= 1);
+		assert(monitor.getMaxNs() >= StepMonitor::BUDGET_NS * 2);
+		assert(monitor.getReport().find("4 engine steps") == 0);
+
+		const char* path = "TestSuite.steps";
+		if (monitor.getMaxNs() == StepMonitor::BUDGET_NS * 2) {	// (unless a real step was slower still)
+			assert(monitor.writeSlowest(path));
+			EngineStep step = EngineStep::TICK;
+			std::uint64_t nanoseconds = 0;
+			TetrisEngine before;
+			assert(StepMonitor::readSlowest(path, step, nanoseconds, before));
+			assert(step == EngineStep::LOCK && nanoseconds == StepMonitor::BUDGET_NS * 2);
+			assert(before.isSamePosition(slowest));
+			std::remove(path);
+		}
+		assert(!StepMonitor().writeSlowest(path));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testMetricsClass()
+	{
+		std::cout << " testMetricsClass...";
+
+		// off, nothing is counted
+		std::string lines;
+		Metrics::collect(1.0, lines);
+		Metrics::add(Metric::PIECES, 100);
+		Metrics::record(Metric::INPUT_QUEUE, 100);
+		lines.clear();
+		Metrics::collect(1.0, lines);
+		assert(lines.find("tetris.pieces_per_sec:0|g\n") != std::string::npos);
+		assert(lines.find("tetris.input_queue:0|g\n") != std::string::npos);
+
+		// on, every thread's counts add up; rates are per second, means & maxima of the interval
+		Metrics::setEnabled(true);
+		std::thread other([]() {
+			for (int i = 0; i < 1000; i++) {
+				Metrics::add(Metric::PIECES);
+			}
+			Metrics::record(Metric::INPUT_QUEUE, 3);
+		});
+		for (int i = 0; i < 1000; i++) {
+			Metrics::add(Metric::PIECES);
+		}
+		Metrics::add(Metric::ROWS, 7);
+		Metrics::record(Metric::FRAME_TIME, 10000000);
+		Metrics::record(Metric::FRAME_TIME, 20000000);
+		Metrics::record(Metric::INPUT_QUEUE, 2);
+		other.join();
+		lines.clear();
+		Metrics::collect(2.0, lines);
+		assert(lines.find("tetris.pieces_per_sec:1000|g\n") != std::string::npos);
+		assert(lines.find("tetris.rows_cleared:7|c\n") != std::string::npos);
+		assert(lines.find("tetris.frame_ms:15|g\n") != std::string::npos);
+		assert(lines.find("tetris.input_queue:3|g\n") != std::string::npos);
+
+		// the next interval starts from nothing (and a mean with no values isn't sent)
+		lines.clear();
+		Metrics::collect(1.0, lines);
+		Metrics::setEnabled(false);
+		assert(lines.find("tetris.pieces_per_sec:0|g\n") != std::string::npos);
+		assert(lines.find("tetris.rows_cleared:0|c\n") != std::string::npos);
+		assert(lines.find("frame_ms") == std::string::npos);
+		assert(lines.find("tetris.input_queue:0|g\n") != std::string::npos);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
 #ifdef GAMEBOARD_H
 	static bool isGameboardEmpty(Gameboard &g)
 	{
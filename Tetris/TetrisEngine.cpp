@@ -0,0 +1,442 @@
+#include "TetrisEngine.h"
+#include <algorithm>
+#include <assert.h>
+#include <string>
+
+// The block offsets of every shape in every orientation, built once from
+// Tetromino (so the two always agree) and shared by all engines.
+struct ShapeTable
+{
+	Point offsets[static_cast<int>(TetShape::TetShapeCount)][TetrisEngine::MAX_ROTATIONS][4];
+	int rotationCount[static_cast<int>(TetShape::TetShapeCount)];
+
+	ShapeTable()
+	{
+		for (int s{ 0 }; s < static_cast<int>(TetShape::TetShapeCount); s++) {
+			GridTetromino shape;
+			shape.setShape(static_cast<TetShape>(s));
+			rotationCount[s] = 0;
+			for (int r{ 0 }; r < TetrisEngine::MAX_ROTATIONS; r++) {
+				BlockLocs locs{ shape.getBlockLocsMappedToGrid() };
+				assert(locs.size() == 4);
+				std::copy(locs.begin(), locs.end(), offsets[s][r]);
+				// an orientation is only worth searching if it covers a different
+				// set of cells (ignoring where it sits) than the ones before it
+				bool distinct{ true };
+				for (int earlier{ 0 }; earlier < r; earlier++) {
+					if (isSameFootprint(offsets[s][earlier], offsets[s][r])) {
+						distinct = false;
+					}
+				}
+				if (distinct) {
+					rotationCount[s] = r + 1;
+				}
+				shape.rotateCW();
+			}
+		}
+	}
+
+	// return true if a and b cover the same cells once both are moved to the origin
+	static bool isSameFootprint(const Point a[], const Point b[])
+	{
+		int keysA[4];
+		int keysB[4];
+		makeFootprint(a, keysA);
+		makeFootprint(b, keysB);
+		return std::equal(keysA, keysA + 4, keysB);
+	}
+
+	// reduce 4 offsets to sorted cell keys relative to their top left corner
+	static void makeFootprint(const Point locs[], int keys[])
+	{
+		int minX{ locs[0].getX() };
+		int minY{ locs[0].getY() };
+		for (int i{ 1 }; i < 4; i++) {
+			minX = std::min(minX, locs[i].getX());
+			minY = std::min(minY, locs[i].getY());
+		}
+		for (int i{ 0 }; i < 4; i++) {
+			keys[i] = (locs[i].getY() - minY) * 4 + (locs[i].getX() - minX);
+		}
+		std::sort(keys, keys + 4);
+	}
+};
+
+static const ShapeTable& getShapeTable()
+{
+	static const ShapeTable table;
+	return table;
+}
+
+// constructor, start a new game using seed for the shape sequence
+TetrisEngine::TetrisEngine(unsigned long long seed) {
+	reset(seed);
+}
+
+// reset everything for a new game
+//  - set score & piece count to 0,
+//  - clear the gameboard,
+//  - reseed the random generator,
+//  - pick & spawn next shape
+//  - pick next shape again
+void TetrisEngine::reset(unsigned long long seed) {
+	score = 0;
+	piecesPlaced = 0;
+	gameOver = false;
+	board.empty();
+	rng.setSeed(seed);
+	pickNextShape();
+	spawnNextShape();
+	pickNextShape();
+}
+
+// reseed the random generator without touching the board or the
+// current & next shapes. Only shapes picked from now on are affected
+// (bots use this to sample different futures from the same snapshot).
+void TetrisEngine::reseedRandom(unsigned long long seed) {
+	rng.setSeed(seed);
+}
+
+// return true if other has the same gameboard, current shape (and loc)
+// and next shape as this engine (score and random state are ignored)
+bool TetrisEngine::isSamePosition(const TetrisEngine& other) const {
+	if (gameOver != other.gameOver || !(board == other.board)
+		|| currentShape.getShape() != other.currentShape.getShape()
+		|| nextShape.getShape() != other.nextShape.getShape()) {
+		return false;
+	}
+	BlockLocs locs{ currentShape.getBlockLocsMappedToGrid() };
+	BlockLocs otherLocs{ other.currentShape.getBlockLocsMappedToGrid() };
+	for (int i{ 0 }; i < locs.size(); i++) {
+		if (locs[i].getX() != otherLocs[i].getX() || locs[i].getY() != otherLocs[i].getY()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// write the whole game (gameboard, current shape & its loc and rotation,
+// next shape, random state, score ...) to out as text, for read()
+void TetrisEngine::write(std::ostream& out) const {
+	// the gameboard a row per line: '.' for empty, else the block's color
+	out << "board\n";
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+			int content{ board.getContent(x, y) };
+			out << (content == Gameboard::EMPTY_BLOCK ? '.' : static_cast<char>('0' + content));
+		}
+		out << '\n';
+	}
+	// (a shape's rotation is which of its table's orientations its blocks match)
+	Point loc{ currentShape.getGridLoc() };
+	BlockLocs locs{ currentShape.getBlockLocsMappedToGrid() };
+	int rotation{ -1 };
+	for (int r{ 0 }; r < MAX_ROTATIONS && rotation < 0; r++) {
+		const Point* offsets{ getShapeOffsets(currentShape.getShape(), r) };
+		rotation = r;
+		for (int i{ 0 }; i < locs.size(); i++) {
+			if (locs[i].getX() - loc.getX() != offsets[i].getX() || locs[i].getY() - loc.getY() != offsets[i].getY()) {
+				rotation = -1;
+			}
+		}
+	}
+	out << "current " << static_cast<int>(currentShape.getShape()) << ' ' << loc.getX() << ' ' << loc.getY() << ' ' << rotation << '\n';
+	out << "next " << static_cast<int>(nextShape.getShape()) << '\n';
+	out << "random " << rng.getState() << '\n';
+	out << "score " << score << ' ' << piecesPlaced << ' ' << gameOver << '\n';
+}
+
+// read a game written by write(), which then plays on exactly as the
+// written one would have.
+//   return false (leaving this engine untouched) if in doesn't hold one.
+bool TetrisEngine::read(std::istream& in) {
+	const int SHAPE_COUNT{ static_cast<int>(TetShape::TetShapeCount) };
+	TetrisEngine game;
+	std::string label;
+	if (!(in >> label) || label != "board") {
+		return false;
+	}
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++) {
+		std::string row;
+		if (!(in >> row) || row.size() != static_cast<size_t>(Gameboard::MAX_X)) {
+			return false;
+		}
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++) {
+			if (row[x] == '.') {
+				game.board.setContent(x, y, Gameboard::EMPTY_BLOCK);
+			}
+			else if (row[x] >= '0' && row[x] < '0' + SHAPE_COUNT) {
+				game.board.setContent(x, y, row[x] - '0');
+			}
+			else {
+				return false;
+			}
+		}
+	}
+	int shape{ 0 };
+	int x{ 0 };
+	int y{ 0 };
+	int rotation{ 0 };
+	int next{ 0 };
+	unsigned long long randomState{ 0 };
+	if (!(in >> label >> shape >> x >> y >> rotation) || label != "current" || shape < 0 || shape >= SHAPE_COUNT
+		|| rotation < 0 || rotation >= MAX_ROTATIONS
+		|| !(in >> label >> next) || label != "next" || next < 0 || next >= SHAPE_COUNT
+		|| !(in >> label >> randomState) || label != "random"
+		|| !(in >> label >> game.score >> game.piecesPlaced >> game.gameOver) || label != "score") {
+		return false;
+	}
+	game.currentShape.setShape(static_cast<TetShape>(shape));
+	for (int r{ 0 }; r < rotation; r++) {
+		game.currentShape.rotateCW();
+	}
+	game.currentShape.setGridLoc(x, y);
+	game.nextShape.setShape(static_cast<TetShape>(next));
+	game.rng.setState(randomState);
+	*this = game;
+	return true;
+}
+
+// attempt to rotate the currentShape clockwise, return true if it rotated
+bool TetrisEngine::attemptRotate() {
+	return attemptRotate(currentShape);
+}
+
+// attempt to move the currentShape by x,y, return true if it moved
+bool TetrisEngine::attemptMove(int x, int y) {
+	return attemptMove(currentShape, x, y);
+}
+
+// drop the currentShape as far as it can legally go (does not lock it)
+void TetrisEngine::drop() {
+	drop(currentShape);
+}
+
+// A tick() forces the currentShape to move down one row. If it
+// can move no further it is locked (see lockCurrentShape()).
+// return true if the currentShape was locked.
+bool TetrisEngine::tick() {
+	if (!attemptMove(currentShape, 0, 1)) {
+		lockCurrentShape();
+		return true;
+	}
+	return false;
+}
+
+// copy the currentShape's blocks onto the gameboard, then
+//   - remove completed rows (adding them to the score),
+//   - spawn the next shape & pick a new next shape,
+//   - flag the game as over if the new shape can't spawn
+//     (or if the locked shape stuck out of the top of the board).
+// return the number of rows cleared.
+int TetrisEngine::lockCurrentShape() {
+	BlockLocs locs{ currentShape.getBlockLocsMappedToGrid() };
+	int content{ static_cast<int>(currentShape.getColor()) };
+	bool aboveBoard{ false };
+	for (const Point& loc : locs) {
+		if (loc.getY() < 0) {
+			aboveBoard = true;
+		}
+		else {
+			board.setContent(loc, content);
+		}
+	}
+	return finishLock(aboveBoard);
+}
+
+// test if a rotation is legal on the tetromino,
+//   if so, rotate it.
+//	 return true/false to indicate successful movement
+bool TetrisEngine::attemptRotate(GridTetromino& shape) const {
+	GridTetromino temp = shape;
+	temp.rotateCW();
+	if (isPositionLegal(temp)) {
+		shape.rotateCW();
+		return true;
+	}
+	else {
+		return false;
+	}
+}
+
+// test if a move is legal on the tetromino, if so, move it.
+//	 return true/false to indicate successful movement
+bool TetrisEngine::attemptMove(GridTetromino& shape, int x, int y) const {
+	GridTetromino temp = shape;
+	temp.move(x, y);
+	if (isPositionLegal(temp)) {
+		shape.move(x, y);
+		return true;
+	}
+	else {
+		return false;
+	}
+}
+
+// drops the tetromino vertically as far as it can legally go.
+void TetrisEngine::drop(GridTetromino& shape) const {
+	while (attemptMove(shape, 0, 1)) {}
+}
+
+// return true if shape is within borders (isShapeWithinBorders())
+//	 and does NOT intersect locked blocks (!doesShapeIntersectLockedBlocks())
+bool TetrisEngine::isPositionLegal(const GridTetromino& shape) const {
+	return (isShapeWithinBorders(shape) && !doesShapeIntersectLockedBlocks(shape));
+}
+
+// fill placements with every distinct spot the currentShape can come to
+// rest at by rotating at the spawn loc, sliding sideways and dropping.
+//   placements must have room for MAX_PLACEMENTS entries.
+//   return the number of placements written (0 once the game is over).
+int TetrisEngine::getPlacements(Placement placements[]) const {
+	if (gameOver) {
+		return 0;
+	}
+	int count{ 0 };
+	TetShape shape{ currentShape.getShape() };
+	Point spawn{ board.getSpawnLoc() };
+	for (int r{ 0 }; r < getRotationCount(shape); r++) {
+		const Point* offsets{ getShapeOffsets(shape, r) };
+		// every rotation happens at the spawn loc, so if this one is
+		// blocked none of the later ones can be reached either
+		if (!areOffsetsLegal(offsets, spawn.getX(), spawn.getY())) {
+			break;
+		}
+		// slide left from the spawn loc, then right, dropping at every column
+		for (int direction{ -1 }; direction <= 1; direction += 2) {
+			int x{ direction < 0 ? spawn.getX() : spawn.getX() + 1 };
+			while (areOffsetsLegal(offsets, x, spawn.getY())) {
+				int y{ spawn.getY() };
+				while (areOffsetsLegal(offsets, x, y + 1)) {
+					y++;
+				}
+				assert(count < MAX_PLACEMENTS);
+				placements[count].rotation = r;
+				placements[count].x = x;
+				placements[count].y = y;
+				count++;
+				x += direction;
+			}
+		}
+	}
+	return count;
+}
+
+// rotate, slide and drop the currentShape as described by placement
+// and lock it (see lockCurrentShape()).
+//   return the number of rows cleared, or -1 if placement is not a
+//   legal resting spot for the currentShape.
+int TetrisEngine::applyPlacement(const Placement& placement) {
+	const Point* offsets{ getShapeOffsets(currentShape.getShape(), placement.rotation) };
+	if (gameOver || !areOffsetsLegal(offsets, placement.x, placement.y)
+		|| areOffsetsLegal(offsets, placement.x, placement.y + 1)) {
+		return -1;
+	}
+	// write the blocks straight to the board rather than stepping the
+	// currentShape there one move at a time (this is the rollout hot path)
+	int content{ static_cast<int>(currentShape.getColor()) };
+	bool aboveBoard{ false };
+	for (int i{ 0 }; i < 4; i++) {
+		int y{ placement.y + offsets[i].getY() };
+		if (y < 0) {
+			aboveBoard = true;
+		}
+		else {
+			board.setContent(placement.x + offsets[i].getX(), y, content);
+		}
+	}
+	return finishLock(aboveBoard);
+}
+
+// copy the gameboard into result and lock the currentShape onto it at
+// placement, without changing this engine.
+//   return the number of rows cleared on result.
+int TetrisEngine::previewPlacement(const Placement& placement, Gameboard& result) const {
+	const Point* offsets{ getShapeOffsets(currentShape.getShape(), placement.rotation) };
+	int content{ static_cast<int>(currentShape.getColor()) };
+	result = board;
+	for (int i{ 0 }; i < 4; i++) {
+		int y{ placement.y + offsets[i].getY() };
+		if (y >= 0) {
+			result.setContent(placement.x + offsets[i].getX(), y, content);
+		}
+	}
+	return result.removeCompletedRows();
+}
+
+// return the block offsets of shape after rotation clockwise turns
+// (an array of 4 points, relative to the gridLoc)
+const Point* TetrisEngine::getShapeOffsets(TetShape shape, int rotation) {
+	assert(rotation >= 0 && rotation < MAX_ROTATIONS);
+	return getShapeTable().offsets[static_cast<int>(shape)][rotation];
+}
+
+// return how many orientations of shape are distinct (1, 2 or 4)
+int TetrisEngine::getRotationCount(TetShape shape) {
+	return getShapeTable().rotationCount[static_cast<int>(shape)];
+}
+
+// assign nextShape.setShape a new random shape
+void TetrisEngine::pickNextShape() {
+	nextShape.setShape(Tetromino::getRandomShape(rng));
+}
+
+// copy the nextShape into the currentShape and set
+//   its loc to be the gameboard's spawn loc.
+//	 - return true/false based on isPositionLegal()
+bool TetrisEngine::spawnNextShape() {
+	currentShape.setShape(nextShape.getShape());
+	currentShape.setGridLoc(board.getSpawnLoc());
+	return isPositionLegal(currentShape);
+}
+
+// remove completed rows, update the score and bring in the next shape.
+// called after the current shape's blocks have been copied to the board.
+//   return the number of rows cleared.
+int TetrisEngine::finishLock(bool shapeAboveBoard) {
+	int rowsCleared{ board.removeCompletedRows() };
+	score += rowsCleared;
+	piecesPlaced++;
+	if (shapeAboveBoard || !spawnNextShape()) {
+		gameOver = true;
+	}
+	else {
+		pickNextShape();
+	}
+	return rowsCleared;
+}
+
+// return true if the shape is within the left, right,
+//	 and lower border of the grid. (false otherwise)
+bool TetrisEngine::isShapeWithinBorders(const GridTetromino& shape) const {
+	BlockLocs locs{ shape.getBlockLocsMappedToGrid() };
+	for (const Point& loc : locs) {
+		if (loc.getX() < 0 || loc.getX() > board.MAX_X - 1 || loc.getY() > board.MAX_Y - 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// return true if the shape passed in intersects with content on the gameboard.
+bool TetrisEngine::doesShapeIntersectLockedBlocks(const GridTetromino& shape) const {
+	BlockLocs locs{ shape.getBlockLocsMappedToGrid() };
+	return (!board.areLocsEmpty(locs.data(), locs.size()));
+}
+
+// return true if 4 block offsets placed at gridLoc x,y are within the
+// borders and on empty grid locs (the allocation free version of
+// isPositionLegal() used by the placement functions)
+bool TetrisEngine::areOffsetsLegal(const Point offsets[], int x, int y) const {
+	for (int i{ 0 }; i < 4; i++) {
+		int blockX{ x + offsets[i].getX() };
+		int blockY{ y + offsets[i].getY() };
+		if (blockX < 0 || blockX >= Gameboard::MAX_X || blockY >= Gameboard::MAX_Y) {
+			return false;
+		}
+		if (blockY >= 0 && board.getContent(blockX, blockY) != Gameboard::EMPTY_BLOCK) {
+			return false;
+		}
+	}
+	return true;
+}
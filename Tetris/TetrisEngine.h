@@ -0,0 +1,181 @@
+// The TetrisEngine class holds the state and the rules of a single game of tetris,
+// without any knowledge of windows, sprites or keyboards.
+// TetrisGame drives one of these for the interactive game, while bots and
+// headless tools use them to play thousands of games as fast as possible.
+//
+// This class is responsible for:
+//   - the gameboard, the falling (current) shape and the shape on deck (next),
+//   - spawning tetrominoes from its own seeded random generator,
+//   - moving, rotating, dropping and locking tetrominoes,
+//   - clearing completed rows and keeping score,
+//   - generating and applying placements (for bots).
+//
+// A TetrisEngine is a plain value: copying one takes a snapshot of the game
+// (board, shapes, score and random state). Bots keep a scratch engine around and
+// assign snapshots into it instead of constructing new engines for every rollout,
+// so that simulating a game does not allocate.
+
+#ifndef TETRISENGINE_H
+#define TETRISENGINE_H
+
+#include <iostream>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "Placement.h"
+#include "Rng.h"
+
+class TetrisEngine
+{
+public:
+	// STATIC CONSTANTS
+	static const int MAX_ROTATIONS = 4;									// distinct orientations a shape can have
+	static const int MAX_PLACEMENTS = MAX_ROTATIONS * Gameboard::MAX_X;	// upper bound for getPlacements()
+
+	// MEMBER FUNCTIONS
+
+	// constructor, start a new game using seed for the shape sequence
+	explicit TetrisEngine(unsigned long long seed = 1);
+
+	// reset everything for a new game
+	//  - set score & piece count to 0,
+	//  - clear the gameboard,
+	//  - reseed the random generator,
+	//  - pick & spawn next shape
+	//  - pick next shape again
+	void reset(unsigned long long seed);
+
+	// reseed the random generator without touching the board or the
+	// current & next shapes. Only shapes picked from now on are affected
+	// (bots use this to sample different futures from the same snapshot).
+	void reseedRandom(unsigned long long seed);
+
+	// getters
+	const Gameboard& getBoard() const { return board; }
+	const GridTetromino& getCurrentShape() const { return currentShape; }
+	const GridTetromino& getNextShape() const { return nextShape; }
+	int getScore() const { return score; }					// rows cleared this game
+	int getPiecesPlaced() const { return piecesPlaced; }	// shapes locked this game
+	bool isGameOver() const { return gameOver; }			// true once a shape could not spawn
+
+	// return true if other has the same gameboard, current shape (and loc)
+	// and next shape as this engine (score and random state are ignored)
+	bool isSamePosition(const TetrisEngine& other) const;
+
+	// Saving ========================================================
+
+	// write the whole game (gameboard, current shape & its loc and rotation,
+	// next shape, random state, score ...) to out as text, for read()
+	void write(std::ostream& out) const;
+
+	// read a game written by write(), which then plays on exactly as the
+	// written one would have.
+	//   return false (leaving this engine untouched) if in doesn't hold one.
+	bool read(std::istream& in);
+
+	// Interactive moves (on the currentShape) ======================
+
+	// attempt to rotate the currentShape clockwise, return true if it rotated
+	bool attemptRotate();
+	// attempt to move the currentShape by x,y, return true if it moved
+	bool attemptMove(int x, int y);
+	// drop the currentShape as far as it can legally go (does not lock it)
+	void drop();
+
+	// A tick() forces the currentShape to move down one row. If it
+	// can move no further it is locked (see lockCurrentShape()).
+	// return true if the currentShape was locked.
+	bool tick();
+
+	// copy the currentShape's blocks onto the gameboard, then
+	//   - remove completed rows (adding them to the score),
+	//   - spawn the next shape & pick a new next shape,
+	//   - flag the game as over if the new shape can't spawn
+	//     (or if the locked shape stuck out of the top of the board).
+	// return the number of rows cleared.
+	int lockCurrentShape();
+
+	// Moves on any shape (against this engine's gameboard) ===========
+
+	// test if a rotation is legal on the tetromino,
+	//   if so, rotate it.
+	//	 return true/false to indicate successful movement
+	bool attemptRotate(GridTetromino& shape) const;
+
+	// test if a move is legal on the tetromino, if so, move it.
+	//	 return true/false to indicate successful movement
+	bool attemptMove(GridTetromino& shape, int x, int y) const;
+
+	// drops the tetromino vertically as far as it can legally go.
+	void drop(GridTetromino& shape) const;
+
+	// return true if shape is within borders (isShapeWithinBorders())
+	//	 and does NOT intersect locked blocks (!doesShapeIntersectLockedBlocks())
+	bool isPositionLegal(const GridTetromino& shape) const;
+
+	// Placements (for bots) ========================================
+
+	// fill placements with every distinct spot the currentShape can come to
+	// rest at by rotating at the spawn loc, sliding sideways and dropping.
+	//   placements must have room for MAX_PLACEMENTS entries.
+	//   return the number of placements written (0 once the game is over).
+	int getPlacements(Placement placements[]) const;
+
+	// rotate, slide and drop the currentShape as described by placement
+	// and lock it (see lockCurrentShape()).
+	//   return the number of rows cleared, or -1 if placement is not a
+	//   legal resting spot for the currentShape.
+	int applyPlacement(const Placement& placement);
+
+	// copy the gameboard into result and lock the currentShape onto it at
+	// placement, without changing this engine.
+	//   return the number of rows cleared on result.
+	int previewPlacement(const Placement& placement, Gameboard& result) const;
+
+	// return the block offsets of shape after rotation clockwise turns
+	// (an array of 4 points, relative to the gridLoc)
+	static const Point* getShapeOffsets(TetShape shape, int rotation);
+
+	// return how many orientations of shape are distinct (1, 2 or 4)
+	static int getRotationCount(TetShape shape);
+
+private:
+	// assign nextShape.setShape a new random shape
+	void pickNextShape();
+
+	// copy the nextShape into the currentShape and set
+	//   its loc to be the gameboard's spawn loc.
+	//	 - return true/false based on isPositionLegal()
+	bool spawnNextShape();
+
+	// remove completed rows, update the score and bring in the next shape.
+	// called after the current shape's blocks have been copied to the board.
+	//   return the number of rows cleared.
+	int finishLock(bool shapeAboveBoard);
+
+	// return true if the shape is within the left, right,
+	//	 and lower border of the grid. (false otherwise)
+	bool isShapeWithinBorders(const GridTetromino& shape) const;
+
+	// return true if the shape passed in intersects with content on the gameboard.
+	bool doesShapeIntersectLockedBlocks(const GridTetromino& shape) const;
+
+	// return true if 4 block offsets placed at gridLoc x,y are within the
+	// borders and on empty grid locs (the allocation free version of
+	// isPositionLegal() used by the placement functions)
+	bool areOffsetsLegal(const Point offsets[], int x, int y) const;
+
+	// MEMBER VARIABLES
+	Gameboard board;			// the gameboard (grid) to represent where all the blocks are.
+	GridTetromino nextShape;	// the tetromino shape that is "on deck".
+	GridTetromino currentShape;	// the tetromino that is currently falling.
+	Rng rng;					// picks the shapes (seeded, so games can be replayed)
+	int score = 0;				// the number of rows cleared this game
+	int piecesPlaced = 0;		// the number of shapes locked this game
+	bool gameOver = false;		// set once a new shape can't be spawned
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* TETRISENGINE_H */
@@ -4,14 +4,25 @@
 #include "GridTetromino.h"
 #include <SFML/Graphics.hpp>
 #include "TetrisGame.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
 #include <assert.h>
+#include <cstdio>
+#include <cstdlib>
+
+// where the score is drawn (its top left)
+static const sf::Vector2f SCORE_POSITION(435, 325);
 
 // constructor
-//   assign pointers,
+//   assign pointers (pProfiler, if not nullptr, times the game's phases,
+//   pStepMonitor, if not nullptr, times the engine steps),
 //   load font from file: fonts/RedOctober.ttf
-//   setup scoreText
+//   bake the score's glyphs into one atlas with the block tiles
 //   reset the game
-TetrisGame::TetrisGame(sf::RenderWindow* pWindow, sf::Sprite* pBlockSprite, Point gameboardOffset, Point nextShapeOffset) {
+//   start the simulation thread
+TetrisGame::TetrisGame(sf::RenderWindow* pWindow, sf::Sprite* pBlockSprite, Point gameboardOffset, Point nextShapeOffset,
+	FrameProfiler* pProfiler, StepMonitor* pStepMonitor) {
 	// Ensure pointers are valid
 	assert(pWindow);
 	assert(pBlockSprite);
@@ -19,215 +30,340 @@ TetrisGame::TetrisGame(sf::RenderWindow* pWindow, sf::Sprite* pBlockSprite, Poin
 	// Initialize variables
 	this->pWindow = pWindow;
 	this->pBlockSprite = pBlockSprite;
+	this->pProfiler = pProfiler;
+	this->pStepMonitor = pStepMonitor;
 	this->gameboardOffset = gameboardOffset;
 	this->nextShapeOffset = nextShapeOffset;
 
-	reset();
-
-	// Setup font for displaying the score
+	// Setup font for displaying the score: its glyphs go into one texture with
+	// the tiles, so the score is drawn in the same draw call as the blocks
+	sf::Font scoreFont;
 	if (!scoreFont.loadFromFile("fonts/RedOctober.ttf")) {
 		assert(false && "Missing font: RedOctober.ttf");
 	}
-	scoreText.setFont(scoreFont);
-	scoreText.setCharacterSize(24);
-	scoreText.setFillColor(sf::Color::White);
-	scoreText.setPosition(435, 325);
+	if (!atlas.create(pBlockSprite->getTexture()->copyToImage(), scoreFont, SCORE_CHARACTER_SIZE, "score: 0123456789")) {
+		assert(false && "Can't create the block & glyph atlas");
+	}
+
+	// the locked blocks are drawn from video memory
+	pBoardRenderer.reset(new BoardRenderer(&atlas.getTexture(), BLOCK_WIDTH, BLOCK_HEIGHT));
+	pBoardRenderer->setPosition(static_cast<float>(gameboardOffset.getX()), static_cast<float>(gameboardOffset.getY()));
+
+	reset();
+
+	// draw() has something to draw from the start
+	publishSnapshot(true);
+	snapshots.update();
+	simulationThread = std::thread(&TetrisGame::runSimulation, this);
 }
 
 
-// destructor, set pointers to null
+// destructor, stop the simulation thread, set pointers to null
 TetrisGame::~TetrisGame() {
+	stopping = true;
+	simulationThread.join();
 	pWindow = nullptr;
+	pProfiler = nullptr;
+	pStepMonitor = nullptr;
 	pBlockSprite = nullptr;
 }
 
-// draw anything to do with the game,
-// includes board, currentShape, nextShape, score
+// draw anything to do with the game (as of the latest Snapshot),
+// includes board, currentShape, its ghost, nextShape, score
+//   all of the blocks (and the score's glyphs) are collected into
+//   blockVertices and drawn with a single draw call (instead of one per block).
 void TetrisGame::draw() {
-	drawGameboard();
-	drawTetromino(currentShape, gameboardOffset);
-	drawTetromino(nextShape, nextShapeOffset);
-	pWindow->draw(scoreText);
+	ProfileTimer timer(pProfiler, ProfilePhase::DRAW);
+	TRACE_SCOPE("draw");
+	snapshots.update();
+	const Snapshot& snapshot{ snapshots.getReadBuffer() };
+	const TetrisEngine& game{ snapshot.engine };
+	if (game.getScore() != displayedScore) {
+		updateScoreDisplay(game.getScore());
+	}
+
+	blockVertices.clear();
+	drawGameboard(game.getBoard());
+	drawGhost(game);
+	drawBotPlacement(snapshot);
+	drawTetromino(game.getCurrentShape(), gameboardOffset, sf::Color::White, getFallShift(snapshot));
+	drawTetromino(game.getNextShape(), nextShapeOffset);
+	for (const sf::Vertex& vertex : scoreVertices) {
+		blockVertices.append(vertex);
+	}
+	pWindow->draw(blockVertices, &atlas.getTexture());
+}
+
+// wait (up to seconds) until the game has changed since the last draw()
+// (a tick, a key, a bot move: the simulation thread signals every Snapshot)
+//   return hasChanged().
+bool TetrisGame::waitForChange(double seconds) {
+	std::unique_lock<std::mutex> lock(changeMutex);
+	return changed.wait_for(lock, std::chrono::duration<double>(seconds), [this]() { return snapshots.hasUpdate(); });
 }
 
 // Event and game loop processing
-// handles keypress events (up, left, right, down, space)
-void TetrisGame::onKeyPressed(sf::Event event) {
-	switch (event.key.code) {
+// queue a keypress event for the simulation thread (see handleKey()),
+// tagged with inputId (for timing how long it takes to show, see LatencyProbe)
+void TetrisGame::onKeyPressed(sf::Event event, unsigned int inputId) {
+	pendingKeys.push(PendingKey{ event.key.code, inputId });
+}
+
+// Simulation thread methods =====================================
+
+// the simulation thread's main loop: step the game every SIM_STEP_MS
+// until the game is destroyed
+void TetrisGame::runSimulation() {
+	Tracer::setThreadName("simulation");
+	// (sf::sleep() would wake up when the OS timer next fires, every 15.6ms by default on Windows)
+	FramePacer pacer(PacingMode::TARGET_FPS, 1000.0 / SIM_STEP_MS);
+	sf::Clock clock;
+	while (!stopping) {
+		processInput();
+		processGameLoop(clock.restart().asSeconds());
+		publishSnapshot();
+		pacer.waitForNextFrame();
+	}
+}
+
+// handle the key presses queued by onKeyPressed()
+void TetrisGame::processInput() {
+	PendingKey pending;
+	int handled{ 0 };
+	while (pendingKeys.pop(pending)) {
+		TRACE_SCOPE("input");
+		handleKey(pending.key);
+		if (pending.inputId != 0) {
+			lastInputId = pending.inputId;
+		}
+		handled++;
+	}
+	if (handled > 0) {
+		Metrics::record(Metric::INPUT_QUEUE, handled);
+	}
+}
+
+// handles keypresses (up, left, right, down, space)
+//   B toggles the bot playing, H toggles the bot's hints
+void TetrisGame::handleKey(sf::Keyboard::Key key) {
+	if (key == sf::Keyboard::B) {
+		setBotMode(botMode == BotMode::PLAY ? BotMode::OFF : BotMode::PLAY);
+		return;
+	}
+	if (key == sf::Keyboard::H) {
+		setBotMode(botMode == BotMode::HINT ? BotMode::OFF : BotMode::HINT);
+		return;
+	}
+	if (botMode == BotMode::PLAY) {
+		return;		// hands off, the bot is playing
+	}
+	switch (key) {
 		case sf::Keyboard::Up :
-			attemptRotate(currentShape);
+			engine.attemptRotate();
 			break;
 		case sf::Keyboard::Left:
-			attemptMove(currentShape, -1, 0);
+			engine.attemptMove(-1, 0);
 			break;
 		case sf::Keyboard::Right:
-			attemptMove(currentShape, 1, 0);
+			engine.attemptMove(1, 0);
 			break;
 		case sf::Keyboard::Down:
-			if (!attemptMove(currentShape, 0, 1)) {
-				lock(currentShape);
+			if (!engine.attemptMove(0, 1)) {
+				step(EngineStep::LOCK);
 				shapePlacedSinceLastGameLoop = true;
 			}
 			break;
 		case sf::Keyboard::Space:
-			drop(currentShape);
-			lock(currentShape);
+			step(EngineStep::DROP);
 			shapePlacedSinceLastGameLoop = true;
 			break;
 	}
 }
 
-// called every game loop to handle ticks & tetromino placement (locking)
+// switch the bot between off, giving hints and playing
+void TetrisGame::setBotMode(BotMode mode) {
+	botMode = mode;
+	if (botMode != BotMode::OFF && !pBot) {
+		MctsSettings settings;
+		settings.iterations = 800;
+		settings.rolloutDepth = 6;
+		pBot.reset(new BotThread(settings));
+	}
+	requestBotPlacement();
+}
+
+// called every simulation step to handle ticks & tetromino placement (locking)
 void TetrisGame::processGameLoop(float secondsSinceLastLoop) {
+	ProfileTimer timer(pProfiler, ProfilePhase::GAME_LOOP);
 	secondsSinceLastTick += secondsSinceLastLoop;
 	if (secondsSinceLastTick > secsPerTick) {
+		int fromY{ engine.getCurrentShape().getGridLoc().getY() };
 		tick();
 		secondsSinceLastTick -= secsPerTick;
+		if (!shapePlacedSinceLastGameLoop) {
+			// the tick was due secondsSinceLastTick ago (a step can overshoot it)
+			lastFall.piece = engine.getPiecesPlaced();
+			lastFall.fromY = fromY;
+			lastFall.time = motionClock.getElapsedTime() - sf::seconds(static_cast<float>(secondsSinceLastTick));
+			lastFall.seconds = static_cast<float>(secsPerTick);
+		}
 	}
 
+	processBotMoves(secondsSinceLastLoop);
+
 	if (shapePlacedSinceLastGameLoop) {
-		if (spawnNextShape()) {
-			pickNextShape();
-			score += board.removeCompletedRows();
-			drawGameboard();
+		if (!engine.isGameOver()) {
 			determineSecsPerTick();
-			updateScoreDisplay();
 		}
 		else {
+			Metrics::add(Metric::GAMES);
 			reset();
 		}
 		shapePlacedSinceLastGameLoop = false;
+		requestBotPlacement();
 	}
 }
 
 // A tick() forces the currentShape to move (if there were no tick,
-// the currentShape would float in position forever). This should
-// call attemptMove() on the currentShape.  If not successful, lock() 
-// the currentShape (it can move no further), and record the fact that a
-// shape was placed (using shapePlacedSinceLastGameLoop)
+// the currentShape would float in position forever). This calls
+// tick() on the engine, which locks the currentShape if it can move
+// no further; record the fact that a shape was placed (using
+// shapePlacedSinceLastGameLoop)
 void TetrisGame::tick() {
-	if (!attemptMove(currentShape, 0, 1)) {
-		lock(currentShape);
+	ProfileTimer timer(pProfiler, ProfilePhase::TICK);
+	TRACE_SCOPE("tick");
+	if (step(EngineStep::TICK)) {
 		shapePlacedSinceLastGameLoop = true;
 	}
 }
 
-// reset everything for a new game (use existing functions) 
-//  - setScore to 0
-//  - determineSecondsPerTick(),
-//  - clear the gameboard,
-//  - pick & spawn next shape
-//  - pick next shape again
-void TetrisGame::reset() {
-	score = 0;
-	updateScoreDisplay();
-	determineSecsPerTick();
-	board.empty();
-	pickNextShape();
-	spawnNextShape();
-	pickNextShape();
+// make step on the engine, timed by pStepMonitor (if there is one),
+// counting the pieces locked & rows cleared (see Metrics)
+//   return true if it locked the currentShape.
+bool TetrisGame::step(EngineStep step) {
+	int score{ engine.getScore() };
+	bool locked{ pStepMonitor ? pStepMonitor->step(engine, step) : StepMonitor::runStep(engine, step) };
+	if (locked) {
+		Metrics::add(Metric::PIECES);
+		Metrics::add(Metric::ROWS, engine.getScore() - score);
+	}
+	return locked;
 }
 
-// assign nextShape.setShape a new random shape  
-void TetrisGame::pickNextShape() {
-	nextShape.setShape(Tetromino::getRandomShape());
+// publish a Snapshot of the game for draw(), if anything has changed
+// since the last one (or if force is true)
+void TetrisGame::publishSnapshot(bool force) {
+	bool hasBotPlacement{ botMode != BotMode::OFF && this->hasBotPlacement };
+	// (a handled key is published even if it changed nothing, so its latency can be timed)
+	if (!force && engine.isSamePosition(published.engine) && engine.getScore() == published.engine.getScore()
+		&& lastInputId == published.inputId && hasBotPlacement == published.hasBotPlacement
+		&& (!hasBotPlacement || (botPlacement.rotation == published.botPlacement.rotation
+			&& botPlacement.x == published.botPlacement.x && botPlacement.y == published.botPlacement.y))) {
+		return;
+	}
+	TRACE_SCOPE("publish snapshot");
+	published.engine = engine;
+	published.hasBotPlacement = hasBotPlacement;
+	published.botPlacement = botPlacement;
+	published.fall = lastFall;
+	published.inputId = lastInputId;
+	snapshots.getWriteBuffer() = published;
+	snapshots.publish();
+	{
+		// (so waitForChange() can't miss it between checking and waiting)
+		std::lock_guard<std::mutex> lock(changeMutex);
+	}
+	changed.notify_one();
 }
 
-
-// copy the nextShape into the currentShape and set 
-//   its loc to be the gameboard's spawn loc.
-//	 - return true/false based on isPositionLegal()
-bool TetrisGame::spawnNextShape() {
-	currentShape.setShape(nextShape.getShape());
-	currentShape.setGridLoc(board.getSpawnLoc());
-	return isPositionLegal(currentShape);
+// reset everything for a new game (use existing functions) 
+//  - reset the engine (score, gameboard & shapes) with a new seed
+//  - determineSecondsPerTick()
+void TetrisGame::reset() {
+	// rand() was seeded in main(), 2 calls give each game plenty of seed bits
+	engine.reset((static_cast<unsigned long long>(rand()) << 32) ^ static_cast<unsigned long long>(rand()));
+	determineSecsPerTick();
 }
 
+// Bot methods ===================================================
 
-
-// test if a rotation is legal on the tetromino, 
-//   if so, rotate it.
-//  To do this:
-//	 1) create a (local) temporary copy of the tetromino
-//	 2) rotate it (shape.rotateCW())
-//	 3) test if temp rotation was legal (isPositionLegal()), 
-//      if so - rotate the original tetromino.
-//	 4) return true/false to indicate successful movement
-bool TetrisGame::attemptRotate(GridTetromino& shape) {
-	GridTetromino temp = shape;
-	temp.rotateCW();
-	if (isPositionLegal(temp)) {
-		shape.rotateCW();
-		return true;
-	}
-	else {
-		return false;
+// ask the bot where to place the currentShape (if the bot is on).
+//   call whenever a new currentShape has spawned.
+void TetrisGame::requestBotPlacement() {
+	hasBotPlacement = false;
+	secondsSinceLastBotMove = 0.0;
+	if (botMode == BotMode::OFF || engine.isGameOver()) {
+		return;
 	}
-
+	botRequestId++;
+	pBot->requestPlacement(engine, botRequestId);
 }
 
-
-// test if a move is legal on the tetromino, if so, move it.
-//  To do this:
-//	 1) create a (local) temporary copy of the current shape
-//	 2) move it (temp.move())
-//	 3) test if temp move was legal (isPositionLegal(),
-//      if so - move the original.
-//	 4) return true/false to indicate successful movement
-bool TetrisGame::attemptMove(GridTetromino& shape, int x, int y) {
-	GridTetromino temp = shape;
-	temp.move(x, y);
-	if (isPositionLegal(temp)) {
-		shape.move(x, y);
-		return true;
+// check for the bot's answer and, in PLAY mode, step the currentShape
+// towards it one move every BOT_SECS_PER_MOVE (then drop & lock it)
+void TetrisGame::processBotMoves(float secondsSinceLastLoop) {
+	if (botMode == BotMode::OFF || shapePlacedSinceLastGameLoop) {
+		return;
 	}
-	else {
-		return false;
+	if (!hasBotPlacement) {
+		hasBotPlacement = pBot->pollPlacement(botRequestId, botPlacement);
+		botRotationsLeft = botPlacement.rotation;
+		if (!hasBotPlacement) {
+			return;		// still thinking
+		}
+	}
+	if (botMode != BotMode::PLAY) {
+		return;
+	}
+	secondsSinceLastBotMove += secondsSinceLastLoop;
+	while (secondsSinceLastBotMove >= BOT_SECS_PER_MOVE && !shapePlacedSinceLastGameLoop) {
+		secondsSinceLastBotMove -= BOT_SECS_PER_MOVE;
+		int xDistance{ botPlacement.x - engine.getCurrentShape().getGridLoc().getX() };
+		bool moved{ false };
+		if (botRotationsLeft > 0) {
+			moved = engine.attemptRotate();
+			botRotationsLeft--;
+		}
+		else if (xDistance != 0) {
+			moved = engine.attemptMove(xDistance > 0 ? 1 : -1, 0);
+		}
+		// in place (or stuck, if gravity got there first): drop it
+		if (!moved) {
+			step(EngineStep::DROP);
+			shapePlacedSinceLastGameLoop = true;
+		}
 	}
 }
 
+// Graphics methods (window thread) ==============================
 
-// drops the tetromino vertically as far as it can 
-//   legally go.  Use attemptMove(). This can be done in 1 line.
-void TetrisGame::drop(GridTetromino& shape) {
-	while(attemptMove(shape, 0, 1)) {}
-}
-
-// copy the contents of the tetromino's mapped block locs to the grid.
-//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
-//	 2) iterate on the mapped block locs and copy the contents (color) 
-//      of each to the grid (via gameboard.setGridContent()) 
-void TetrisGame::lock(const GridTetromino& shape) {
-	board.setContent(shape.getBlockLocsMappedToGrid(), static_cast<int>(shape.getColor()));
-}
-
-// Graphics methods ==============================================
-
-// draw a tetris block sprite on the canvas		
+// add a tetris block to this frame's blockVertices (as a textured quad)
 // x,y are meant to be block offsets (not pixels), which means you
 // will need to multiply them by BLOCK_WIDTH & BLOCK_HEIGHT
-//  for help: www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-//	 1) set the block color using pBlockSprite->setTextureRect()
-//   2) set the block loc using pBlockSprite->setPosition()   
-//	 3) draw the block using pWindow.draw()
-// (pointers to window and sprite were passed into the constructor)
-void TetrisGame::drawBlock(int x, int y, TetColor color, Point origin) {
-	pBlockSprite->setTextureRect(sf::IntRect(static_cast<int>(color) * BLOCK_WIDTH, 0, BLOCK_WIDTH, BLOCK_HEIGHT));
-	pBlockSprite->setPosition(static_cast<float>(origin.getX() + (x * BLOCK_WIDTH)), static_cast<float>(origin.getY() + (y * BLOCK_HEIGHT)));
-	pWindow->draw(*pBlockSprite);
+//	 1) the block color picks the texture rect (as pBlockSprite->setTextureRect() would)
+//   2) the block loc gives the quad's corners
+//   3) tint is multiplied with the texture (use the alpha to fade a block)
+// nothing is drawn until draw() draws the whole array.
+//   4) shift moves it by a number of pixels (for drawing a shape between rows)
+void TetrisGame::drawBlock(int x, int y, TetColor color, Point origin, sf::Color tint, sf::Vector2f shift) {
+	float left{ static_cast<float>(origin.getX() + (x * BLOCK_WIDTH)) + shift.x };
+	float top{ static_cast<float>(origin.getY() + (y * BLOCK_HEIGHT)) + shift.y };
+	float textureLeft{ static_cast<float>(static_cast<int>(color) * BLOCK_WIDTH) };
+	blockVertices.append(sf::Vertex(sf::Vector2f(left, top), tint, sf::Vector2f(textureLeft, 0)));
+	blockVertices.append(sf::Vertex(sf::Vector2f(left + BLOCK_WIDTH, top), tint, sf::Vector2f(textureLeft + BLOCK_WIDTH, 0)));
+	blockVertices.append(sf::Vertex(sf::Vector2f(left + BLOCK_WIDTH, top + BLOCK_HEIGHT), tint, sf::Vector2f(textureLeft + BLOCK_WIDTH, BLOCK_HEIGHT)));
+	blockVertices.append(sf::Vertex(sf::Vector2f(left, top + BLOCK_HEIGHT), tint, sf::Vector2f(textureLeft, BLOCK_HEIGHT)));
 }
 
 // draw the gameboard blocks on the window
-//   iterate through each row & col, use drawBlock() to 
-//   draw a block if it it isn't empty.
-void TetrisGame::drawGameboard() {
-	for (int x{ 0 }; x < board.MAX_X; x++) {
-		for (int y{ 0 }; y < board.MAX_Y; y++) {
-			if (board.getContent(x, y) != board.EMPTY_BLOCK) {
-				drawBlock(x, y, static_cast<TetColor>(board.getContent(x, y)), gameboardOffset);
-			}
-		}
-	}
+//   the locked blocks only change when a shape locks or rows are removed,
+//   so they are kept in video memory by a BoardRenderer, which re-uploads
+//   just the rows that changed.
+void TetrisGame::drawGameboard(const Gameboard& board) {
+	ProfileTimer timer(pProfiler, ProfilePhase::DRAW_BOARD);
+	TRACE_SCOPE("draw board");
+	pBoardRenderer->update(board);
+	pWindow->draw(*pBoardRenderer);
 }
 
 // draw a tetromino on the window
@@ -235,51 +371,69 @@ void TetrisGame::drawGameboard() {
 //   the origin determines a 'base point' from which to calculate block offsets
 //   If the Tetromino is on the gameboard: use gameboardOffset (otherwise you 
 //   can specify another point as the origin - for the nextShape)
-void TetrisGame::drawTetromino(GridTetromino tetromino, Point origin) {
-	std::vector<Point> locs{ tetromino.getBlockLocsMappedToGrid() };
-	for (int i{ 0 }; i < static_cast<int>(locs.size()); i++)
+void TetrisGame::drawTetromino(const GridTetromino& tetromino, Point origin, sf::Color tint, sf::Vector2f shift) {
+	BlockLocs locs{ tetromino.getBlockLocsMappedToGrid() };
+	for (int i{ 0 }; i < locs.size(); i++)
 	{
-		drawBlock(locs[i].getX(), locs[i].getY(), tetromino.getColor(), origin);
+		drawBlock(locs[i].getX(), locs[i].getY(), tetromino.getColor(), origin, tint, shift);
 	}
 }
 
-// update the score display
-// form a string "score: ##" to display the current score
-// user scoreText.setString() to display it.
-void TetrisGame::updateScoreDisplay() {
-	std::string text = "score: ";
-	text += std::to_string(score);
-	scoreText.setString(text);
+// return how far (in pixels) the currentShape is drawn from its row:
+// up to a row above it, if it fell by a tick that hasn't passed yet
+sf::Vector2f TetrisGame::getFallShift(const Snapshot& snapshot) const {
+	const Fall& fall{ snapshot.fall };
+	const TetrisEngine& game{ snapshot.engine };
+	// only a shape that is still just below where the tick left it slides:
+	// a new shape, a soft or a hard drop is drawn where it is
+	if (fall.piece != game.getPiecesPlaced() || game.isGameOver()
+		|| game.getCurrentShape().getGridLoc().getY() != fall.fromY + 1) {
+		return sf::Vector2f();
+	}
+	float alpha{ (motionClock.getElapsedTime() - fall.time).asSeconds() / fall.seconds };
+	if (alpha >= 1.0f) {
+		return sf::Vector2f();
+	}
+	return sf::Vector2f(0.0f, -(1.0f - std::max(alpha, 0.0f)) * BLOCK_HEIGHT);
 }
 
-// State & gameplay/logic methods ================================
-
-// return true if shape is within borders (isShapeWithinBorders())
-//	 and does NOT intersect locked blocks (!doesShapeIntersectLockedBlocks())
-bool TetrisGame::isPositionLegal(const GridTetromino& shape) {
-	return (isShapeWithinBorders(shape) && !doesShapeIntersectLockedBlocks(shape));
+// draw where the currentShape would land if it was dropped now, as faded blocks
+void TetrisGame::drawGhost(const TetrisEngine& game) {
+	if (game.isGameOver()) {
+		return;
+	}
+	GridTetromino ghost{ game.getCurrentShape() };
+	game.drop(ghost);
+	drawTetromino(ghost, gameboardOffset, sf::Color(255, 255, 255, 60));
 }
 
-// return true if the shape is within the left, right,
-//	 and lower border of the grid. (false otherwise)
-//   All of a shape's blocks must be on the gameboard to be within borders
-bool TetrisGame::isShapeWithinBorders(const GridTetromino& shape) {
-	std::vector<Point> locs = shape.getBlockLocsMappedToGrid();
-	for (Point loc : locs) {
-		if (loc.getX() < 0 || loc.getX() > board.MAX_X - 1 || loc.getY() > board.MAX_Y - 1) {
-			return false;
-		}
+// draw the bot's placement for the currentShape as faded blocks
+void TetrisGame::drawBotPlacement(const Snapshot& snapshot) {
+	if (!snapshot.hasBotPlacement) {
+		return;
+	}
+	const Placement& placement{ snapshot.botPlacement };
+	const GridTetromino& shape{ snapshot.engine.getCurrentShape() };
+	const Point* offsets{ TetrisEngine::getShapeOffsets(shape.getShape(), placement.rotation) };
+	for (int i{ 0 }; i < 4; i++) {
+		drawBlock(placement.x + offsets[i].getX(), placement.y + offsets[i].getY(),
+			shape.getColor(), gameboardOffset, sf::Color(255, 255, 255, 90));
 	}
-	return true;
 }
 
-// return true if the shape passed in intersects with content on the gameboard.
-//   Use Gameboard's areLocsEmpty() for this, and pass it the shape's mapped locs.
-bool TetrisGame::doesShapeIntersectLockedBlocks(const GridTetromino& shape) {
-	std::vector<Point> locs = shape.getBlockLocsMappedToGrid();
-	return (!board.areLocsEmpty(locs));
+// update the score display
+// form a string "score: ##" to display the current score
+// and rebuild scoreVertices from it (only called when the score changes).
+void TetrisGame::updateScoreDisplay(int score) {
+	char text[32];
+	std::snprintf(text, sizeof(text), "score: %d", score);
+	scoreVertices.clear();
+	atlas.appendText(scoreVertices, text, SCORE_POSITION, sf::Color::White);
+	displayedScore = score;
 }
 
+// State & gameplay/logic methods ================================
+
 // set secsPerTick 
 //   - basic: use MAX_SECS_PER_TICK
 //   - advanced: base it on score (higher score results in lower secsPerTick)
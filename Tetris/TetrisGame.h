@@ -6,11 +6,39 @@
 // rendering a tetromino block) was left in main.cpp
 // 
 // This class is responsible for:
-//   - setting up the board,
 //	 - drawing game elements to the screen
-//   - spawning tetrominoes,
 //   - handling user input,
-//   - moving and placing tetrominoes 
+//   - pacing the game (ticks)
+//   - hosting an (optional) bot that gives hints or plays the game itself.
+//     The bot searches on its own thread (see BotThread), so the game loop
+//     never waits for it.
+// The gameboard, the tetrominoes and the rules of the game live in a TetrisEngine
+// (which knows nothing about SFML), so the same game can also be played headless.
+//
+// The game runs on two threads:
+//   - the simulation thread (started by the constructor) owns the engine and
+//     the bot. It steps the game every SIM_STEP_MS (1000 times a second, timed
+//     by a FramePacer, as a plain sleep would be rounded up to the OS timer):
+//     handles the queued key presses, ticks, bot moves & locking, and
+//     publishes a Snapshot of the game whenever it changes.
+//   - the window's thread polls the window's events, calls onKeyPressed()
+//     (which just queues the key) and calls draw(), which draws the latest
+//     Snapshot.
+// Key presses go through a lock free SpscQueue and Snapshots through a lock
+// free TripleBuffer, so a slow frame (or a window being dragged) never holds
+// up gravity, and the simulation never holds up a frame. Held keys repeat as
+// the OS repeats their KeyPressed events.
+//
+// The simulation moves the currentShape a whole row per tick, which on a fast
+// display looks like a slow step animation. So each Snapshot also says when
+// the currentShape last fell a row (and from where), and draw() slides it
+// from its previous row to its current one over the tick, by the fraction of
+// the tick that has passed. Only the drawing is smoothed: the game itself
+// stays on whole rows.
+//
+// Key presses can be tagged with an input id (see LatencyProbe): each Snapshot
+// carries the id of the last key handled before it, so the main loop can tell
+// when the effect of a key has reached the screen.
 //
 //  [expected .cpp size: ~ 275 lines]
 
@@ -19,7 +47,23 @@
 
 #include "Gameboard.h"
 #include "GridTetromino.h"
+#include "TetrisEngine.h"
+#include "BoardRenderer.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+#include "Metrics.h"
+#include "StepMonitor.h"
+#include "GlyphAtlas.h"
+#include "BotThread.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
 #include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 
 class TetrisGame
@@ -28,133 +72,174 @@ public:
 	// STATIC CONSTANTS
 	static const int BLOCK_WIDTH = 32;			// pixel width of a tetris block
 	static const int BLOCK_HEIGHT = 32;			// pixel height of a tetris block
+	static const int SIM_STEP_MS = 1;			// milliseconds between simulation steps
+	static const unsigned int SCORE_CHARACTER_SIZE = 24;	// the score's font size
+
+	// what the bot is allowed to do
+	enum class BotMode
+	{
+		OFF,	// nothing, the bot thread isn't even started
+		HINT,	// show where the bot would place the currentShape
+		PLAY,	// play the game (the arrow keys are ignored)
+	};
+
+	// the currentShape's last fall by a tick (for drawing it sliding down)
+	struct Fall
+	{
+		int piece = -1;				// the engine's getPiecesPlaced() when it fell (-1: never)
+		int fromY = 0;				// the row it fell from
+		sf::Time time;				// when it fell (on motionClock)
+		float seconds = 1.0f;		// the tick length (how long the slide takes)
+	};
+
+	// what draw() needs to know about the game, published by the simulation thread
+	struct Snapshot
+	{
+		TetrisEngine engine;			// board, current & next shape, score
+		bool hasBotPlacement = false;	// show botPlacement
+		Placement botPlacement;
+		Fall fall;						// the currentShape's last fall
+		unsigned int inputId = 0;		// the last key press handled (see onKeyPressed())
+	};
 
 	// MEMBER FUNCTIONS
 
 	// constructor
-	//   assign pointers,
+	//   assign pointers (pProfiler, if not nullptr, times the game's phases,
+	//   pStepMonitor, if not nullptr, times the engine steps),
 	//   load font from file: fonts/RedOctober.ttf
-	//   setup scoreText
+	//   bake the score's glyphs into one atlas with the block tiles
 	//   reset the game
-	TetrisGame(sf::RenderWindow *pWindow, sf::Sprite *pBlockSprite, Point gameboardOffset, Point nextShapeOffset);	 
+	//   start the simulation thread
+	TetrisGame(sf::RenderWindow *pWindow, sf::Sprite *pBlockSprite, Point gameboardOffset, Point nextShapeOffset,
+		FrameProfiler* pProfiler = nullptr, StepMonitor* pStepMonitor = nullptr);
 
 
-	// destructor, set pointers to null
+	// destructor, stop the simulation thread, set pointers to null
 	~TetrisGame();								
+
+	TetrisGame(const TetrisGame&) = delete;
+	TetrisGame& operator=(const TetrisGame&) = delete;
 				
-	// draw anything to do with the game,
-	// includes board, currentShape, nextShape, score
+	// draw anything to do with the game (as of the latest Snapshot),
+	// includes board, currentShape, its ghost, nextShape, score
+	//   all of the blocks (and the score's glyphs) are collected into
+	//   blockVertices and drawn with a single draw call (instead of one per block).
 	void draw();								
 
-	// Event and game loop processing
-	// handles keypress events (up, left, right, down, space)
-	void onKeyPressed(sf::Event event);
+	// return true if the game has changed since the last draw()
+	//   (lets the main loop sleep instead of drawing identical frames)
+	bool hasChanged() const { return snapshots.hasUpdate(); }
+
+	// wait (up to seconds) until the game has changed since the last draw()
+	// (a tick, a key, a bot move: the simulation thread signals every Snapshot)
+	//   return hasChanged().
+	bool waitForChange(double seconds);
+
+	// return the inputId of the Snapshot draw() last drew
+	//   (every key press up to it is shown by that frame)
+	unsigned int getDrawnInputId() const { return snapshots.getReadBuffer().inputId; }
+
+	// Event processing
+	// queue a keypress event for the simulation thread (see handleKey()),
+	// tagged with inputId (for timing how long it takes to show, see LatencyProbe)
+	void onKeyPressed(sf::Event event, unsigned int inputId = 0);
+
+private:
+	// Simulation thread methods =====================================
+
+	// the simulation thread's main loop: step the game every SIM_STEP_MS
+	// until the game is destroyed
+	void runSimulation();
+
+	// handle the key presses queued by onKeyPressed()
+	void processInput();
+
+	// handles keypresses (up, left, right, down, space)
+	//   B toggles the bot playing, H toggles the bot's hints
+	void handleKey(sf::Keyboard::Key key);
+
+	// switch the bot between off, giving hints and playing
+	void setBotMode(BotMode mode);
 
-	// called every game loop to handle ticks & tetromino placement (locking)
+	// called every simulation step to handle ticks & tetromino placement (locking)
 	void processGameLoop(float secondsSinceLastLoop);
 
 	// A tick() forces the currentShape to move (if there were no tick,
-	// the currentShape would float in position forever). This should
-	// call attemptMove() on the currentShape.  If not successful, lock() 
-	// the currentShape (it can move no further), and record the fact that a
-	// shape was placed (using shapePlacedSinceLastGameLoop)
+	// the currentShape would float in position forever). This calls
+	// tick() on the engine, which locks the currentShape if it can move
+	// no further; record the fact that a shape was placed (using
+	// shapePlacedSinceLastGameLoop)
 	void tick();
 
-private:
+	// make step on the engine, timed by pStepMonitor (if there is one),
+	// counting the pieces locked & rows cleared (see Metrics)
+	//   return true if it locked the currentShape.
+	bool step(EngineStep step);
+
+	// publish a Snapshot of the game for draw(), if anything has changed
+	// since the last one (or if force is true)
+	void publishSnapshot(bool force = false);
+
 	// reset everything for a new game (use existing functions) 
-	//  - setScore to 0
-	//  - determineSecondsPerTick(),
-	//  - clear the gameboard,
-	//  - pick & spawn next shape
-	//  - pick next shape again
+	//  - reset the engine (score, gameboard & shapes) with a new seed
+	//  - determineSecondsPerTick()
 	void reset();
 
-	// assign nextShape.setShape a new random shape  
-	void pickNextShape();
+	// Bot methods ===================================================
 
+	// ask the bot where to place the currentShape (if the bot is on).
+	//   call whenever a new currentShape has spawned.
+	void requestBotPlacement();
+
+	// check for the bot's answer and, in PLAY mode, step the currentShape
+	// towards it one move every BOT_SECS_PER_MOVE (then drop & lock it)
+	void processBotMoves(float secondsSinceLastLoop);
+
+	// Graphics methods (window thread) ==============================
 	
-	// copy the nextShape into the currentShape and set 
-	//   its loc to be the gameboard's spawn loc.
-	//	 - return true/false based on isPositionLegal()
-	bool spawnNextShape();																	
-
-
-
-	// test if a rotation is legal on the tetromino, 
-	//   if so, rotate it.
-	//  To do this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) rotate it (shape.rotateCW())
-	//	 3) test if temp rotatio was legal (isPositionLegal()), 
-	//      if so - rotate the original tetromino.
-	//	 4) return true/false to indicate successful movement
-	bool attemptRotate(GridTetromino &shape);
-
-   
-	// test if a move is legal on the tetromino, if so, move it.
-	//  To do this:
-	//	 1) create a (local) temporary copy of the current shape
-	//	 2) move it (temp.move())
-	//	 3) test if temp move was legal (isPositionLegal(),
-	//      if so - move the original.
-	//	 4) return true/false to indicate successful movement
-	bool attemptMove(GridTetromino &shape, int x, int y);
-												
-
-	// drops the tetromino vertically as far as it can 
-	//   legally go.  Use attemptMove(). This can be done in 1 line.
-	void drop(GridTetromino &shape);
-
-	// copy the contents of the tetromino's mapped block locs to the grid.
-	//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
-	//	 2) iterate on the mapped block locs and copy the contents (color) 
-	//      of each to the grid (via gameboard.setGridContent()) 
-	void lock(const GridTetromino &shape);
-	
-	// Graphics methods ==============================================
-	
-	// draw a tetris block sprite on the canvas		
+	// add a tetris block to this frame's blockVertices (as a textured quad)
 	// x,y are meant to be block offsets (not pixels), which means you
 	// will need to multiply them by BLOCK_WIDTH & BLOCK_HEIGHT
-	//  for help: www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-	//	 1) set the block color using pBlockSprite->setTextureRect()
-	//   2) set the block loc using pBlockSprite->setPosition()   
-	//	 3) draw the block using pWindow.draw()
-	// (pointers to window and sprite were passed into the constructor)
-	void drawBlock(int x, int y, TetColor color, Point origin);
+	//	 1) the block color picks the texture rect (as pBlockSprite->setTextureRect() would)
+	//   2) the block loc gives the quad's corners
+	//   3) tint is multiplied with the texture (use the alpha to fade a block)
+	// nothing is drawn until draw() draws the whole array.
+	//   4) shift moves it by a number of pixels (for drawing a shape between rows)
+	void drawBlock(int x, int y, TetColor color, Point origin, sf::Color tint = sf::Color::White,
+		sf::Vector2f shift = sf::Vector2f());
 										
 	// draw the gameboard blocks on the window
-	//   iterate through each row & col, use drawBlock() to 
-	//   draw a block if it it isn't empty.
-	void drawGameboard();
+	//   the locked blocks only change when a shape locks or rows are removed,
+	//   so they are kept in video memory by a BoardRenderer, which re-uploads
+	//   just the rows that changed.
+	void drawGameboard(const Gameboard& board);
 	
 	// draw a tetromino on the window
 	//	 iterate through each mapped loc & drawBlock() for each.
 	//   the origin determines a 'base point' from which to calculate block offsets
 	//   If the Tetromino is on the gameboard: use gameboardOffset (otherwise you 
 	//   can specify another point as the origin - for the nextShape)
-	void drawTetromino(GridTetromino tetromino, Point origin);
+	void drawTetromino(const GridTetromino& tetromino, Point origin, sf::Color tint = sf::Color::White,
+		sf::Vector2f shift = sf::Vector2f());
+
+	// return how far (in pixels) the currentShape is drawn from its row:
+	// up to a row above it, if it fell by a tick that hasn't passed yet
+	sf::Vector2f getFallShift(const Snapshot& snapshot) const;
+
+	// draw where the currentShape would land if it was dropped now, as faded blocks
+	void drawGhost(const TetrisEngine& game);
+
+	// draw the bot's placement for the currentShape as faded blocks
+	void drawBotPlacement(const Snapshot& snapshot);
 	
 	// update the score display
 	// form a string "score: ##" to display the current score
-	// user scoreText.setString() to display it.
-	void updateScoreDisplay();
+	// and rebuild scoreVertices from it (only called when the score changes).
+	void updateScoreDisplay(int score);
 
 	// State & gameplay/logic methods ================================
 
-	// return true if shape is within borders (isShapeWithinBorders())
-	//	 and does NOT intersect locked blocks (!doesShapeIntersectLockedBlocks())
-	bool isPositionLegal(const GridTetromino &shape);					
-		
-	// return true if the shape is within the left, right,
-	//	 and lower border of the grid. (false otherwise)
-	//   All of a shape's blocks must be on the gameboard to be within borders
-	bool isShapeWithinBorders(const GridTetromino &shape);
-
-	// return true if the shape passed in intersects with content on the gameboard.
-	//   Use Gameboard's areLocsEmpty() for this, and pass it the shape's mapped locs.
-	bool doesShapeIntersectLockedBlocks(const GridTetromino &shape);
-
 	// set secsPerTick 
 	//   - basic: use MAX_SECS_PER_TICK
 	//   - advanced: base it on score (higher score results in lower secsPerTick)
@@ -162,22 +247,35 @@ private:
 
 	// MEMBER VARIABLES
 
-	// State members ---------------------------------------------
-	int score = 0;				// the current game score.
-    Gameboard board;			// the gameboard (grid) to represent where all the blocks are.
-    GridTetromino nextShape;	// the tetromino shape that is "on deck".
-    GridTetromino currentShape;	// the tetromino that is currently falling.
+	// State members (simulation thread) --------------------------
+	TetrisEngine engine;		// the game itself: gameboard, current & next shape and score.
 
 	// Graphics members ------------------------------------------
 	Point gameboardOffset = {0,0};	// pixel XY offset of the gameboard on the screen
 	Point nextShapeOffset = {0,0};	// pixel XY offset to the nextShape
 	sf::Sprite *pBlockSprite;		// a pointer to the sprite used for all the blocks.
 	sf::RenderWindow *pWindow;		// a pointer to the window that we are drawing on.
+	FrameProfiler *pProfiler;		// times draw(), processGameLoop() ... (nullptr: no timing)
+	StepMonitor *pStepMonitor;		// times the engine's steps (nullptr: no timing)
+	sf::VertexArray blockVertices{ sf::Quads };	// every block of the frame (refilled by draw())
+	std::unique_ptr<BoardRenderer> pBoardRenderer;	// draws the locked blocks
 
-	sf::Font scoreFont;				// SFML font for displaying the score.
-	sf::Text scoreText;				// SFML text object for displaying the score
+	GlyphAtlas atlas;				// the block tiles & the score's glyphs (one texture)
+	std::vector<sf::Vertex> scoreVertices;	// the score's quads (appended to blockVertices)
+	int displayedScore = -1;		// the score scoreVertices show
 	
 								
+	// Bot members (simulation thread) ----------------------------
+	std::unique_ptr<BotThread> pBot;		// the bot (created when it is first switched on)
+	BotMode botMode = BotMode::OFF;
+	unsigned int botRequestId = 0;			// tags the bot request for the currentShape
+	bool hasBotPlacement = false;			// true once the bot has answered botRequestId
+	Placement botPlacement;					// the bot's answer
+	int botRotationsLeft = 0;				// rotations still to do to reach botPlacement (PLAY)
+	double secondsSinceLastBotMove = 0.0;
+
+	const double BOT_SECS_PER_MOVE = 0.05;	// how quickly the bot moves the currentShape
+
 	// Time members ----------------------------------------------
 	// Note: a "tick" is the amount of time it takes a block to fall one line.
 
@@ -189,6 +287,27 @@ private:
 												// we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
 	bool shapePlacedSinceLastGameLoop = false;	// Tracks whether we have placed (locked) a shape on
 												// the gameboard in the current gameloop
+	const sf::Clock motionClock;				// times falls for both threads (never restarted)
+	Fall lastFall;								// the currentShape's last fall (simulation thread)
+
+	// Input members ----------------------------------------------
+	// a key press waiting for the simulation thread
+	struct PendingKey
+	{
+		sf::Keyboard::Key key;
+		unsigned int inputId;
+	};
+	static const int MAX_PENDING_KEYS = 64;			// more are dropped (the simulation thread is stuck)
+	SpscQueue<PendingKey, MAX_PENDING_KEYS> pendingKeys;	// onKeyPressed() -> the simulation thread
+	unsigned int lastInputId = 0;					// the last key press handled (simulation thread)
+
+	// Thread members ---------------------------------------------
+	TripleBuffer<Snapshot> snapshots;				// simulation thread -> draw()
+	std::mutex changeMutex;
+	std::condition_variable changed;				// signalled when a Snapshot is published
+	Snapshot published;								// the last snapshot published
+	std::atomic<bool> stopping{ false };
+	std::thread simulationThread;
 };
 
 #endif /* TETRISGAME_H */
@@ -7,6 +7,11 @@ TetShape Tetromino::getRandomShape() {
 	return static_cast<TetShape>(rand() % static_cast<int>(TetShape::TetShapeCount));
 }
 
+// return a random shape drawn from rng (instead of the global rand())
+TetShape Tetromino::getRandomShape(Rng& rng) {
+	return static_cast<TetShape>(rng.nextInt(static_cast<int>(TetShape::TetShapeCount)));
+}
+
 // set the shape
 //  - clear any blockLocs set previously
 //  - set the blockLocs for the shape
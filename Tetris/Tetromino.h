@@ -3,7 +3,9 @@
 
 #include <iostream>
 #include <vector>
+#include "BlockLocs.h"
 #include "Point.h"
+#include "Rng.h"
 
 enum class TetColor
 	{
@@ -33,10 +35,10 @@ class Tetromino
 private:
 	TetColor color;
 	TetShape shape;
-	const int NUM_POINTS{ 4 };
+	static const int NUM_POINTS = 4;
 
 protected:
-	std::vector<Point> blockLocs;
+	BlockLocs blockLocs;
 
 
 public:
@@ -48,6 +50,8 @@ public:
 	TetShape getShape() const { return shape; }
 
 	static TetShape getRandomShape();
+	// return a random shape drawn from rng (instead of the global rand())
+	static TetShape getRandomShape(Rng& rng);
 
 	void setShape(TetShape shape);// set the shape
 					//  - clear any blockLocs set previously
@@ -0,0 +1,117 @@
+#include "Tracer.h"
+#include <cstdio>
+
+std::atomic<bool> Tracer::enabled{ false };
+std::atomic<unsigned int> Tracer::capture{ 0 };
+std::mutex Tracer::mutex;
+std::vector<std::unique_ptr<Tracer::ThreadBuffer>> Tracer::buffers;
+const Tracer::Clock::time_point Tracer::epoch{ Tracer::Clock::now() };
+thread_local Tracer::ThreadBuffer* Tracer::pThreadBuffer{ nullptr };
+thread_local const char* Tracer::threadName{ nullptr };
+
+// switch tracing on (starting a new capture, if it was off) or off
+void Tracer::setEnabled(bool on) {
+	if (on && !isEnabled()) {
+		capture.fetch_add(1);
+	}
+	enabled.store(on, std::memory_order_release);
+}
+
+// name the calling thread (shown in the trace; name must outlive the Tracer)
+void Tracer::setThreadName(const char* name) {
+	threadName = name;
+	if (pThreadBuffer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		pThreadBuffer->name = name;
+	}
+}
+
+// record that the calling thread spent begin to end in scope name
+// (name must outlive the Tracer: use string literals)
+void Tracer::record(const char* name, Clock::time_point begin, Clock::time_point end) {
+	ThreadBuffer& buffer{ getThreadBuffer() };
+	unsigned int current{ capture.load(std::memory_order_acquire) };
+	if (buffer.capture.load(std::memory_order_relaxed) != current) {
+		// the first event of a new capture: start the buffer over
+		buffer.count.store(0, std::memory_order_relaxed);
+		buffer.dropped.store(0, std::memory_order_relaxed);
+		buffer.capture.store(current, std::memory_order_release);
+	}
+	int count{ buffer.count.load(std::memory_order_relaxed) };
+	if (count >= EVENTS_PER_THREAD) {
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	buffer.events[count] = Event{ name, begin, end };
+	buffer.count.store(count + 1, std::memory_order_release);
+}
+
+// write every event of the current capture to path as Chrome trace event JSON
+//   return false if the file couldn't be written.
+bool Tracer::writeJson(const std::string& path) {
+	std::FILE* file{ std::fopen(path.c_str(), "wb") };
+	if (!file) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first{ true };
+	for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+		// (names are string literals without quotes, so need no escaping)
+		std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			first ? "" : ",\n", buffer->id, buffer->name ? buffer->name : "thread");
+		first = false;
+		int count{ getCount(*buffer) };
+		for (int i{ 0 }; i < count; i++) {
+			const Event& event{ buffer->events[i] };
+			double begin{ std::chrono::duration<double, std::micro>(event.begin - epoch).count() };
+			double duration{ std::chrono::duration<double, std::micro>(event.end - event.begin).count() };
+			std::fprintf(file, ",\n{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, buffer->id, begin, duration);
+		}
+	}
+	std::fprintf(file, "\n]}\n");
+	return std::fclose(file) == 0;
+}
+
+// the events recorded (and dropped) in the current capture, over all threads
+int Tracer::getEventCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+	int count{ 0 };
+	for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+		count += getCount(*buffer);
+	}
+	return count;
+}
+
+int Tracer::getDroppedCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+	int count{ 0 };
+	for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+		count += getCount(*buffer, true);
+	}
+	return count;
+}
+
+// return the number of events (or drops, with dropped) of the current
+// capture in buffer (call with mutex locked)
+int Tracer::getCount(const ThreadBuffer& buffer, bool dropped) {
+	// (a buffer its thread hasn't started over yet holds the last capture's events)
+	if (buffer.capture.load(std::memory_order_acquire) != capture.load(std::memory_order_acquire)) {
+		return 0;
+	}
+	return dropped ? buffer.dropped.load(std::memory_order_relaxed) : buffer.count.load(std::memory_order_acquire);
+}
+
+// return the calling thread's buffer (created by its first event)
+Tracer::ThreadBuffer& Tracer::getThreadBuffer() {
+	if (!pThreadBuffer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		buffers.emplace_back(new ThreadBuffer());
+		pThreadBuffer = buffers.back().get();
+		pThreadBuffer->id = static_cast<int>(buffers.size());
+		pThreadBuffer->name = threadName;
+		pThreadBuffer->capture = capture.load();
+	}
+	return *pThreadBuffer;
+}
@@ -0,0 +1,133 @@
+// The Tracer records what each thread was doing when (begin & end of named
+// scopes) and writes it in Chrome's trace event format, so the interleaving of
+// the simulation, render and bot threads can be looked at in Perfetto
+// (ui.perfetto.dev) or chrome://tracing.
+//
+// A scope is traced with TRACE_SCOPE("name") (the name must be a string
+// literal, it isn't copied). When tracing is off that costs one relaxed load
+// of an atomic flag; defining TETRIS_NO_TRACING compiles the scopes out
+// altogether. When tracing is on, each scope appends one event to its thread's
+// own buffer (so threads never contend): no locks, no allocation after the
+// thread's first event. A thread's buffer holds EVENTS_PER_THREAD events, events
+// after that are dropped (and counted).
+//
+// Switching tracing on starts a new capture: the events (and drops) of the
+// last one are forgotten, so every capture gets the whole of each buffer. A
+// thread empties its own buffer at its first event of the new capture (only it
+// writes to it); until then its buffer counts as empty.
+//
+// writeJson() may be called at any time from any thread (but not while another
+// switches tracing on): it writes every event recorded so far in the current
+// capture (the writing threads carry on meanwhile).
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Tracer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const int EVENTS_PER_THREAD = 1 << 18;
+
+	// return true if tracing is on (any thread, as cheap as it gets)
+	static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+	// switch tracing on (starting a new capture, if it was off) or off
+	static void setEnabled(bool on);
+
+	// name the calling thread (shown in the trace; name must outlive the Tracer)
+	static void setThreadName(const char* name);
+
+	// record that the calling thread spent begin to end in scope name
+	// (name must outlive the Tracer: use string literals)
+	static void record(const char* name, Clock::time_point begin, Clock::time_point end);
+
+	// write every event of the current capture to path as Chrome trace event JSON
+	//   return false if the file couldn't be written.
+	static bool writeJson(const std::string& path);
+
+	// the events recorded (and dropped) in the current capture, over all threads
+	static int getEventCount();
+	static int getDroppedCount();
+
+private:
+	// one traced span
+	struct Event
+	{
+		const char* name;
+		Clock::time_point begin;
+		Clock::time_point end;
+	};
+
+	// a thread's events (written by that thread only)
+	struct ThreadBuffer
+	{
+		int id = 0;								// the thread's id in the trace
+		const char* name = nullptr;				// (guarded by mutex)
+		std::unique_ptr<Event[]> events{ new Event[EVENTS_PER_THREAD] };
+		std::atomic<int> count{ 0 };			// events[0, count) are complete
+		std::atomic<int> dropped{ 0 };
+		std::atomic<unsigned int> capture{ 0 };	// the capture the events belong to
+	};
+
+	// return the number of events (or drops, with dropped) of the current
+	// capture in buffer (call with mutex locked)
+	static int getCount(const ThreadBuffer& buffer, bool dropped = false);
+
+	// return the calling thread's buffer (created by its first event)
+	static ThreadBuffer& getThreadBuffer();
+
+	// the calling thread's buffer (nullptr until its first event) and name
+	static thread_local ThreadBuffer* pThreadBuffer;
+	static thread_local const char* threadName;
+
+	// MEMBER VARIABLES
+	static std::atomic<bool> enabled;
+	static std::atomic<unsigned int> capture;			// counts the times tracing was switched on
+	static std::mutex mutex;							// guards buffers & the names
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers;	// (never shrinks)
+	static const Clock::time_point epoch;				// the trace's time 0
+};
+
+// traces its scope (see TRACE_SCOPE)
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name) : name{ Tracer::isEnabled() ? name : nullptr } {
+		if (this->name) {
+			begin = Tracer::Clock::now();
+		}
+	}
+
+	~TraceScope() {
+		if (name) {
+			Tracer::record(name, begin, Tracer::Clock::now());
+		}
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* name;
+	Tracer::Clock::time_point begin;
+};
+
+#define TRACE_CONCATENATE_(a, b) a##b
+#define TRACE_CONCATENATE(a, b) TRACE_CONCATENATE_(a, b)
+#ifdef TETRIS_NO_TRACING
+#define TRACE_SCOPE(name)
+#else
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCATENATE(traceScope, __LINE__)(name)
+#endif
+
+#endif /* TRACER_H */
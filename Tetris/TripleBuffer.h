@@ -0,0 +1,64 @@
+// The TripleBuffer class hands values from one thread (the writer) to another
+// (the reader) without locks and without either thread ever waiting.
+//
+// There are three slots: the writer fills the "back" slot and publishes it,
+// which swaps it with the "middle" slot; the reader takes the middle slot by
+// swapping it with its "front" slot. Only the middle slot's index is shared
+// (an atomic, with a flag saying whether it holds something new), so
+//   - the writer can publish as often as it likes (the reader only ever sees
+//     the latest value, older ones are simply overwritten),
+//   - the reader keeps a complete value in front for as long as it needs it,
+//     however slow it is.
+//
+// Only one thread may write and only one thread may read.
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer
+{
+public:
+	// WRITER ========================================================
+
+	// the slot to fill in before calling publish()
+	T& getWriteBuffer() { return buffers[back]; }
+
+	// make the write buffer the latest value (and get a new write buffer)
+	void publish() {
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	// READER ========================================================
+
+	// return true if a value was published since the last update()
+	bool hasUpdate() const {
+		return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+	}
+
+	// take the latest value, if there is a new one.
+	//   return true if getReadBuffer() changed.
+	bool update() {
+		if (!hasUpdate()) {
+			return false;
+		}
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+
+	// the latest value taken by update()
+	const T& getReadBuffer() const { return buffers[front]; }
+
+private:
+	static const int INDEX = 3;		// the slot index bits of middle
+	static const int FRESH = 4;		// set in middle when it holds an unread value
+
+	T buffers[3];
+	int back = 0;					// only touched by the writer
+	std::atomic<int> middle{ 1 };	// shared
+	int front = 2;					// only touched by the reader
+};
+
+#endif /* TRIPLEBUFFER_H */
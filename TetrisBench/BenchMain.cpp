@@ -0,0 +1,337 @@
+// tetris-bench: time the hot paths of the engine (see BenchmarkRunner).
+//
+// usage: tetris-bench [options]
+//   --repetitions N   timed runs per benchmark (default 10)
+//   --seconds S       how long each run lasts, at least (default 0.05)
+//   --filter TEXT     only run the benchmarks whose name contains TEXT
+//   --json FILE       also write the results as JSON to FILE ("-" for stdout)
+//   --counters on     also read the hardware counters per iteration: cycles,
+//                     instructions, branch & cache misses (Linux, see PerfCounters)
+//   --baseline FILE   compare the results with FILE (an earlier --json) and exit
+//                     with 2 if any benchmark regressed, confirmed by measuring it
+//                     again (see RegressionGate). Given more than once (the JSON of
+//                     separate runs), the baseline pools their samples. The checked in
+//                     ones are baselines/<platform>-run1..3.json (Release build).
+//   --threshold PCT   how much slower a median & min must be to count (default 5)
+//   --alpha P         how unlikely the slowdown must be as noise (default 0.01)
+//   --soak SECONDS    instead of benchmarking, play games back to back for SECONDS and
+//                     write memory, allocation & tick latency samples as CSV (see SoakTest)
+//   --csv FILE        where the soak samples go (default "-", stdout)
+//   --interval S      seconds between soak samples (default 10)
+//   --player P        who plays the soak games: bot (default) or random
+//   --seed N          the first soak game's seed (default 1)
+//   --steps FILE      write the soak's slowest tick, with the game before it, to FILE
+//   --replay FILE     instead of benchmarking, time the step in FILE (from --steps, or
+//                     tetris --steps) again, and exit with 2 if it is still over the
+//                     StepMonitor's budget
+//   --self-test       instead of benchmarking, check the regression gate's statistics
+//                     (see BenchSelfTest) and exit with 1 if any check fails
+//
+// Benchmarks that change their board (gameboard/removeCompletedRows) copy a
+// prepared board every iteration; gameboard/copy times that copy on its own.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "Benchmark.h"
+#include "BenchSelfTest.h"
+#include "Evaluator.h"
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "RegressionGate.h"
+#include "SoakTest.h"
+#include "StepMonitor.h"
+#include "TetrisEngine.h"
+
+// print the command line options
+static void printUsage()
+{
+	std::cout << "usage: tetris-bench [--repetitions N] [--seconds S] [--filter TEXT] [--json FILE] [--counters on|off]\n"
+		<< "                    [--baseline FILE] [--threshold PCT] [--alpha P]\n"
+		<< "       tetris-bench --soak SECONDS [--csv FILE] [--interval S] [--player bot|random] [--seed N] [--steps FILE]\n"
+		<< "       tetris-bench --replay FILE\n"
+		<< "       tetris-bench --self-test\n";
+}
+
+// time the step in path (written by StepMonitor::writeSlowest()) again, from a
+// copy of the game before it each time
+//   return 2 if its median is over the budget (the game is slow, not just that
+//   run of it), 1 if path can't be read, else 0.
+static int replayStep(const std::string& path)
+{
+	const int REPLAYS = 100000;
+	EngineStep step;
+	std::uint64_t nanoseconds = 0;
+	TetrisEngine before;
+	if (!StepMonitor::readSlowest(path, step, nanoseconds, before)) {
+		std::cerr << "can't read a step from " << path << "\n";
+		return 1;
+	}
+	std::cout << "a " << StepMonitor::getStepName(step) << " that took " << nanoseconds << " ns, from:\n";
+	before.write(std::cout);
+
+	LatencyHistogram replays;
+	for (int i = 0; i < REPLAYS; i++) {
+		TetrisEngine engine = before;
+		auto start = std::chrono::steady_clock::now();
+		StepMonitor::runStep(engine, step);
+		auto end = std::chrono::steady_clock::now();
+		replays.add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+	}
+	double median = replays.getPercentileNs(50);
+	std::cout << "replayed " << REPLAYS << " times: p50 " << median << " ns, p99.9 " << replays.getPercentileNs(99.9)
+		<< " ns, max " << replays.getMaxNs() << " ns (budget " << StepMonitor::BUDGET_NS << " ns)\n";
+	return median > StepMonitor::BUDGET_NS ? 2 : 0;
+}
+
+// a board with a few scattered blocks and fullRows full rows at the bottom
+static Gameboard makeBoard(int fullRows)
+{
+	Gameboard board;
+	for (int y = Gameboard::MAX_Y - 8; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if ((x * 7 + y * 3) % 4 != 0) {
+				board.setContent(x, y, (x + y) % 7);
+			}
+		}
+	}
+	for (int i = 0; i < fullRows; i++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			board.setContent(x, Gameboard::MAX_Y - 1 - 2 * i, i % 7);
+		}
+	}
+	return board;
+}
+
+// add the benchmarks to runner
+static void addBenchmarks(BenchmarkRunner& runner)
+{
+	runner.add("gameboard/areLocsEmpty", [](int iterations) {
+		Gameboard board = makeBoard(0);
+		std::vector<Point> locs = { Point(3, 9), Point(4, 9), Point(4, 10), Point(5, 10) };
+		std::uint64_t empty = 0;
+		for (int i = 0; i < iterations; i++) {
+			locs[0].setX(i % Gameboard::MAX_X);
+			empty += board.areLocsEmpty(locs);
+		}
+		return empty;
+	});
+
+	runner.add("gameboard/copy", [](int iterations) {
+		const Gameboard prepared = makeBoard(4);
+		std::uint64_t content = 0;
+		for (int i = 0; i < iterations; i++) {
+			Gameboard board = prepared;
+			content += board.getContent(i % Gameboard::MAX_X, Gameboard::MAX_Y - 1);
+		}
+		return content;
+	});
+
+	for (int fullRows = 0; fullRows <= 4; fullRows++) {
+		runner.add("gameboard/removeCompletedRows/" + std::to_string(fullRows), [fullRows](int iterations) {
+			const Gameboard prepared = makeBoard(fullRows);
+			std::uint64_t removed = 0;
+			for (int i = 0; i < iterations; i++) {
+				Gameboard board = prepared;
+				removed += board.removeCompletedRows();
+			}
+			return removed;
+		});
+	}
+
+	runner.add("tetromino/setShape", [](int iterations) {
+		Tetromino tetromino;
+		std::uint64_t colors = 0;
+		for (int i = 0; i < iterations; i++) {
+			tetromino.setShape(static_cast<TetShape>(i % 7));
+			colors += static_cast<int>(tetromino.getColor());
+		}
+		return colors;
+	});
+
+	runner.add("tetromino/rotateCW", [](int iterations) {
+		GridTetromino tetromino;
+		tetromino.setShape(TetShape::SHAPE_T);
+		for (int i = 0; i < iterations; i++) {
+			tetromino.rotateCW();
+		}
+		return static_cast<std::uint64_t>(tetromino.getBlockLocsMappedToGrid()[0].getX() + 10);
+	});
+
+	runner.add("gridTetromino/getBlockLocsMappedToGrid", [](int iterations) {
+		GridTetromino tetromino;
+		tetromino.setShape(TetShape::SHAPE_L);
+		std::uint64_t sum = 0;
+		for (int i = 0; i < iterations; i++) {
+			tetromino.setGridLoc(i % Gameboard::MAX_X, 5);
+			sum += tetromino.getBlockLocsMappedToGrid()[3].getX();
+		}
+		return sum;
+	});
+
+	// (TetrisGame's moves now live in TetrisEngine)
+	runner.add("engine/attemptMove", [](int iterations) {
+		TetrisEngine engine(1);
+		GridTetromino shape = engine.getCurrentShape();
+		std::uint64_t moved = 0;
+		for (int i = 0; i < iterations; i++) {
+			moved += engine.attemptMove(shape, (i & 2) ? 1 : -1, 0);
+		}
+		return moved;
+	});
+
+	runner.add("engine/drop", [](int iterations) {
+		TetrisEngine engine(1);
+		std::uint64_t rows = 0;
+		for (int i = 0; i < iterations; i++) {
+			GridTetromino shape = engine.getCurrentShape();
+			engine.drop(shape);
+			rows += shape.getGridLoc().getY();
+		}
+		return rows;
+	});
+
+	runner.add("engine/game (greedy bot, 200 pieces)", [](int iterations) {
+		Evaluator evaluator;
+		std::uint64_t score = 0;
+		for (int i = 0; i < iterations; i++) {
+			TetrisEngine engine(i + 1);
+			Placement placement;
+			while (!engine.isGameOver() && engine.getPiecesPlaced() < 200) {
+				evaluator.choosePlacement(engine, placement);
+				engine.applyPlacement(placement);
+			}
+			score += engine.getScore();
+		}
+		return score;
+	});
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings settings;
+	std::string jsonPath;
+	std::vector<std::string> baselinePaths;
+	double threshold{ 5.0 };
+	double alpha{ 0.01 };
+	SoakSettings soak;
+	bool soaking{ false };
+	std::string csvPath{ "-" };
+	std::string replayPath;
+	for (int i{ 1 }; i < argc; i++) {
+		if (std::strcmp(argv[i], "--help") == 0) {
+			printUsage();
+			return 0;
+		}
+		if (std::strcmp(argv[i], "--self-test") == 0) {
+			return BenchSelfTest::runSelfTest() ? 0 : 1;
+		}
+		if (i + 1 >= argc) {
+			printUsage();
+			return 1;
+		}
+		const char* value{ argv[++i] };
+		if (std::strcmp(argv[i - 1], "--repetitions") == 0) {
+			settings.repetitions = std::atoi(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--seconds") == 0) {
+			settings.repetitionSeconds = std::atof(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--filter") == 0) {
+			settings.filter = value;
+		}
+		else if (std::strcmp(argv[i - 1], "--json") == 0) {
+			jsonPath = value;
+		}
+		else if (std::strcmp(argv[i - 1], "--counters") == 0) {
+			settings.counters = std::strcmp(value, "on") == 0;
+		}
+		else if (std::strcmp(argv[i - 1], "--baseline") == 0) {
+			baselinePaths.push_back(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--threshold") == 0) {
+			threshold = std::atof(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--alpha") == 0) {
+			alpha = std::atof(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--soak") == 0) {
+			soak.seconds = std::atof(value);
+			soaking = true;
+		}
+		else if (std::strcmp(argv[i - 1], "--csv") == 0) {
+			csvPath = value;
+		}
+		else if (std::strcmp(argv[i - 1], "--interval") == 0) {
+			soak.intervalSeconds = std::atof(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--player") == 0) {
+			soak.randomInputs = std::strcmp(value, "random") == 0;
+		}
+		else if (std::strcmp(argv[i - 1], "--seed") == 0) {
+			soak.seed = std::strtoull(value, nullptr, 10);
+		}
+		else if (std::strcmp(argv[i - 1], "--steps") == 0) {
+			soak.slowestStepPath = value;
+		}
+		else if (std::strcmp(argv[i - 1], "--replay") == 0) {
+			replayPath = value;
+		}
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+	if (settings.repetitions < 1 || settings.repetitionSeconds <= 0.0 || threshold < 0.0 || alpha <= 0.0) {
+		printUsage();
+		return 1;
+	}
+	if (!replayPath.empty()) {
+		return replayStep(replayPath);
+	}
+	if (soaking) {
+		if (soak.seconds <= 0.0 || soak.intervalSeconds <= 0.0) {
+			printUsage();
+			return 1;
+		}
+		SoakTest test(soak);
+		if (!test.run(csvPath)) {
+			std::cerr << "can't write " << csvPath << "\n";
+			return 1;
+		}
+		return 0;
+	}
+	// (with the JSON on stdout, the tables go to stderr)
+	std::ostream& out{ jsonPath == "-" ? std::cerr : std::cout };
+	settings.report = jsonPath == "-" ? stderr : stdout;
+	RegressionGate gate(threshold / 100.0, alpha, settings.report);
+	for (const std::string& path : baselinePaths) {
+		if (!gate.loadBaseline(path)) {
+			std::cerr << "can't read the baseline " << path << "\n";
+			return 1;
+		}
+	}
+
+	BenchmarkRunner runner(settings);
+	addBenchmarks(runner);
+	const std::vector<BenchmarkResult>& results{ runner.run() };
+	if (!jsonPath.empty() && !runner.writeJson(jsonPath)) {
+		std::cerr << "can't write " << jsonPath << "\n";
+		return 1;
+	}
+	if (!baselinePaths.empty()) {
+		out << "\ncompared with the baseline (" << baselinePaths.size() << " run(s)):\n";
+		if (gate.check(results) > 0) {
+			out << "\nmeasuring the slower ones again:\n";
+			auto measureAgain = [&runner](const std::string& name, BenchmarkResult& result) {
+				return runner.measureAgain(name, result);
+			};
+			if (gate.confirm(measureAgain) > 0) {
+				return 2;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,98 @@
+// The BenchSelfTest checks tetris-bench's own statistics: the RegressionGate's
+// Mann-Whitney p values (against reference values), its JSON reader and its
+// verdict rules. tetris-bench --self-test runs it. (It lives here rather than
+// in the game's TestSuite so the game doesn't link the benchmark tools.)
+//
+// The gate runs with the Release build, where assert() does nothing, so the
+// checks are made with CHECK(), which reports a failure in any build.
+
+#ifndef BENCHSELFTEST_H
+#define BENCHSELFTEST_H
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "RegressionGate.h"
+
+// count a failure (and say which check failed) if condition is false
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cout << "\n  failed: " << #condition << " (line " << __LINE__ << ")"; \
+			failures++; \
+		} \
+	} while (false)
+
+class BenchSelfTest
+{
+public:
+	// run every test
+	//   return true if they all passed.
+	static bool runSelfTest()
+	{
+		std::cout << "Running BenchSelfTest --------------------" << "\n";
+		bool passed = testRegressionGateClass();
+		std::cout << (passed ? "BenchSelfTest complete" : "BenchSelfTest FAILED") << " -------------------" << "\n";
+		return passed;
+	}
+
+	static bool testRegressionGateClass()
+	{
+		std::cout << " testRegressionGateClass...";
+		int failures = 0;
+
+		// Mann-Whitney: completely separated sets (U = 0), p from the normal
+		// approximation with the continuity correction
+		std::vector<double> low = { 1, 2, 3, 4, 5 };
+		std::vector<double> high = { 6, 7, 8, 9, 10 };
+		CHECK(std::abs(RegressionGate::mannWhitneyP(low, high) - 0.0121858) < 1e-6);
+		CHECK(RegressionGate::mannWhitneyP(low, high) == RegressionGate::mannWhitneyP(high, low));
+
+		// with ties: they share their average rank and shrink the variance
+		std::vector<double> tiedA = { 1, 1, 2, 2, 3 };
+		std::vector<double> tiedB = { 2, 3, 3, 4, 4 };
+		CHECK(std::abs(RegressionGate::mannWhitneyP(tiedA, tiedB) - 0.0524116) < 1e-6);
+
+		// the same times, all one time, or nothing to compare: no evidence of a change
+		CHECK(RegressionGate::mannWhitneyP(low, low) == 1.0);
+		CHECK(RegressionGate::mannWhitneyP({ 5, 5, 5 }, { 5, 5, 5 }) == 1.0);
+		CHECK(RegressionGate::mannWhitneyP(low, {}) == 1.0);
+
+		// parsing what BenchmarkRunner::writeJson() writes (line breaks are fine)
+		std::vector<BenchmarkResult> results;
+		std::string json = "{\n  \"repetitions\": 3,\n  \"benchmarks\": [\n"
+			"    { \"name\": \"a/b\", \"medianNs\": 2, \"samplesNs\": [3, 1,\n 2] },\n"
+			"    { \"name\": \"c\", \"samplesNs\": [4.5], \"counters\": { \"cycles\": 9 } }\n  ]\n}\n";
+		CHECK(RegressionGate::parseResults(json, results));
+		CHECK(results.size() == 2 && results[0].name == "a/b" && results[1].name == "c");
+		CHECK(results[0].samplesNs == std::vector<double>({ 1, 2, 3 }));
+		CHECK(results[0].medianNs == 2.0 && results[0].minNs == 1.0 && results[0].repetitions == 3);
+		CHECK(results[1].samplesNs.size() == 1 && results[1].samplesNs[0] == 4.5);
+		CHECK(!RegressionGate::parseResults("{ \"name\": \"x\" }", results));
+		CHECK(!RegressionGate::parseResults("{ \"benchmarks\": [ { \"name\": \"x\" } ] }", results));
+		CHECK(!RegressionGate::parseResults("{ \"benchmarks\": [ { \"name\": \"x\", \"samplesNs\": [1, y] } ] }", results));
+
+		// a verdict needs the median, the min and the test to agree
+		RegressionGate gate(0.05, 0.01);
+		BenchmarkResult baseline;
+		BenchmarkResult current;
+		for (int i = 0; i < 10; i++) {
+			baseline.samplesNs.push_back(100 + i);
+			current.samplesNs.push_back(120 + i);
+		}
+		CHECK(gate.compare(baseline, current).verdict == Verdict::SLOWER);
+		CHECK(gate.compare(current, baseline).verdict == Verdict::FASTER);
+		current.samplesNs[0] = 100;		// (its fastest run is as fast as ever)
+		BenchmarkComparison drift = gate.compare(baseline, current);
+		CHECK(drift.p < 0.01 && drift.change > 0.05 && drift.verdict == Verdict::SAME);
+
+		std::cout << (failures == 0 ? "passed!" : "FAILED") << "\n";
+		return failures == 0;
+	}
+};
+
+#undef CHECK
+
+#endif /* BENCHSELFTEST_H */
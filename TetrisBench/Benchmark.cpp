@@ -0,0 +1,180 @@
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// add a benchmark (run by run(), in the order added)
+void BenchmarkRunner::add(const std::string& name, BenchmarkBody body) {
+	benchmarks.emplace_back(name, body);
+}
+
+// run every benchmark matching the filter, printing a line for each
+//   return the results.
+const std::vector<BenchmarkResult>& BenchmarkRunner::run() {
+	results.clear();
+	if (settings.counters && !pCounters) {
+		pCounters.reset(new PerfCounters());
+		if (!pCounters->isAvailable()) {
+			std::fprintf(settings.report, "(hardware counters aren't available here: perf_event_open isn't permitted or there is no PMU)\n");
+		}
+	}
+	std::fprintf(settings.report, "%-40s %12s %12s %10s %12s %12s %10s\n", "benchmark", "median ns", "mean ns", "stddev %", "min ns", "max ns", "allocs");
+	for (const auto& benchmark : benchmarks) {
+		if (benchmark.first.find(settings.filter) == std::string::npos) {
+			continue;
+		}
+		BenchmarkResult result{ measure(benchmark.first, benchmark.second) };
+		std::fprintf(settings.report, "%-40s %12.1f %12.1f %10.1f %12.1f %12.1f %10.2f\n", result.name.c_str(), result.medianNs, result.meanNs,
+			result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0, result.minNs, result.maxNs, result.allocations);
+		if (pCounters && pCounters->isAvailable()) {
+			std::fprintf(settings.report, "%-40s", "");
+			for (int i{ 0 }; i < PerfCounters::COUNTER_COUNT; i++) {
+				if (result.counters[i] >= 0.0) {
+					std::fprintf(settings.report, " %s %.2f", PerfCounters::getName(static_cast<PerfCounter>(i)), result.counters[i]);
+				}
+			}
+			const double* counters{ result.counters };
+			if (counters[static_cast<int>(PerfCounter::CYCLES)] > 0.0 && counters[static_cast<int>(PerfCounter::INSTRUCTIONS)] >= 0.0) {
+				std::fprintf(settings.report, " ipc %.2f", counters[static_cast<int>(PerfCounter::INSTRUCTIONS)] / counters[static_cast<int>(PerfCounter::CYCLES)]);
+			}
+			std::fprintf(settings.report, "\n");
+		}
+		std::fflush(settings.report);
+		results.push_back(result);
+	}
+	return results;
+}
+
+// warm up & time the benchmark called name again, on its own, into result
+// (not added to the results of run())
+//   return false if there is no benchmark called name.
+bool BenchmarkRunner::measureAgain(const std::string& name, BenchmarkResult& result) {
+	for (const auto& benchmark : benchmarks) {
+		if (benchmark.first == name) {
+			result = measure(benchmark.first, benchmark.second);
+			return true;
+		}
+	}
+	return false;
+}
+
+// write the results of run() as JSON to path ("-" for stdout)
+//   return false if the file couldn't be written.
+bool BenchmarkRunner::writeJson(const std::string& path) const {
+	std::ostringstream json;
+	json << "{\n  \"repetitions\": " << settings.repetitions
+		<< ",\n  \"repetitionSeconds\": " << settings.repetitionSeconds
+#ifdef NDEBUG
+		<< ",\n  \"build\": \"release\""
+#else
+		<< ",\n  \"build\": \"debug\""
+#endif
+		<< ",\n  \"benchmarks\": [";
+	for (size_t i{ 0 }; i < results.size(); i++) {
+		const BenchmarkResult& result{ results[i] };
+		// (names are plain ASCII without quotes, so need no escaping)
+		json << (i > 0 ? "," : "") << "\n    { \"name\": \"" << result.name << "\""
+			<< ", \"iterations\": " << result.iterations
+			<< ", \"repetitions\": " << result.repetitions
+			<< ", \"medianNs\": " << result.medianNs
+			<< ", \"meanNs\": " << result.meanNs
+			<< ", \"stddevNs\": " << result.stddevNs
+			<< ", \"minNs\": " << result.minNs
+			<< ", \"maxNs\": " << result.maxNs
+			<< ", \"allocations\": " << result.allocations
+			<< ", \"samplesNs\": [";
+		for (size_t j{ 0 }; j < result.samplesNs.size(); j++) {
+			json << (j > 0 ? ", " : "") << result.samplesNs[j];
+		}
+		json << "]";
+		bool first{ true };
+		for (int j{ 0 }; j < PerfCounters::COUNTER_COUNT; j++) {
+			if (result.counters[j] >= 0.0) {
+				json << (first ? ", \"counters\": { " : ", ") << "\"" << PerfCounters::getName(static_cast<PerfCounter>(j))
+					<< "\": " << result.counters[j];
+				first = false;
+			}
+		}
+		json << (first ? " }" : " } }");
+	}
+	json << "\n  ]\n}\n";
+
+	if (path == "-") {
+		std::cout << json.str();
+		return static_cast<bool>(std::cout);
+	}
+	std::ofstream file(path, std::ios::binary);
+	file << json.str();
+	return static_cast<bool>(file);
+}
+
+// warm up, then time body
+BenchmarkResult BenchmarkRunner::measure(const std::string& name, const BenchmarkBody& body) {
+	// warm up, doubling the iterations until a run lasts a repetition
+	// (and for at least warmupSeconds in all)
+	int iterations{ 1 };
+	double warmedUp{ 0.0 };
+	for (;;) {
+		double seconds{ time(body, iterations) };
+		warmedUp += seconds;
+		if (seconds >= settings.repetitionSeconds && warmedUp >= settings.warmupSeconds) {
+			break;
+		}
+		if (seconds < settings.repetitionSeconds) {
+			iterations *= 2;
+		}
+	}
+
+	std::vector<double> nanoseconds;
+	nanoseconds.reserve(settings.repetitions);
+	double counters[PerfCounters::COUNTER_COUNT];
+	std::uint64_t allocationsBefore{ AllocationCounter::getThreadCount() };
+	if (pCounters) {
+		pCounters->start();
+	}
+	for (int i{ 0 }; i < settings.repetitions; i++) {
+		nanoseconds.push_back(1e9 * time(body, iterations) / iterations);
+	}
+	if (pCounters) {
+		pCounters->stop(counters);
+	}
+	std::uint64_t allocations{ AllocationCounter::getThreadCount() - allocationsBefore };
+
+	BenchmarkResult result;
+	result.name = name;
+	result.iterations = iterations;
+	result.repetitions = settings.repetitions;
+	double totalIterations{ static_cast<double>(iterations) * settings.repetitions };
+	result.allocations = static_cast<double>(allocations) / totalIterations;
+	for (int i{ 0 }; i < PerfCounters::COUNTER_COUNT; i++) {
+		result.counters[i] = pCounters && counters[i] >= 0.0 ? counters[i] / totalIterations : -1.0;
+	}
+	std::sort(nanoseconds.begin(), nanoseconds.end());
+	size_t count{ nanoseconds.size() };
+	result.minNs = nanoseconds.front();
+	result.maxNs = nanoseconds.back();
+	result.medianNs = count % 2 == 1 ? nanoseconds[count / 2] : (nanoseconds[count / 2 - 1] + nanoseconds[count / 2]) / 2.0;
+	double sum{ 0.0 };
+	double squares{ 0.0 };
+	for (double value : nanoseconds) {
+		sum += value;
+		squares += value * value;
+	}
+	result.meanNs = sum / count;
+	double variance{ squares / count - result.meanNs * result.meanNs };
+	result.stddevNs = variance > 0.0 ? std::sqrt(variance) : 0.0;
+	result.samplesNs = nanoseconds;
+	return result;
+}
+
+// time body over iterations, return the seconds it took
+double BenchmarkRunner::time(const BenchmarkBody& body, int iterations) {
+	auto start = std::chrono::steady_clock::now();
+	sink += body(iterations);
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,96 @@
+// The BenchmarkRunner class times small pieces of code (the hot paths of the
+// engine), repeatably enough to tell whether an optimisation helped.
+//
+// For every benchmark:
+//   1) warmup: the body is run with 1, 2, 4 ... iterations until warmupSeconds
+//      have passed; this also finds how many iterations one repetition needs
+//      to last repetitionSeconds (so the clock's resolution doesn't matter),
+//   2) the body is timed over that many iterations, repetitions times,
+//   3) the time per iteration is summarised: mean, median, standard deviation,
+//      min & max over the repetitions, with the allocations per iteration
+//      (see AllocationCounter) made during the repetitions, and (optionally)
+//      the hardware counters per iteration (see PerfCounters).
+// A body returns a value computed from its work, which the runner keeps, so
+// the optimizer can't throw the work away.
+//
+// Results are printed as they come and can be written as JSON (with every
+// repetition's time), for comparing runs: see RegressionGate.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "PerfCounters.h"
+
+// run the benchmarked code iterations times, return something computed from it
+using BenchmarkBody = std::function<std::uint64_t(int iterations)>;
+
+struct BenchmarkSettings
+{
+	int repetitions = 10;				// timed runs per benchmark
+	double warmupSeconds = 0.1;			// untimed running before the repetitions
+	double repetitionSeconds = 0.05;	// how long each repetition should take (at least)
+	std::string filter;					// only run benchmarks whose name contains this
+	bool counters = false;				// read the hardware counters too (where permitted)
+	std::FILE* report = stdout;			// where run() prints its table (stderr when the JSON goes to stdout)
+};
+
+// the time per iteration of a benchmark, over its repetitions (nanoseconds)
+struct BenchmarkResult
+{
+	std::string name;
+	int iterations = 0;			// per repetition
+	int repetitions = 0;
+	double meanNs = 0.0;
+	double medianNs = 0.0;
+	double stddevNs = 0.0;
+	double minNs = 0.0;
+	double maxNs = 0.0;
+	double allocations = 0.0;	// heap allocations per iteration
+	std::vector<double> samplesNs;	// every repetition's time per iteration (sorted)
+	double counters[PerfCounters::COUNTER_COUNT] = { -1.0, -1.0, -1.0, -1.0, -1.0 };	// per iteration (-1: not counted)
+};
+
+class BenchmarkRunner
+{
+public:
+	// constructor
+	explicit BenchmarkRunner(const BenchmarkSettings& settings) : settings{ settings } {}
+
+	// add a benchmark (run by run(), in the order added)
+	void add(const std::string& name, BenchmarkBody body);
+
+	// run every benchmark matching the filter, printing a line for each
+	//   return the results.
+	const std::vector<BenchmarkResult>& run();
+
+	// warm up & time the benchmark called name again, on its own, into result
+	// (not added to the results of run())
+	//   return false if there is no benchmark called name.
+	bool measureAgain(const std::string& name, BenchmarkResult& result);
+
+	// write the results of run() as JSON to path ("-" for stdout)
+	//   return false if the file couldn't be written.
+	bool writeJson(const std::string& path) const;
+
+private:
+	// warm up, then time body
+	BenchmarkResult measure(const std::string& name, const BenchmarkBody& body);
+
+	// time body over iterations, return the seconds it took
+	double time(const BenchmarkBody& body, int iterations);
+
+	// MEMBER VARIABLES
+	BenchmarkSettings settings;
+	std::vector<std::pair<std::string, BenchmarkBody>> benchmarks;
+	std::vector<BenchmarkResult> results;
+	std::uint64_t sink = 0;		// where the bodies' values end up
+	std::unique_ptr<PerfCounters> pCounters;	// (only with settings.counters)
+};
+
+#endif /* BENCHMARK_H */
@@ -0,0 +1,158 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// open a counter of type & config for the calling thread (user mode only), in
+// the group led by groupFile (-1: as a group of its own, read with group)
+//   return its file descriptor, or -1 if it can't be counted.
+static int openCounter(std::uint32_t type, std::uint64_t config, int groupFile, bool group) {
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = groupFile < 0 ? 1 : 0;		// (members count whenever their leader does)
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING | (group ? PERF_FORMAT_GROUP : 0);
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFile, 0));
+}
+
+// return the count scaled up from the time it ran to the time it was enabled
+// (-1 if it never got onto the CPU's registers while enabled)
+static double scale(std::uint64_t count, std::uint64_t enabled, std::uint64_t running) {
+	if (running == 0) {
+		return enabled == 0 ? 0.0 : -1.0;
+	}
+	return static_cast<double>(count) * static_cast<double>(enabled) / static_cast<double>(running);
+}
+
+// constructor, open the counters (for the calling thread)
+PerfCounters::PerfCounters() {
+	const std::uint64_t readMiss{ PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16 };
+	const std::uint32_t types[COUNTER_COUNT]{ PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+		PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE };
+	const std::uint64_t configs[COUNTER_COUNT]{ PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_L1D | readMiss, PERF_COUNT_HW_CACHE_LL | readMiss };
+	static_assert(static_cast<int>(PerfCounter::CYCLES) == 0, "cycles leads the group");
+
+	leader = openCounter(types[0], configs[0], -1, true);
+	files[0] = leader;
+	groupSize = leader >= 0 ? 1 : 0;
+	groupOrder[0] = 0;
+	for (int i{ 1 }; i < COUNTER_COUNT; i++) {
+		// (without cycles, each counter counts on its own)
+		files[i] = openCounter(types[i], configs[i], leader, false);
+		if (files[i] >= 0 && leader >= 0) {
+			groupOrder[groupSize++] = i;
+		}
+	}
+}
+
+// destructor, close them
+PerfCounters::~PerfCounters() {
+	for (int file : files) {
+		if (file >= 0) {
+			close(file);
+		}
+	}
+}
+
+// zero the counters and start counting
+void PerfCounters::start() {
+	if (leader >= 0) {
+		ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		return;
+	}
+	for (int file : files) {
+		if (file >= 0) {
+			ioctl(file, PERF_EVENT_IOC_RESET, 0);
+			ioctl(file, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+// stop counting, and write each counter's count since start() into
+// values (-1 for the counters that aren't available)
+void PerfCounters::stop(double values[COUNTER_COUNT]) {
+	for (int i{ 0 }; i < COUNTER_COUNT; i++) {
+		values[i] = -1.0;
+	}
+	if (leader >= 0) {
+		ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+		// the number of values, time enabled, time running, then the values (the leader's first)
+		std::uint64_t data[3 + COUNTER_COUNT];
+		ssize_t size{ static_cast<ssize_t>((3 + groupSize) * sizeof(std::uint64_t)) };
+		if (read(leader, data, sizeof(data)) != size || data[0] != static_cast<std::uint64_t>(groupSize)) {
+			return;
+		}
+		for (int i{ 0 }; i < groupSize; i++) {
+			values[groupOrder[i]] = scale(data[3 + i], data[1], data[2]);
+		}
+		return;
+	}
+	for (int file : files) {
+		if (file >= 0) {
+			ioctl(file, PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+	for (int i{ 0 }; i < COUNTER_COUNT; i++) {
+		std::uint64_t data[3];		// value, time enabled, time running
+		if (files[i] >= 0 && read(files[i], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data))) {
+			values[i] = scale(data[0], data[1], data[2]);
+		}
+	}
+}
+
+#else
+
+// constructor, open the counters (for the calling thread)
+PerfCounters::PerfCounters() {
+	for (int& file : files) {
+		file = -1;
+	}
+}
+
+// destructor, close them
+PerfCounters::~PerfCounters() {}
+
+// zero the counters and start counting
+void PerfCounters::start() {}
+
+// stop counting, and write each counter's count since start() into
+// values (-1 for the counters that aren't available)
+void PerfCounters::stop(double values[COUNTER_COUNT]) {
+	for (int i{ 0 }; i < COUNTER_COUNT; i++) {
+		values[i] = -1.0;
+	}
+}
+
+#endif
+
+// return true if at least one counter could be opened
+bool PerfCounters::isAvailable() const {
+	for (int file : files) {
+		if (file >= 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// return the counter's name ("cycles", "instructions", ...)
+const char* PerfCounters::getName(PerfCounter counter) {
+	switch (counter) {
+		case PerfCounter::CYCLES: return "cycles";
+		case PerfCounter::INSTRUCTIONS: return "instructions";
+		case PerfCounter::BRANCH_MISSES: return "branchMisses";
+		case PerfCounter::L1D_MISSES: return "l1dMisses";
+		case PerfCounter::LLC_MISSES: return "llcMisses";
+		default: return "?";
+	}
+}
@@ -0,0 +1,75 @@
+// The PerfCounters class reads the CPU's hardware performance counters
+// (cycles, instructions, branch misses, L1 data & last level cache misses)
+// around a piece of code, so a benchmark can show why it got faster or slower
+// rather than just that it did.
+//
+// It uses Linux's perf_event_open() (for the calling thread, user mode only).
+// The counters are opened as one group, cycles leading: the kernel schedules
+// a group onto the CPU's registers all together or not at all, so they all
+// count over exactly the same stretch of the code, and one read() of the
+// leader (PERF_FORMAT_GROUP) gets every value. That keeps ratios like
+// instructions per cycle honest. A counter the CPU or kernel doesn't offer is
+// left out of the group; if cycles itself can't be counted, the others are
+// opened on their own. Counting may not be permitted at all (e.g.
+// kernel.perf_event_paranoid above 2, or a container without the syscall):
+// then isAvailable() is false and every value reads as not counted. On other
+// systems nothing is ever counted.
+//
+// When other perf users leave too few registers free the kernel multiplexes
+// the group; the values are scaled up by the share of the time (enabled /
+// running) it was actually counting.
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cstdint>
+
+enum class PerfCounter
+{
+	CYCLES,
+	INSTRUCTIONS,
+	BRANCH_MISSES,
+	L1D_MISSES,			// L1 data cache read misses
+	LLC_MISSES,			// last level cache read misses
+	COUNT
+};
+
+class PerfCounters
+{
+public:
+	static const int COUNTER_COUNT = static_cast<int>(PerfCounter::COUNT);
+
+	// constructor, open the counters (for the calling thread)
+	PerfCounters();
+
+	// destructor, close them
+	~PerfCounters();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	// return true if at least one counter could be opened
+	bool isAvailable() const;
+
+	// return true if counter could be opened
+	bool isAvailable(PerfCounter counter) const { return files[static_cast<int>(counter)] >= 0; }
+
+	// zero the counters and start counting
+	void start();
+
+	// stop counting, and write each counter's count since start() into
+	// values (-1 for the counters that aren't available)
+	void stop(double values[COUNTER_COUNT]);
+
+	// return the counter's name ("cycles", "instructions", ...)
+	static const char* getName(PerfCounter counter);
+
+private:
+	// MEMBER VARIABLES
+	int files[COUNTER_COUNT];		// the counters' file descriptors (-1: not available)
+	int leader = -1;				// the group's leader (cycles), -1: no group
+	int groupSize = 0;				// counters in the group (the leader first)
+	int groupOrder[COUNTER_COUNT];	// which counter each of the group's values is
+};
+
+#endif /* PERFCOUNTERS_H */
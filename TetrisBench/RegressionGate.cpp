@@ -0,0 +1,248 @@
+#include "RegressionGate.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// return the median of sorted values
+static double getMedian(const std::vector<double>& sorted) {
+	size_t count{ sorted.size() };
+	if (count == 0) {
+		return 0.0;
+	}
+	return count % 2 == 1 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+// return the name of verdict (as printed)
+static const char* getVerdictName(Verdict verdict) {
+	switch (verdict) {
+		case Verdict::FASTER: return "faster";
+		case Verdict::SLOWER: return "SLOWER";
+		case Verdict::NEW: return "new";
+		default: return "same";
+	}
+}
+
+// read the baseline from the JSON file at path
+//   return false if it can't be read or has no benchmarks with samples.
+bool RegressionGate::loadBaseline(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	std::ostringstream json;
+	json << file.rdbuf();
+	std::vector<BenchmarkResult> run;
+	if (!parseResults(json.str(), run) || run.empty()) {
+		return false;
+	}
+	for (const BenchmarkResult& result : run) {
+		auto found = std::find_if(baseline.begin(), baseline.end(),
+			[&result](const BenchmarkResult& base) { return base.name == result.name; });
+		if (found == baseline.end()) {
+			baseline.push_back(result);
+			continue;
+		}
+		found->samplesNs.insert(found->samplesNs.end(), result.samplesNs.begin(), result.samplesNs.end());
+		std::sort(found->samplesNs.begin(), found->samplesNs.end());
+		found->repetitions = static_cast<int>(found->samplesNs.size());
+		found->medianNs = getMedian(found->samplesNs);
+		found->minNs = found->samplesNs.front();
+	}
+	return true;
+}
+
+// compare results with the baseline, printing a line for each
+//   return the number of regressions.
+int RegressionGate::check(const std::vector<BenchmarkResult>& results) {
+	comparisons.clear();
+	int regressions{ 0 };
+	std::fprintf(report, "%-40s %12s %12s %9s %9s  %s\n", "benchmark", "baseline ns", "current ns", "change %", "p", "verdict");
+	for (const BenchmarkResult& result : results) {
+		auto found = std::find_if(baseline.begin(), baseline.end(),
+			[&result](const BenchmarkResult& base) { return base.name == result.name; });
+		BenchmarkComparison comparison;
+		if (found == baseline.end()) {
+			comparison.name = result.name;
+			comparison.currentMedianNs = result.medianNs;
+			comparison.verdict = Verdict::NEW;
+		}
+		else {
+			comparison = compare(*found, result);
+		}
+		std::fprintf(report, "%-40s %12.1f %12.1f %9.1f %9.4f  %s\n", comparison.name.c_str(), comparison.baselineMedianNs,
+			comparison.currentMedianNs, 100.0 * comparison.change, comparison.p, getVerdictName(comparison.verdict));
+		if (comparison.verdict == Verdict::SLOWER) {
+			regressions++;
+		}
+		comparisons.push_back(comparison);
+	}
+	for (const BenchmarkResult& base : baseline) {
+		bool ran{ std::any_of(results.begin(), results.end(),
+			[&base](const BenchmarkResult& result) { return result.name == base.name; }) };
+		if (!ran) {
+			std::fprintf(report, "%-40s (in the baseline, not run)\n", base.name.c_str());
+		}
+	}
+	std::fprintf(report, "%d regression(s) (median & min more than %.1f%% slower, p < %g)\n", regressions, 100.0 * threshold, alpha);
+	return regressions;
+}
+
+// measure every benchmark check() found slower again with measureAgain
+// (e.g. BenchmarkRunner::measureAgain()) and compare that with the baseline,
+// printing a line for each; a benchmark stays a regression only if it is
+// slower again
+//   return the number of regressions confirmed.
+int RegressionGate::confirm(const std::function<bool(const std::string& name, BenchmarkResult& result)>& measureAgain) {
+	int confirmed{ 0 };
+	for (BenchmarkComparison& comparison : comparisons) {
+		if (comparison.verdict != Verdict::SLOWER) {
+			continue;
+		}
+		auto found = std::find_if(baseline.begin(), baseline.end(),
+			[&comparison](const BenchmarkResult& base) { return base.name == comparison.name; });
+		BenchmarkResult again;
+		if (found == baseline.end() || !measureAgain(comparison.name, again)) {
+			continue;
+		}
+		BenchmarkComparison second{ compare(*found, again) };
+		std::fprintf(report, "%-40s %12.1f %12.1f %9.1f %9.4f  %s\n", second.name.c_str(), second.baselineMedianNs,
+			second.currentMedianNs, 100.0 * second.change, second.p,
+			second.verdict == Verdict::SLOWER ? "SLOWER again" : "not confirmed");
+		if (second.verdict == Verdict::SLOWER) {
+			confirmed++;
+		}
+		else {
+			comparison.verdict = Verdict::SAME;
+		}
+	}
+	std::fprintf(report, "%d regression(s) confirmed\n", confirmed);
+	return confirmed;
+}
+
+// compare current with baseline (same benchmark)
+BenchmarkComparison RegressionGate::compare(const BenchmarkResult& baseline, const BenchmarkResult& current) const {
+	BenchmarkComparison comparison;
+	comparison.name = current.name;
+	std::vector<double> baselineSamples{ baseline.samplesNs };
+	std::vector<double> currentSamples{ current.samplesNs };
+	std::sort(baselineSamples.begin(), baselineSamples.end());
+	std::sort(currentSamples.begin(), currentSamples.end());
+	comparison.baselineMedianNs = getMedian(baselineSamples);
+	comparison.currentMedianNs = getMedian(currentSamples);
+	if (comparison.baselineMedianNs > 0.0) {
+		comparison.change = comparison.currentMedianNs / comparison.baselineMedianNs - 1.0;
+	}
+	if (!baselineSamples.empty() && !currentSamples.empty()) {
+		comparison.baselineMinNs = baselineSamples.front();
+		comparison.currentMinNs = currentSamples.front();
+		if (comparison.baselineMinNs > 0.0) {
+			comparison.minChange = comparison.currentMinNs / comparison.baselineMinNs - 1.0;
+		}
+	}
+	comparison.p = mannWhitneyP(baselineSamples, currentSamples);
+	if (comparison.p < alpha && comparison.change > threshold && comparison.minChange > threshold) {
+		comparison.verdict = Verdict::SLOWER;
+	}
+	else if (comparison.p < alpha && comparison.change < -threshold && comparison.minChange < -threshold) {
+		comparison.verdict = Verdict::FASTER;
+	}
+	return comparison;
+}
+
+// return the two-sided p value of the Mann-Whitney U test of a against b
+// (normal approximation, with tie & continuity corrections)
+double RegressionGate::mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+	double countA{ static_cast<double>(a.size()) };
+	double countB{ static_cast<double>(b.size()) };
+	if (a.empty() || b.empty()) {
+		return 1.0;
+	}
+	// rank both sets together (ties share their average rank)
+	std::vector<std::pair<double, int>> all;
+	for (double value : a) {
+		all.emplace_back(value, 0);
+	}
+	for (double value : b) {
+		all.emplace_back(value, 1);
+	}
+	std::sort(all.begin(), all.end());
+	double rankSumA{ 0.0 };
+	double ties{ 0.0 };			// sum of t^3 - t over the groups of t tied values
+	for (size_t first{ 0 }; first < all.size();) {
+		size_t last{ first };
+		while (last + 1 < all.size() && all[last + 1].first == all[first].first) {
+			last++;
+		}
+		double rank{ (first + last) / 2.0 + 1.0 };
+		for (size_t i{ first }; i <= last; i++) {
+			if (all[i].second == 0) {
+				rankSumA += rank;
+			}
+		}
+		double tied{ static_cast<double>(last - first + 1) };
+		ties += tied * tied * tied - tied;
+		first = last + 1;
+	}
+	double u{ rankSumA - countA * (countA + 1.0) / 2.0 };
+	double mean{ countA * countB / 2.0 };
+	double total{ countA + countB };
+	double variance{ countA * countB / 12.0 * ((total + 1.0) - ties / (total * (total - 1.0))) };
+	if (variance <= 0.0) {
+		return 1.0;		// (every time the same)
+	}
+	double z{ std::max(0.0, std::abs(u - mean) - 0.5) / std::sqrt(variance) };
+	return std::erfc(z / std::sqrt(2.0));
+}
+
+// read the names & samples of the benchmarks in json (as written by
+// BenchmarkRunner::writeJson()) into results
+//   return false if json isn't in that format.
+bool RegressionGate::parseResults(const std::string& json, std::vector<BenchmarkResult>& results) {
+	// (not a general JSON parser: it looks for each benchmark's name and
+	// samples, which writeJson() writes in that order)
+	results.clear();
+	const std::string nameKey{ "\"name\": \"" };
+	const std::string samplesKey{ "\"samplesNs\": [" };
+	size_t at{ json.find("\"benchmarks\"") };
+	if (at == std::string::npos) {
+		return false;
+	}
+	while ((at = json.find(nameKey, at)) != std::string::npos) {
+		at += nameKey.size();
+		size_t nameEnd{ json.find('"', at) };
+		size_t samples{ json.find(samplesKey, at) };
+		size_t nextName{ json.find(nameKey, at) };
+		if (nameEnd == std::string::npos || samples == std::string::npos || (nextName != std::string::npos && samples > nextName)) {
+			return false;
+		}
+		BenchmarkResult result;
+		result.name = json.substr(at, nameEnd - at);
+		const char* text{ json.c_str() + samples + samplesKey.size() };
+		for (;;) {
+			while (*text == ',' || std::isspace(static_cast<unsigned char>(*text))) {
+				text++;
+			}
+			if (*text == ']') {
+				break;
+			}
+			char* end;
+			double value{ std::strtod(text, &end) };
+			if (end == text) {
+				return false;
+			}
+			result.samplesNs.push_back(value);
+			text = end;
+		}
+		std::sort(result.samplesNs.begin(), result.samplesNs.end());
+		result.repetitions = static_cast<int>(result.samplesNs.size());
+		result.medianNs = getMedian(result.samplesNs);
+		result.minNs = result.samplesNs.empty() ? 0.0 : result.samplesNs.front();
+		results.push_back(result);
+		at = text - json.c_str();
+	}
+	return true;
+}
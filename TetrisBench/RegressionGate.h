@@ -0,0 +1,110 @@
+// The RegressionGate compares benchmark results against a baseline: a JSON
+// file (or several) written by BenchmarkRunner::writeJson() on the machine
+// that runs the gate, so that later work can't slow down a hot path without
+// anyone noticing.
+//
+// Timings are noisy, so a benchmark only counts as slower (a regression) or
+// faster if all of
+//   - its median moved by more than threshold (5% by default),
+//   - its fastest repetition (the min, the least disturbed) moved by more than
+//     threshold the same way, and
+//   - the Mann-Whitney U test finds its repetitions' times differ from the
+//     baseline's with a (two-sided) p below alpha (0.01 by default).
+// The test ranks the two sets of times together, so it makes no assumption
+// about how they are distributed (timings have long tails) and an outlier
+// repetition or two can't sway it; its normal approximation (with a tie
+// correction) is close enough for the usual 10 repetitions per side.
+//
+// Repetitions within one process aren't independent (they share its memory
+// layout, its CPU frequency, whatever else the machine was doing), so the p
+// value alone flags drift that isn't a regression. Two more guards:
+//   - the baseline can pool several runs' JSON files (separate processes), so
+//     its samples carry the spread between runs too,
+//   - confirm() measures each benchmark found slower again, and only keeps the
+//     verdict if the new measurement is slower too.
+//
+// The baseline's times only mean something on the machine (and build) they
+// were measured on, so none is checked in: write it there with the Release
+// build (tetris-bench --json baseline.json), and again when a change is meant
+// to move them.
+
+#ifndef REGRESSIONGATE_H
+#define REGRESSIONGATE_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+
+// how a benchmark compares with its baseline
+enum class Verdict
+{
+	SAME,		// no significant change
+	FASTER,
+	SLOWER,		// a regression
+	NEW,		// not in the baseline
+};
+
+struct BenchmarkComparison
+{
+	std::string name;
+	double baselineMedianNs = 0.0;
+	double currentMedianNs = 0.0;
+	double change = 0.0;		// current / baseline median - 1
+	double baselineMinNs = 0.0;
+	double currentMinNs = 0.0;
+	double minChange = 0.0;		// current / baseline min - 1
+	double p = 1.0;				// Mann-Whitney two-sided p value
+	Verdict verdict = Verdict::SAME;
+};
+
+class RegressionGate
+{
+public:
+	// constructor, flag changes of more than threshold (a fraction) with p below alpha,
+	// printing the comparisons to report
+	explicit RegressionGate(double threshold = 0.05, double alpha = 0.01, std::FILE* report = stdout)
+		: threshold{ threshold }, alpha{ alpha }, report{ report } {}
+
+	// read the baseline from the JSON file at path. Called again (with another
+	// run's file), the samples of each benchmark are pooled.
+	//   return false if it can't be read or has no benchmarks with samples.
+	bool loadBaseline(const std::string& path);
+
+	// compare results with the baseline, printing a line for each
+	//   return the number of regressions.
+	int check(const std::vector<BenchmarkResult>& results);
+
+	// measure every benchmark check() found slower again with measureAgain
+	// (e.g. BenchmarkRunner::measureAgain()) and compare that with the baseline,
+	// printing a line for each; a benchmark stays a regression only if it is
+	// slower again
+	//   return the number of regressions confirmed.
+	int confirm(const std::function<bool(const std::string& name, BenchmarkResult& result)>& measureAgain);
+
+	// the comparisons made by check()
+	const std::vector<BenchmarkComparison>& getComparisons() const { return comparisons; }
+
+	// compare current with baseline (same benchmark)
+	BenchmarkComparison compare(const BenchmarkResult& baseline, const BenchmarkResult& current) const;
+
+	// return the two-sided p value of the Mann-Whitney U test of a against b
+	// (normal approximation, with tie & continuity corrections)
+	static double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b);
+
+	// read the names & samples of the benchmarks in json (as written by
+	// BenchmarkRunner::writeJson()) into results
+	//   return false if json isn't in that format.
+	static bool parseResults(const std::string& json, std::vector<BenchmarkResult>& results);
+
+private:
+	// MEMBER VARIABLES
+	double threshold;
+	double alpha;
+	std::FILE* report;
+	std::vector<BenchmarkResult> baseline;
+	std::vector<BenchmarkComparison> comparisons;
+};
+
+#endif /* REGRESSIONGATE_H */
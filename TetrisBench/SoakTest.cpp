@@ -0,0 +1,205 @@
+#include "SoakTest.h"
+#include <chrono>
+#include <iostream>
+#include "AllocationCounter.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#endif
+
+// constructor
+SoakTest::SoakTest(const SoakSettings& settings)
+	: settings{ settings }, engine{ settings.seed }, rng{ settings.seed }, gameSeed{ settings.seed } {
+}
+
+// play for settings.seconds, writing a CSV header and then a line per
+// interval to csvPath ("-" for stdout), then print a summary
+//   return false if csvPath (or settings.slowestStepPath) couldn't be written.
+bool SoakTest::run(const std::string& csvPath) {
+	// (stdio, so writing a line doesn't count as an allocation of the game's)
+	std::FILE* file{ csvPath == "-" ? stdout : std::fopen(csvPath.c_str(), "w") };
+	if (file == nullptr) {
+		return false;
+	}
+	std::fprintf(file, "seconds,games,games_per_s,pieces_per_s,rows_per_s,tick_p50_ns,tick_p99_ns,tick_p999_ns,tick_max_ns,"
+		"rss_kb,allocations,allocated_bytes\n");
+	std::fflush(file);
+
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point start{ Clock::now() };
+	Clock::time_point intervalStart{ start };
+	std::uint64_t allocationsBefore{ AllocationCounter::getThreadCount() };
+	std::uint64_t bytesBefore{ AllocationCounter::getThreadBytes() };
+	Sample first;
+	Sample last;
+	bool sampled{ false };
+	bool written{ true };
+	for (;;) {
+		playPiece();
+		Clock::time_point now{ Clock::now() };
+		double intervalSeconds{ std::chrono::duration<double>(now - intervalStart).count() };
+		if (intervalSeconds < settings.intervalSeconds) {
+			continue;
+		}
+
+		Sample sample;
+		sample.seconds = std::chrono::duration<double>(now - start).count();
+		sample.games = games;
+		sample.gamesPerSecond = intervalGames / intervalSeconds;
+		sample.piecesPerSecond = intervalPieces / intervalSeconds;
+		sample.rowsPerSecond = intervalRows / intervalSeconds;
+		sample.tickP50Ns = tickLatency.getPercentileNs(50);
+		sample.tickP99Ns = tickLatency.getPercentileNs(99);
+		sample.tickP999Ns = tickLatency.getPercentileNs(99.9);
+		sample.tickMaxNs = tickLatency.getMaxNs();
+		sample.residentBytes = getResidentBytes();
+		sample.allocations = AllocationCounter::getThreadCount() - allocationsBefore;
+		sample.allocatedBytes = AllocationCounter::getThreadBytes() - bytesBefore;
+		writeSample(file, sample);
+		written = written && !std::ferror(file);
+		if (!sampled) {
+			first = sample;
+			sampled = true;
+		}
+		last = sample;
+
+		allTickLatency.add(tickLatency);
+		tickLatency.clear();
+		intervalGames = 0;
+		intervalPieces = 0;
+		intervalRows = 0;
+		allocationsBefore = AllocationCounter::getThreadCount();
+		bytesBefore = AllocationCounter::getThreadBytes();
+		intervalStart = Clock::now();
+		if (sample.seconds >= settings.seconds) {
+			break;
+		}
+	}
+	if (file != stdout) {
+		written = std::fclose(file) == 0 && written;
+	}
+
+	// the summary: how the last interval compares with the first
+	std::ostream& out{ csvPath == "-" ? std::cerr : std::cout };
+	out << "soaked " << last.seconds << " s, " << games << " games, " << allTickLatency.getCount() << " ticks: tick p50 "
+		<< allTickLatency.getPercentileNs(50) << " ns, p99 " << allTickLatency.getPercentileNs(99) << " ns, p99.9 "
+		<< allTickLatency.getPercentileNs(99.9) << " ns, max " << allTickLatency.getMaxNs() << " ns\n"
+		<< "first -> last interval: rss " << first.residentBytes / 1024 << " -> " << last.residentBytes / 1024
+		<< " KB, allocations " << first.allocations << " -> " << last.allocations
+		<< ", tick p99 " << first.tickP99Ns << " -> " << last.tickP99Ns << " ns, games/s "
+		<< first.gamesPerSecond << " -> " << last.gamesPerSecond << "\n";
+	if (!settings.slowestStepPath.empty()) {
+		out << stepMonitor.getReport() << "\n";
+		if (!stepMonitor.writeSlowest(settings.slowestStepPath)) {
+			return false;
+		}
+		out << "wrote the slowest tick to " << settings.slowestStepPath << "\n";
+	}
+	return written;
+}
+
+// return the process's resident memory (bytes), 0 if it can't be read here
+std::uint64_t SoakTest::getResidentBytes() {
+#ifdef __linux__
+	// statm: total and resident pages, ...
+	std::FILE* statm{ std::fopen("/proc/self/statm", "r") };
+	if (statm == nullptr) {
+		return 0;
+	}
+	unsigned long long pages{ 0 };
+	unsigned long long residentPages{ 0 };
+	int read{ std::fscanf(statm, "%llu %llu", &pages, &residentPages) };
+	std::fclose(statm);
+	return read == 2 ? residentPages * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+#elif defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return 0;
+	}
+	return counters.WorkingSetSize;
+#else
+	return 0;
+#endif
+}
+
+// play the current game's current piece until it locks, timing every tick
+// (and start a new game if that was its last)
+void SoakTest::playPiece() {
+	if (settings.randomInputs) {
+		// mash the keys: mostly ticks, with moves, rotations and the odd drop between
+		bool locked{ false };
+		while (!locked) {
+			int key{ rng.nextInt(10) };
+			if (key < 2) {
+				engine.attemptMove(-1, 0);
+			}
+			else if (key < 4) {
+				engine.attemptMove(1, 0);
+			}
+			else if (key == 4) {
+				engine.attemptRotate();
+			}
+			else if (key == 5) {
+				engine.drop();
+			}
+			else {
+				locked = tick();
+			}
+		}
+	}
+	else {
+		// steer the piece to where the bot wants it, then let it fall
+		Placement placement;
+		if (evaluator.choosePlacement(engine, placement)) {
+			for (int i{ 0 }; i < placement.rotation; i++) {
+				engine.attemptRotate();
+			}
+			int step{ placement.x < engine.getCurrentShape().getGridLoc().getX() ? -1 : 1 };
+			while (engine.getCurrentShape().getGridLoc().getX() != placement.x && engine.attemptMove(step, 0)) {
+			}
+		}
+		while (!tick()) {
+		}
+	}
+
+	intervalPieces++;
+	intervalRows += engine.getScore() - rowsBefore;
+	rowsBefore = engine.getScore();
+	if (engine.isGameOver()) {
+		games++;
+		intervalGames++;
+		engine.reset(++gameSeed);
+		rowsBefore = 0;
+	}
+}
+
+// tick the engine, adding the time it took to tickLatency (and to
+// stepMonitor, with a settings.slowestStepPath)
+//   return true if the current shape locked.
+bool SoakTest::tick() {
+	if (!settings.slowestStepPath.empty()) {
+		// (copies the engine before the tick, so only when the slowest is wanted)
+		bool locked{ stepMonitor.step(engine, EngineStep::TICK) };
+		tickLatency.add(stepMonitor.getLastNs());
+		return locked;
+	}
+	auto start = std::chrono::steady_clock::now();
+	bool locked{ engine.tick() };
+	auto end = std::chrono::steady_clock::now();
+	tickLatency.add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+	return locked;
+}
+
+// write sample as a CSV line to file
+void SoakTest::writeSample(std::FILE* file, const Sample& sample) {
+	std::fprintf(file, "%.1f,%llu,%.3f,%.1f,%.1f,%.0f,%.0f,%.0f,%llu,%llu,%llu,%llu\n", sample.seconds,
+		static_cast<unsigned long long>(sample.games), sample.gamesPerSecond, sample.piecesPerSecond,
+		sample.rowsPerSecond, sample.tickP50Ns, sample.tickP99Ns, sample.tickP999Ns,
+		static_cast<unsigned long long>(sample.tickMaxNs), static_cast<unsigned long long>(sample.residentBytes / 1024),
+		static_cast<unsigned long long>(sample.allocations), static_cast<unsigned long long>(sample.allocatedBytes));
+	std::fflush(file);
+}
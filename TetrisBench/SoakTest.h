@@ -0,0 +1,98 @@
+// The SoakTest class plays games back to back for hours (the bot's, or random
+// key presses) and samples, every interval, what should stay flat over a long
+// session but might drift:
+//   - the process's resident memory (leaks, fragmentation),
+//   - the heap allocations made (steady play should make none, see AllocationCounter),
+//   - the tick latency percentiles (p50, p99, p99.9, max of TetrisEngine::tick(),
+//     which moves, locks, clears rows and spawns; see LatencyHistogram),
+//   - the games, pieces and rows per second.
+// Each sample is a CSV line, flushed as it is written, so a run can be watched
+// (or plotted after a crash). A summary compares the first and last samples.
+// With a slowestStepPath, the ticks also go through a StepMonitor (which
+// copies the engine before each one) and the slowest is written for replaying;
+// without, they are only timed, so the copy doesn't slow the games down.
+//
+// It runs on the calling thread; the time between pieces isn't throttled.
+
+#ifndef SOAKTEST_H
+#define SOAKTEST_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "Evaluator.h"
+#include "LatencyHistogram.h"
+#include "Rng.h"
+#include "StepMonitor.h"
+#include "TetrisEngine.h"
+
+struct SoakSettings
+{
+	double seconds = 3600.0;			// how long to play
+	double intervalSeconds = 10.0;		// between samples
+	bool randomInputs = false;			// random key presses instead of the bot
+	unsigned long long seed = 1;		// the first game's seed (each game after adds 1)
+	std::string slowestStepPath;		// where to write the slowest tick (empty: nowhere)
+};
+
+class SoakTest
+{
+public:
+	// constructor
+	explicit SoakTest(const SoakSettings& settings);
+
+	// play for settings.seconds, writing a CSV header and then a line per
+	// interval to csvPath ("-" for stdout), then print a summary
+	//   return false if csvPath (or settings.slowestStepPath) couldn't be written.
+	bool run(const std::string& csvPath);
+
+	// return the process's resident memory (bytes), 0 if it can't be read here
+	static std::uint64_t getResidentBytes();
+
+private:
+	// the figures of an interval
+	struct Sample
+	{
+		double seconds = 0.0;			// since the start
+		std::uint64_t games = 0;		// finished since the start
+		double gamesPerSecond = 0.0;
+		double piecesPerSecond = 0.0;
+		double rowsPerSecond = 0.0;
+		double tickP50Ns = 0.0;
+		double tickP99Ns = 0.0;
+		double tickP999Ns = 0.0;
+		std::uint64_t tickMaxNs = 0;
+		std::uint64_t residentBytes = 0;
+		std::uint64_t allocations = 0;	// made during the interval
+		std::uint64_t allocatedBytes = 0;
+	};
+
+	// play the current game's current piece until it locks, timing every tick
+	// (and start a new game if that was its last)
+	void playPiece();
+
+	// tick the engine, adding the time it took to tickLatency (and to
+	// stepMonitor, with a settings.slowestStepPath)
+	//   return true if the current shape locked.
+	bool tick();
+
+	// write sample as a CSV line to file
+	static void writeSample(std::FILE* file, const Sample& sample);
+
+	// MEMBER VARIABLES
+	SoakSettings settings;
+	TetrisEngine engine;
+	Evaluator evaluator;
+	Rng rng;						// the random key presses
+	unsigned long long gameSeed;	// the current game's
+	LatencyHistogram tickLatency;	// this interval's ticks
+	LatencyHistogram allTickLatency;	// every tick
+	StepMonitor stepMonitor;		// every tick & the slowest (with a settings.slowestStepPath only)
+	std::uint64_t games = 0;		// finished, in all
+	std::uint64_t intervalGames = 0;
+	std::uint64_t intervalPieces = 0;
+	std::uint64_t intervalRows = 0;
+	int rowsBefore = 0;				// the current game's score when its current piece spawned
+};
+
+#endif /* SOAKTEST_H */
@@ -0,0 +1,235 @@
+// tetris-term: play tetris in a text terminal (over SSH, for instance).
+// It needs no SFML: the game is a TetrisEngine, drawn as text by a
+// TerminalScreen, which only sends the cells that changed each frame.
+//
+// usage: tetris-term [--seed N]
+//   left/right move, up rotates, down moves down, space drops,
+//   b lets the bot play (and takes it back), r starts over, q quits.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "Evaluator.h"
+#include "TerminalScreen.h"
+#include "TetrisEngine.h"
+#include "Terminal.h"
+
+using Clock = std::chrono::steady_clock;
+
+// the screen's layout (in terminal cells): a board loc is 2 columns wide
+const int SCREEN_COLUMNS = 48;
+const int SCREEN_ROWS = 21;
+const int BOARD_LEFT = 1;			// the board's left border
+const int BOARD_TOP = 0;
+const int PANEL_LEFT = 27;			// the next shape, score & keys
+
+const std::chrono::milliseconds TICK{ 750 };		// gravity (as TetrisGame's MAX_SECS_PER_TICK)
+const std::chrono::milliseconds BOT_MOVE{ 150 };	// how often the bot places a shape
+
+// the background color (256 color palette) of each TetColor
+const std::uint8_t BLOCK_COLORS[] = { 196, 208, 226, 46, 51, 21, 129 };
+
+// draw a grid loc of the board (x,y) at origin as 2 cells of color
+static void drawLoc(TerminalScreen& screen, int column, int row, int x, int y, std::uint8_t color, char character = ' ')
+{
+	screen.setCell(column + 2 * x, row + y, character, color);
+	screen.setCell(column + 2 * x + 1, row + y, character, color);
+}
+
+// draw a tetromino's blocks (or, if ghost, its outline) with its grid's top left at column,row
+static void drawTetromino(TerminalScreen& screen, const GridTetromino& shape, int column, int row, bool ghost = false)
+{
+	BlockLocs locs = shape.getBlockLocsMappedToGrid();
+	for (const Point& loc : locs)
+	{
+		if (ghost)
+		{
+			screen.setCell(column + 2 * loc.getX(), row + loc.getY(), '[');
+			screen.setCell(column + 2 * loc.getX() + 1, row + loc.getY(), ']');
+		}
+		else
+		{
+			drawLoc(screen, column, row, loc.getX(), loc.getY(), BLOCK_COLORS[static_cast<int>(shape.getColor())]);
+		}
+	}
+}
+
+// draw the whole frame (the screen works out what changed)
+static void drawFrame(TerminalScreen& screen, const TetrisEngine& engine, bool botPlaying)
+{
+	screen.clear();
+
+	// the board & its border
+	const Gameboard& board = engine.getBoard();
+	int boardColumn = BOARD_LEFT + 1;
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		screen.setCell(BOARD_LEFT, BOARD_TOP + y, '|');
+		screen.setCell(boardColumn + 2 * Gameboard::MAX_X, BOARD_TOP + y, '|');
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			int content = board.getContent(x, y);
+			if (content != Gameboard::EMPTY_BLOCK)
+			{
+				drawLoc(screen, boardColumn, BOARD_TOP, x, y, BLOCK_COLORS[content]);
+			}
+		}
+	}
+	for (int column = BOARD_LEFT; column <= boardColumn + 2 * Gameboard::MAX_X; column++)
+	{
+		screen.setCell(column, BOARD_TOP + Gameboard::MAX_Y, column == BOARD_LEFT || column == boardColumn + 2 * Gameboard::MAX_X ? '+' : '-');
+	}
+
+	// the shapes (only the parts on the board: the top border is open)
+	if (!engine.isGameOver())
+	{
+		GridTetromino ghost = engine.getCurrentShape();
+		engine.drop(ghost);
+		drawTetromino(screen, ghost, boardColumn, BOARD_TOP, true);
+		drawTetromino(screen, engine.getCurrentShape(), boardColumn, BOARD_TOP);
+	}
+	screen.putText(PANEL_LEFT, 1, "next:");
+	drawTetromino(screen, engine.getNextShape(), PANEL_LEFT + 2, 3);
+
+	std::string text = "score: " + std::to_string(engine.getScore());
+	screen.putText(PANEL_LEFT, 8, text.c_str());
+	text = "pieces: " + std::to_string(engine.getPiecesPlaced());
+	screen.putText(PANEL_LEFT, 9, text.c_str());
+	if (engine.isGameOver())
+	{
+		screen.putText(PANEL_LEFT, 11, "GAME OVER");
+	}
+	else if (botPlaying)
+	{
+		screen.putText(PANEL_LEFT, 11, "(the bot is playing)");
+	}
+
+	screen.putText(PANEL_LEFT, 13, "arrows  move/rotate");
+	screen.putText(PANEL_LEFT, 14, "space   drop");
+	screen.putText(PANEL_LEFT, 15, "b       bot on/off");
+	screen.putText(PANEL_LEFT, 16, "r       start over");
+	screen.putText(PANEL_LEFT, 17, "q       quit");
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long long seed = static_cast<unsigned long long>(Clock::now().time_since_epoch().count());
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else
+		{
+			std::cout << "usage: tetris-term [--seed N]\n";
+			return 1;
+		}
+	}
+
+	long long frames = 0;
+	long long bytes = 0;
+	{
+		Terminal terminal;
+		TerminalScreen screen(SCREEN_COLUMNS, SCREEN_ROWS);
+		TetrisEngine engine(seed);
+		Evaluator evaluator;
+		bool botPlaying = false;
+		bool quit = false;
+		std::string output;
+		Clock::time_point nextTick = Clock::now() + TICK;
+		Clock::time_point nextBotMove = Clock::now();
+		while (!quit)
+		{
+			// draw (only what changed, with a single write). After a resize the
+			// terminal may have reflowed or cleared what it showed: clear it and
+			// draw everything
+			bool resized = terminal.wasResized();
+			if (resized)
+			{
+				screen.invalidate();
+			}
+			drawFrame(screen, engine, botPlaying);
+			output.clear();
+			if (resized)
+			{
+				output += "\x1b[0m\x1b[2J";
+			}
+			if (screen.render(output) > 0)
+			{
+				terminal.write(output);
+				frames++;
+			}
+
+			// wait for a key, until it's time for the next tick (or bot move)
+			Clock::time_point wakeUp = botPlaying && nextBotMove < nextTick ? nextBotMove : nextTick;
+			auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(wakeUp - Clock::now()).count();
+			char character = 0;
+			TerminalKey key = terminal.readKey(timeout > 0 ? static_cast<int>(timeout) : 0, character);
+			bool humanPlaying = !botPlaying && !engine.isGameOver();
+			switch (key)
+			{
+				case TerminalKey::UP:
+					if (humanPlaying) engine.attemptRotate();
+					break;
+				case TerminalKey::LEFT:
+					if (humanPlaying) engine.attemptMove(-1, 0);
+					break;
+				case TerminalKey::RIGHT:
+					if (humanPlaying) engine.attemptMove(1, 0);
+					break;
+				case TerminalKey::DOWN:
+					if (humanPlaying && !engine.attemptMove(0, 1))
+					{
+						engine.lockCurrentShape();
+					}
+					break;
+				case TerminalKey::OTHER:
+					if (character == ' ' && humanPlaying)
+					{
+						engine.drop();
+						engine.lockCurrentShape();
+					}
+					else if (character == 'b' || character == 'B')
+					{
+						botPlaying = !botPlaying;
+					}
+					else if (character == 'r' || character == 'R')
+					{
+						engine.reset(++seed);
+						nextTick = Clock::now() + TICK;
+					}
+					else if (character == 'q' || character == 'Q' || character == 3)	// (3 is ctrl-c)
+					{
+						quit = true;
+					}
+					break;
+				case TerminalKey::NONE:
+					break;
+			}
+
+			Clock::time_point now = Clock::now();
+			if (botPlaying && now >= nextBotMove && !engine.isGameOver())
+			{
+				Placement placement;
+				evaluator.choosePlacement(engine, placement);
+				engine.applyPlacement(placement);
+				nextBotMove = now + BOT_MOVE;
+			}
+			if (now >= nextTick)
+			{
+				if (!engine.isGameOver() && !botPlaying)
+				{
+					engine.tick();
+				}
+				nextTick = now + TICK;
+			}
+		}
+		bytes = terminal.getBytesWritten();
+	}
+	std::cout << frames << " frames, " << bytes << " bytes written ("
+		<< (frames > 0 ? bytes / frames : 0) << " bytes/frame)\n";
+	return 0;
+}
@@ -0,0 +1,179 @@
+#include "Terminal.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <conio.h>
+#else
+#include <csignal>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+// how long to wait for the rest of an escape sequence once ESC has arrived
+static const int ESCAPE_TIMEOUT_MS = 20;
+
+#ifdef _WIN32
+static DWORD savedInputMode;
+static DWORD savedOutputMode;
+#else
+static termios savedTermios;
+static struct sigaction savedResizeAction;
+static volatile std::sig_atomic_t resized{ 0 };		// set by the SIGWINCH handler
+
+// the SIGWINCH handler: note the resize (the poll() in readByte() returns early)
+static void onResize(int) {
+	resized = 1;
+}
+#endif
+
+// constructor, switch to raw mode, the alternate screen and hide the cursor
+Terminal::Terminal() {
+#ifdef _WIN32
+	HANDLE input{ GetStdHandle(STD_INPUT_HANDLE) };
+	HANDLE output{ GetStdHandle(STD_OUTPUT_HANDLE) };
+	if (GetConsoleMode(input, &savedInputMode) && GetConsoleMode(output, &savedOutputMode)) {
+		SetConsoleMode(input, savedInputMode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT | ENABLE_PROCESSED_INPUT));
+		SetConsoleMode(output, savedOutputMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+		isRaw = true;
+	}
+#else
+	if (tcgetattr(STDIN_FILENO, &savedTermios) == 0) {
+		termios raw{ savedTermios };
+		raw.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+		raw.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+		raw.c_cc[VMIN] = 0;
+		raw.c_cc[VTIME] = 0;
+		isRaw = tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == 0;
+	}
+	struct sigaction action{};
+	action.sa_handler = onResize;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGWINCH, &action, &savedResizeAction);
+#endif
+	wasResized();	// (the size it starts with)
+	write("\x1b[?1049h\x1b[?25l\x1b[2J");
+}
+
+// destructor, restore the terminal as it was
+Terminal::~Terminal() {
+	write("\x1b[0m\x1b[?25h\x1b[?1049l");
+#ifndef _WIN32
+	sigaction(SIGWINCH, &savedResizeAction, nullptr);
+#endif
+	if (!isRaw) {
+		return;
+	}
+#ifdef _WIN32
+	SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), savedInputMode);
+	SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), savedOutputMode);
+#else
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedTermios);
+#endif
+}
+
+// wait up to timeoutMs for a key (0: don't wait).
+//   return the key; for OTHER, character is set to the key's character.
+TerminalKey Terminal::readKey(int timeoutMs, char& character) {
+	unsigned char byte;
+	if (!readByte(timeoutMs, byte)) {
+		return TerminalKey::NONE;
+	}
+#ifdef _WIN32
+	// the arrow keys arrive as 0 or 224, then a scan code
+	if ((byte == 0 || byte == 224) && readByte(ESCAPE_TIMEOUT_MS, byte)) {
+		switch (byte) {
+			case 72: return TerminalKey::UP;
+			case 80: return TerminalKey::DOWN;
+			case 75: return TerminalKey::LEFT;
+			case 77: return TerminalKey::RIGHT;
+		}
+		return TerminalKey::NONE;
+	}
+#else
+	// the arrow keys arrive as ESC [ A..D (or ESC O A..D)
+	unsigned char second, third;
+	if (byte == 0x1b && readByte(ESCAPE_TIMEOUT_MS, second) && (second == '[' || second == 'O')
+		&& readByte(ESCAPE_TIMEOUT_MS, third)) {
+		switch (third) {
+			case 'A': return TerminalKey::UP;
+			case 'B': return TerminalKey::DOWN;
+			case 'D': return TerminalKey::LEFT;
+			case 'C': return TerminalKey::RIGHT;
+		}
+		return TerminalKey::NONE;
+	}
+#endif
+	character = static_cast<char>(byte);
+	return TerminalKey::OTHER;
+}
+
+// write text to the terminal with one write
+//   return false if it couldn't all be written.
+bool Terminal::write(const std::string& text) {
+	size_t written{ 0 };
+	while (written < text.size()) {
+#ifdef _WIN32
+		DWORD count{ 0 };
+		if (!WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), text.data() + written,
+			static_cast<DWORD>(text.size() - written), &count, nullptr)) {
+			return false;
+		}
+#else
+		// (only a full pipe or a signal makes write() come back short)
+		ssize_t count{ ::write(STDOUT_FILENO, text.data() + written, text.size() - written) };
+		if (count < 0) {
+			return false;
+		}
+#endif
+		written += count;
+		bytesWritten += count;
+	}
+	return true;
+}
+
+// return true (once) if the terminal was resized since the last call,
+// so everything on it has to be drawn again
+bool Terminal::wasResized() {
+#ifdef _WIN32
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+		return false;
+	}
+	int newWidth{ info.srWindow.Right - info.srWindow.Left + 1 };
+	int newHeight{ info.srWindow.Bottom - info.srWindow.Top + 1 };
+	bool changed{ newWidth != width || newHeight != height };
+	width = newWidth;
+	height = newHeight;
+	return changed;
+#else
+	if (!resized) {
+		return false;
+	}
+	resized = 0;
+	return true;
+#endif
+}
+
+// read one byte if one arrives within timeoutMs
+//   return false if none did.
+bool Terminal::readByte(int timeoutMs, unsigned char& byte) {
+#ifdef _WIN32
+	DWORD start{ GetTickCount() };
+	while (!_kbhit()) {
+		if (static_cast<int>(GetTickCount() - start) >= timeoutMs) {
+			return false;
+		}
+		Sleep(1);
+	}
+	byte = static_cast<unsigned char>(_getch());
+	return true;
+#else
+	pollfd input{ STDIN_FILENO, POLLIN, 0 };
+	if (poll(&input, 1, timeoutMs) <= 0) {
+		return false;
+	}
+	return read(STDIN_FILENO, &byte, 1) == 1;
+#endif
+}
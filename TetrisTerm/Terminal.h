@@ -0,0 +1,69 @@
+// The Terminal class puts the terminal the game runs in into raw mode (keys
+// arrive one at a time, without echo or line editing) and restores it when it
+// is destroyed. It reads keys (decoding the arrow keys' escape sequences) and
+// writes whole frames at once.
+//
+// On Linux (and anything POSIX) it uses termios and poll(), so it works over
+// SSH; on Windows it uses the console API, with the console's VT processing
+// switched on so the same escape sequences can be written.
+//
+// It also notices the terminal being resized (SIGWINCH, which interrupts a
+// readKey() that is waiting; on Windows the console's size is compared), as the
+// terminal may reflow or clear what it showed: see wasResized().
+
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include <string>
+
+// a key read by Terminal::readKey()
+enum class TerminalKey
+{
+	NONE,		// no key arrived in time
+	UP,
+	DOWN,
+	LEFT,
+	RIGHT,
+	OTHER,		// any other key (see Terminal::readKey())
+};
+
+class Terminal
+{
+public:
+	// constructor, switch to raw mode, the alternate screen and hide the cursor
+	Terminal();
+
+	// destructor, restore the terminal as it was
+	~Terminal();
+
+	Terminal(const Terminal&) = delete;
+	Terminal& operator=(const Terminal&) = delete;
+
+	// wait up to timeoutMs for a key (0: don't wait).
+	//   return the key; for OTHER, character is set to the key's character.
+	TerminalKey readKey(int timeoutMs, char& character);
+
+	// write text to the terminal with one write
+	//   return false if it couldn't all be written.
+	bool write(const std::string& text);
+
+	// total bytes written so far
+	long long getBytesWritten() const { return bytesWritten; }
+
+	// return true (once) if the terminal was resized since the last call,
+	// so everything on it has to be drawn again
+	bool wasResized();
+
+private:
+	// read one byte if one arrives within timeoutMs
+	//   return false if none did.
+	bool readByte(int timeoutMs, unsigned char& byte);
+
+	// MEMBER VARIABLES
+	long long bytesWritten = 0;
+	bool isRaw = false;
+	int width = 0;				// the console's size at the last wasResized() (Windows)
+	int height = 0;
+};
+
+#endif /* TERMINAL_H */
@@ -0,0 +1,168 @@
+// tetris-tune: optimize the Evaluator's weights by playing headless games.
+//
+// usage: tetris-tune [options]
+//   --population N    candidates per generation (default 64)
+//   --survivors N     fittest candidates kept each generation (default 16)
+//   --games N         games per candidate per generation (default 32)
+//   --pieces N        pieces per game before it is stopped (default 500)
+//   --generations N   generations to run (default 100)
+//   --threads N       worker threads, 0 = one per core (default 0)
+//   --seed N          seeds the games and the breeding (default 1)
+//   --checkpoint F    checkpoint file (default tetris-tune.checkpoint)
+//   --export F        don't tune: play --games games with the checkpoint's best
+//                     weights (or the defaults) and write every position to the
+//                     dataset file F (see DatasetWriter for the format)
+//
+// If the checkpoint file exists the run resumes from it, so an interrupted
+// run is continued by starting it again with the same options.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DatasetWriter.h"
+#include "WeightTuner.h"
+
+// print the command line options
+static void printUsage()
+{
+	std::cout << "usage: tetris-tune [--population N] [--survivors N] [--games N] [--pieces N]\n"
+		<< "                   [--generations N] [--threads N] [--seed N] [--checkpoint FILE]\n"
+		<< "                   [--export FILE]\n";
+}
+
+// print a candidate's weights
+static void printWeights(const EvaluatorWeights& weights)
+{
+	std::cout << "aggregateHeight " << weights.aggregateHeight
+		<< "  rowsCleared " << weights.rowsCleared
+		<< "  holes " << weights.holes
+		<< "  bumpiness " << weights.bumpiness;
+}
+
+// play settings.gamesPerCandidate games with weights and record them in the
+// dataset file path
+//   return the process exit code.
+static int exportDataset(const TunerSettings& settings, const EvaluatorWeights& weights, const std::string& path)
+{
+	DatasetWriter dataset;
+	if (!dataset.open(path)) {
+		std::cerr << "can't create " << path << "\n";
+		return 1;
+	}
+	BatchSimulator simulator(settings.threads, settings.maxPieces);
+	simulator.setDataset(&dataset);
+
+	// play in batches, so progress is reported and the job list stays small
+	const int BATCH_GAMES{ 64 * simulator.getThreadCount() };
+	std::vector<GameJob> jobs;
+	std::vector<GameResult> results;
+	auto start = std::chrono::steady_clock::now();
+	for (int first{ 0 }; first < settings.gamesPerCandidate; first += BATCH_GAMES) {
+		jobs.clear();
+		for (int game{ first }; game < first + BATCH_GAMES && game < settings.gamesPerCandidate; game++) {
+			GameJob job;
+			job.weights = weights;
+			job.seed = settings.seed + game;
+			jobs.push_back(job);
+		}
+		simulator.run(jobs, results);
+		double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+		std::cout << first + jobs.size() << " games, " << dataset.getSampleCount() << " positions ("
+			<< dataset.getSampleCount() / seconds << " positions/s)\n";
+	}
+	if (!dataset.close()) {
+		std::cerr << "error writing " << path << "\n";
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	TunerSettings settings;
+	std::string exportPath;
+	for (int i{ 1 }; i < argc; i++) {
+		if (std::strcmp(argv[i], "--help") == 0) {
+			printUsage();
+			return 0;
+		}
+		if (i + 1 >= argc) {
+			printUsage();
+			return 1;
+		}
+		const char* value{ argv[++i] };
+		if (std::strcmp(argv[i - 1], "--population") == 0) {
+			settings.populationSize = std::atoi(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--survivors") == 0) {
+			settings.survivors = std::atoi(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--games") == 0) {
+			settings.gamesPerCandidate = std::atoi(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--pieces") == 0) {
+			settings.maxPieces = std::atoi(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--generations") == 0) {
+			settings.generations = std::atoi(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--threads") == 0) {
+			settings.threads = std::atoi(value);
+		}
+		else if (std::strcmp(argv[i - 1], "--seed") == 0) {
+			settings.seed = std::strtoull(value, nullptr, 10);
+		}
+		else if (std::strcmp(argv[i - 1], "--checkpoint") == 0) {
+			settings.checkpointPath = value;
+		}
+		else if (std::strcmp(argv[i - 1], "--export") == 0) {
+			exportPath = value;
+		}
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+	if (settings.populationSize < 2 || settings.gamesPerCandidate < 1 || settings.survivors < 1) {
+		printUsage();
+		return 1;
+	}
+
+	WeightTuner tuner(settings);
+	if (!exportPath.empty()) {
+		EvaluatorWeights weights;
+		if (tuner.loadCheckpoint(settings.checkpointPath) && tuner.getGeneration() > 0) {
+			weights = tuner.getBest().weights;
+		}
+		std::cout << "exporting with ";
+		printWeights(weights);
+		std::cout << "\n";
+		return exportDataset(settings, weights, exportPath);
+	}
+	if (tuner.initialize()) {
+		std::cout << "resuming " << settings.checkpointPath << " at generation " << tuner.getGeneration() << "\n";
+	}
+
+	while (!tuner.isFinished()) {
+		auto start = std::chrono::steady_clock::now();
+		bool saved{ tuner.runGeneration() };
+		double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+
+		int games{ settings.populationSize * settings.gamesPerCandidate };
+		std::cout << "generation " << tuner.getGeneration() << ": best " << tuner.getBest().fitness
+			<< " rows, mean " << tuner.getMeanFitness()
+			<< " (" << games << " games in " << seconds << "s, " << games / seconds << " games/s)\n  best ";
+		printWeights(tuner.getBest().weights);
+		std::cout << "\n";
+		// (going on would leave nothing to resume from if the run is stopped)
+		if (!saved) {
+			std::cerr << "can't write the checkpoint " << settings.checkpointPath << ", stopping at generation "
+				<< tuner.getGeneration() << "\n";
+			return 1;
+		}
+	}
+	return 0;
+}
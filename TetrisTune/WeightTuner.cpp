@@ -0,0 +1,230 @@
+#include "WeightTuner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// the first line of every checkpoint file
+static const char* const CHECKPOINT_HEADER = "tetris-tune-checkpoint 1";
+
+// constructor
+WeightTuner::WeightTuner(const TunerSettings& settings)
+	: settings{ settings }, simulator{ settings.threads, settings.maxPieces } {
+}
+
+// resume from the checkpoint if there is one,
+// otherwise start from a random population.
+//   return true if the run was resumed.
+bool WeightTuner::initialize() {
+	if (loadCheckpoint(settings.checkpointPath)) {
+		return true;
+	}
+	Rng rng(settings.seed);
+	population.assign(settings.populationSize, Candidate());
+	for (Candidate& candidate : population) {
+		candidate.weights = randomWeights(rng);
+	}
+	generation = 0;
+	best = Candidate();
+	return false;
+}
+
+// play a generation, keep the best candidate, breed the next
+// generation and checkpoint it
+//   return false if the checkpoint couldn't be written.
+bool WeightTuner::runGeneration() {
+	evaluatePopulation();
+	meanFitness = 0.0;
+	for (const Candidate& candidate : population) {
+		meanFitness += candidate.fitness / population.size();
+	}
+	std::sort(population.begin(), population.end(),
+		[](const Candidate& a, const Candidate& b) { return a.fitness > b.fitness; });
+	if (generation == 0 || population.front().fitness > best.fitness) {
+		best = population.front();
+	}
+	breed();
+	generation++;
+	return saveCheckpoint(settings.checkpointPath);
+}
+
+// write the population to path (via a temporary file, so a run that
+// is killed half way through saving keeps the previous checkpoint)
+//   return false if the file can't be written.
+bool WeightTuner::saveCheckpoint(const std::string& path) const {
+	std::string temporaryPath{ path + ".tmp" };
+	{
+		std::ofstream file(temporaryPath);
+		if (!file) {
+			return false;
+		}
+		file << std::setprecision(17);
+		file << CHECKPOINT_HEADER << '\n';
+		file << "generation " << generation << '\n';
+		file << "best " << best.fitness << ' ' << best.weights.aggregateHeight << ' ' << best.weights.rowsCleared
+			<< ' ' << best.weights.holes << ' ' << best.weights.bumpiness << '\n';
+		for (const Candidate& candidate : population) {
+			file << "candidate " << candidate.weights.aggregateHeight << ' ' << candidate.weights.rowsCleared
+				<< ' ' << candidate.weights.holes << ' ' << candidate.weights.bumpiness << '\n';
+		}
+		if (!file) {
+			return false;
+		}
+	}
+	// replace the checkpoint in one step, so there is always one to resume from
+#ifdef _WIN32
+	// (rename() won't replace an existing file on Windows)
+	return MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+}
+
+// read the population from path
+//   return false if there is no (valid) checkpoint at path.
+bool WeightTuner::loadCheckpoint(const std::string& path) {
+	std::ifstream file(path);
+	std::string line;
+	if (!std::getline(file, line) || line != CHECKPOINT_HEADER) {
+		return false;
+	}
+	std::string label;
+	int savedGeneration{ 0 };
+	Candidate savedBest;
+	if (!(file >> label >> savedGeneration) || label != "generation") {
+		return false;
+	}
+	if (!(file >> label >> savedBest.fitness >> savedBest.weights.aggregateHeight >> savedBest.weights.rowsCleared
+		>> savedBest.weights.holes >> savedBest.weights.bumpiness) || label != "best") {
+		return false;
+	}
+	std::vector<Candidate> savedPopulation;
+	Candidate candidate;
+	while (file >> label >> candidate.weights.aggregateHeight >> candidate.weights.rowsCleared
+		>> candidate.weights.holes >> candidate.weights.bumpiness) {
+		if (label != "candidate") {
+			return false;
+		}
+		savedPopulation.push_back(candidate);
+	}
+	if (savedPopulation.empty()) {
+		return false;
+	}
+	population = savedPopulation;
+	generation = savedGeneration;
+	best = savedBest;
+	return true;
+}
+
+// play the games of the current generation and set every candidate's fitness
+void WeightTuner::evaluatePopulation() {
+	// the seeds change every generation (so the weights don't overfit a few
+	// games), but within a generation every candidate plays the same games
+	Rng seeds(settings.seed * 0x9E3779B97F4A7C15ULL + static_cast<unsigned long long>(generation));
+	std::vector<unsigned long long> gameSeeds(settings.gamesPerCandidate);
+	for (unsigned long long& seed : gameSeeds) {
+		seed = seeds.next();
+	}
+
+	std::vector<GameJob> jobs;
+	jobs.reserve(population.size() * gameSeeds.size());
+	for (const Candidate& candidate : population) {
+		for (unsigned long long seed : gameSeeds) {
+			GameJob job;
+			job.weights = candidate.weights;
+			job.seed = seed;
+			jobs.push_back(job);
+		}
+	}
+	std::vector<GameResult> results;
+	simulator.run(jobs, results);
+
+	for (int i{ 0 }; i < static_cast<int>(population.size()); i++) {
+		int rows{ 0 };
+		for (int game{ 0 }; game < settings.gamesPerCandidate; game++) {
+			rows += results[i * settings.gamesPerCandidate + game].rowsCleared;
+		}
+		population[i].fitness = static_cast<double>(rows) / settings.gamesPerCandidate;
+	}
+}
+
+// replace the population with the survivors and their children
+void WeightTuner::breed() {
+	// seeded by generation, so a resumed run breeds exactly as it would have
+	Rng rng(settings.seed ^ (0xD1B54A32D192ED03ULL * static_cast<unsigned long long>(generation + 1)));
+	int survivors{ std::min(settings.survivors, static_cast<int>(population.size())) };
+	std::vector<Candidate> next(population.begin(), population.begin() + survivors);
+	while (static_cast<int>(next.size()) < settings.populationSize) {
+		const Candidate& a{ selectParent(rng) };
+		const Candidate& b{ selectParent(rng) };
+		// the fitter parent passes on more of its weights
+		double total{ a.fitness + b.fitness };
+		double shareA{ total > 0.0 ? a.fitness / total : 0.5 };
+		Candidate child;
+		child.weights.aggregateHeight = shareA * a.weights.aggregateHeight + (1.0 - shareA) * b.weights.aggregateHeight;
+		child.weights.rowsCleared = shareA * a.weights.rowsCleared + (1.0 - shareA) * b.weights.rowsCleared;
+		child.weights.holes = shareA * a.weights.holes + (1.0 - shareA) * b.weights.holes;
+		child.weights.bumpiness = shareA * a.weights.bumpiness + (1.0 - shareA) * b.weights.bumpiness;
+		if (rng.nextDouble() < settings.mutationRate) {
+			child.weights.aggregateHeight += settings.mutationStrength * gaussian(rng);
+			child.weights.rowsCleared += settings.mutationStrength * gaussian(rng);
+			child.weights.holes += settings.mutationStrength * gaussian(rng);
+			child.weights.bumpiness += settings.mutationStrength * gaussian(rng);
+		}
+		child.weights = normalize(child.weights);
+		next.push_back(child);
+	}
+	population = next;
+}
+
+// return the fittest of settings.tournamentSize random candidates
+const Candidate& WeightTuner::selectParent(Rng& rng) const {
+	const Candidate* winner{ &population[rng.nextInt(static_cast<int>(population.size()))] };
+	for (int i{ 1 }; i < settings.tournamentSize; i++) {
+		const Candidate& challenger{ population[rng.nextInt(static_cast<int>(population.size()))] };
+		if (challenger.fitness > winner->fitness) {
+			winner = &challenger;
+		}
+	}
+	return *winner;
+}
+
+// return a random weight vector (of unit length)
+EvaluatorWeights WeightTuner::randomWeights(Rng& rng) {
+	EvaluatorWeights weights;
+	weights.aggregateHeight = rng.nextDouble() * 2.0 - 1.0;
+	weights.rowsCleared = rng.nextDouble() * 2.0 - 1.0;
+	weights.holes = rng.nextDouble() * 2.0 - 1.0;
+	weights.bumpiness = rng.nextDouble() * 2.0 - 1.0;
+	return normalize(weights);
+}
+
+// return weights scaled to unit length
+EvaluatorWeights WeightTuner::normalize(const EvaluatorWeights& weights) {
+	double length{ std::sqrt(weights.aggregateHeight * weights.aggregateHeight + weights.rowsCleared * weights.rowsCleared
+		+ weights.holes * weights.holes + weights.bumpiness * weights.bumpiness) };
+	if (length == 0.0) {
+		return EvaluatorWeights();
+	}
+	EvaluatorWeights result;
+	result.aggregateHeight = weights.aggregateHeight / length;
+	result.rowsCleared = weights.rowsCleared / length;
+	result.holes = weights.holes / length;
+	result.bumpiness = weights.bumpiness / length;
+	return result;
+}
+
+// return a normally distributed random number (mean 0, deviation 1)
+double WeightTuner::gaussian(Rng& rng) {
+	// Box-Muller transform (1 - nextDouble() keeps log() away from 0)
+	const double PI{ 3.14159265358979323846 };
+	double u{ 1.0 - rng.nextDouble() };
+	double v{ rng.nextDouble() };
+	return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * PI * v);
+}
@@ -0,0 +1,108 @@
+// The WeightTuner class searches for good Evaluator weights using a genetic algorithm.
+//
+// Every generation, each candidate in the population plays the same set of
+// seeded games (so candidates are compared on equal footing), and its fitness
+// is the average number of rows it cleared. The fittest candidates survive into
+// the next generation, and the rest of the population is replaced by children of
+// tournament selected parents (fitness weighted crossover + gaussian mutation).
+// The games of a generation are spread across all cores by a BatchSimulator.
+//
+// The evaluator only compares boards, so the length of a weight vector doesn't
+// matter: weights are kept normalized to unit length.
+//
+// The population is checkpointed to a text file after every generation, so a
+// long run can be stopped at any time and resumed where it left off.
+
+#ifndef WEIGHTTUNER_H
+#define WEIGHTTUNER_H
+
+#include <string>
+#include <vector>
+#include "BatchSimulator.h"
+#include "Evaluator.h"
+#include "Rng.h"
+
+// tuning settings
+struct TunerSettings
+{
+	int populationSize = 64;
+	int survivors = 16;					// the fittest candidates kept as they are
+	int tournamentSize = 4;				// candidates competing to become a parent
+	double mutationRate = 0.3;			// chance of a child being mutated
+	double mutationStrength = 0.2;		// standard deviation of a mutation
+	int gamesPerCandidate = 32;			// games each candidate plays per generation
+	int maxPieces = 500;				// games are stopped after this many pieces
+	int generations = 100;				// stop after this many generations
+	int threads = 0;					// 0 means one per core
+	unsigned long long seed = 1;		// seeds the games and the breeding
+	std::string checkpointPath = "tetris-tune.checkpoint";
+};
+
+// a set of weights and how well it played
+struct Candidate
+{
+	EvaluatorWeights weights;
+	double fitness = 0.0;	// average rows cleared per game
+};
+
+class WeightTuner
+{
+public:
+	// constructor
+	explicit WeightTuner(const TunerSettings& settings);
+
+	// resume from the checkpoint if there is one,
+	// otherwise start from a random population.
+	//   return true if the run was resumed.
+	bool initialize();
+
+	// play a generation, keep the best candidate, breed the next
+	// generation and checkpoint it
+	//   return false if the checkpoint couldn't be written.
+	bool runGeneration();
+
+	// return true once every generation has been run
+	bool isFinished() const { return generation >= settings.generations; }
+
+	int getGeneration() const { return generation; }
+	const Candidate& getBest() const { return best; }
+	double getMeanFitness() const { return meanFitness; }
+
+	// write the population to path (via a temporary file, so a run that
+	// is killed half way through saving keeps the previous checkpoint)
+	//   return false if the file can't be written.
+	bool saveCheckpoint(const std::string& path) const;
+
+	// read the population from path
+	//   return false if there is no (valid) checkpoint at path.
+	bool loadCheckpoint(const std::string& path);
+
+private:
+	// play the games of the current generation and set every candidate's fitness
+	void evaluatePopulation();
+
+	// replace the population with the survivors and their children
+	void breed();
+
+	// return the fittest of settings.tournamentSize random candidates
+	const Candidate& selectParent(Rng& rng) const;
+
+	// return a random weight vector (of unit length)
+	static EvaluatorWeights randomWeights(Rng& rng);
+
+	// return weights scaled to unit length
+	static EvaluatorWeights normalize(const EvaluatorWeights& weights);
+
+	// return a normally distributed random number (mean 0, deviation 1)
+	static double gaussian(Rng& rng);
+
+	// MEMBER VARIABLES
+	TunerSettings settings;
+	BatchSimulator simulator;
+	std::vector<Candidate> population;
+	int generation = 0;		// the generation about to be played
+	Candidate best;			// the best candidate of any generation so far
+	double meanFitness = 0.0;	// the average fitness of the last generation played
+};
+
+#endif /* WEIGHTTUNER_H */